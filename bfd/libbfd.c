@@ -22,6 +22,7 @@
 #include "sysdep.h"
 #include "bfd.h"
 #include "libbfd.h"
+#include "leb128.h"
 
 #ifndef HAVE_GETPAGESIZE
 #define getpagesize() 2048
@@ -1066,6 +1067,12 @@ _bfd_read_unsigned_leb128 (bfd *abfd ATTRIBUTE_UNUSED,
   unsigned int shift;
   unsigned char byte;
 
+  if (leb128_single_byte_p (*buf))
+    {
+      *bytes_read_ptr = 1;
+      return *buf;
+    }
+
   result = 0;
   shift = 0;
   num_read = 0;
@@ -1099,6 +1106,16 @@ _bfd_safe_read_leb128 (bfd *abfd ATTRIBUTE_UNUSED,
   unsigned int shift = 0;
   unsigned char byte = 0;
 
+  if (data < end && leb128_single_byte_p (*data))
+    {
+      byte = *data;
+      if (length_return != NULL)
+	*length_return = 1;
+      if (sign)
+	return (bfd_vma) sleb128_single_byte_value (byte);
+      return byte;
+    }
+
   while (data < end)
     {
       byte = bfd_get_8 (abfd, data);
@@ -27,6 +27,7 @@
 #include "elf/common.h"
 #include "dwarf2.h"
 #include "dwarf.h"
+#include "leb128.h"
 #include "gdb/gdb-index.h"
 #include "filenames.h"
 #include "safe-ctype.h"
@@ -342,6 +343,19 @@ read_leb128 (unsigned char *data,
   unsigned int shift = 0;
   int status = 1;
 
+  if (data < end && leb128_single_byte_p (*data))
+    {
+      if (sign)
+	result = sleb128_single_byte_value (*data);
+      else
+	result = *data;
+      if (length_return != NULL)
+	*length_return = 1;
+      if (status_return != NULL)
+	*status_return = 0;
+      return result;
+    }
+
   while (data < end)
     {
       unsigned char byte = *data++;
@@ -21,6 +21,11 @@
 #include "splay-tree.h"
 #include "gdb_obstack.h"
 #include "addrmap.h"
+#include "gdbsupport/selftest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 /* Make sure splay trees can actually hold the values we want to
    store in them.  */
@@ -101,19 +106,47 @@ struct addrmap_transition
 };
 
 
+/* The size of the blocks of addresses a lookup in a fixed map reads at
+   each step; a typical cache line.  */
+#define ADDRMAP_FIXED_ALIGNMENT 64
+
+/* The number of addresses in a block.  */
+#define ADDRMAP_FIXED_BLOCK (ADDRMAP_FIXED_ALIGNMENT / sizeof (CORE_ADDR))
+
+/* A level of the search tree of a fixed map, see struct
+   addrmap_fixed.  */
+struct addrmap_fixed_level
+{
+  /* The addresses, sorted, and aligned on a block boundary.  */
+  CORE_ADDR *addrs;
+
+  /* The number of addresses in ADDRS.  */
+  size_t size;
+};
+
 struct addrmap_fixed
 {
   struct addrmap addrmap;
 
-  /* The number of transitions in TRANSITIONS.  */
+  /* The number of transitions in the map.  */
   size_t num_transitions;
 
-  /* An array of transitions, sorted by address.  For every point in
+  /* The transitions of the map, sorted by address.  For every point in
      the map where either ADDR == 0 or ADDR is mapped to one value and
      ADDR - 1 is mapped to something different, we have an entry here
      containing ADDR and VALUE.  (Note that this means we always have
-     an entry for address 0).  */
-  struct addrmap_transition transitions[1];
+     an entry for address 0).
+
+     The addresses and the values are in separate arrays, so that a
+     lookup only reads addresses until it has found its transition.
+     LEVELS[0].ADDRS holds the addresses of the transitions, and
+     VALUES their values.  Each level above holds the first address of
+     each block of the level below, up to a top level that fits in a
+     single block: together, they make a B-tree whose nodes are cache
+     lines.  */
+  struct addrmap_fixed_level *levels;
+  int num_levels;
+  void **values;
 };
 
 
@@ -132,32 +165,31 @@ static void *
 addrmap_fixed_find (struct addrmap *self, CORE_ADDR addr)
 {
   struct addrmap_fixed *map = (struct addrmap_fixed *) self;
-  struct addrmap_transition *bottom = &map->transitions[0];
-  struct addrmap_transition *top = &map->transitions[map->num_transitions - 1];
 
-  while (bottom < top)
+  /* The index of the block to search in the current level.  Going down
+     a level, it becomes the index of the last address at or below ADDR
+     in that block.  The first address of the block is always at or
+     below ADDR: the top level starts with the transition at zero, and
+     in the levels below, this is what led to the block.  */
+  size_t block = 0;
+
+  for (int l = map->num_levels - 1; l >= 0; --l)
     {
-      /* This needs to round towards top, or else when top = bottom +
-         1 (i.e., two entries are under consideration), then mid ==
-         bottom, and then we may not narrow the range when (mid->addr
-         < addr).  */
-      struct addrmap_transition *mid = top - (top - bottom) / 2;
-
-      if (mid->addr == addr)
-        {
-          bottom = mid;
-          break;
-        }
-      else if (mid->addr < addr)
-        /* We don't eliminate mid itself here, since each transition
-           covers all subsequent addresses until the next.  This is why
-           we must round up in computing the midpoint.  */
-        bottom = mid;
-      else
-        top = mid - 1;
+      const struct addrmap_fixed_level &level = map->levels[l];
+      const CORE_ADDR *addrs = &level.addrs[block * ADDRMAP_FIXED_BLOCK];
+      size_t count = std::min (level.size - block * ADDRMAP_FIXED_BLOCK,
+			       ADDRMAP_FIXED_BLOCK);
+      size_t i = 0;
+
+      /* Count rather than branch: the addresses are sorted, so this
+	 finds the last one at or below ADDR.  */
+      for (size_t j = 1; j < count; ++j)
+	i += addrs[j] <= addr;
+
+      block = block * ADDRMAP_FIXED_BLOCK + i;
     }
 
-  return bottom->value;
+  return map->values[block];
 }
 
 
@@ -174,10 +206,10 @@ static void
 addrmap_fixed_relocate (struct addrmap *self, CORE_ADDR offset)
 {
   struct addrmap_fixed *map = (struct addrmap_fixed *) self;
-  size_t i;
 
-  for (i = 0; i < map->num_transitions; i++)
-    map->transitions[i].addr += offset;
+  for (int l = 0; l < map->num_levels; l++)
+    for (size_t i = 0; i < map->levels[l].size; i++)
+      map->levels[l].addrs[i] += offset;
 }
 
 
@@ -190,7 +222,7 @@ addrmap_fixed_foreach (struct addrmap *self, addrmap_foreach_fn fn,
 
   for (i = 0; i < map->num_transitions; i++)
     {
-      int res = fn (data, map->transitions[i].addr, map->transitions[i].value);
+      int res = fn (data, map->levels[0].addrs[i], map->values[i]);
 
       if (res != 0)
 	return res;
@@ -210,6 +242,115 @@ static const struct addrmap_funcs addrmap_fixed_funcs =
 };
 
 
+/* Allocate COUNT addresses in OBSTACK, aligned on a block
+   boundary.  */
+
+static CORE_ADDR *
+addrmap_fixed_alloc_addrs (struct obstack *obstack, size_t count)
+{
+  size_t alloc_len = count * sizeof (CORE_ADDR) + ADDRMAP_FIXED_ALIGNMENT - 1;
+  uintptr_t base = (uintptr_t) obstack_alloc (obstack, alloc_len);
+
+  base = ((base + ADDRMAP_FIXED_ALIGNMENT - 1)
+	  & ~(uintptr_t) (ADDRMAP_FIXED_ALIGNMENT - 1));
+  return (CORE_ADDR *) base;
+}
+
+/* Create a fixed address map holding the transitions SORTED, which are
+   sorted by address and start at address 0.  Allocate it in
+   OBSTACK.  */
+
+static struct addrmap *
+addrmap_fixed_create (const std::vector<addrmap_transition> &sorted,
+		      struct obstack *obstack)
+{
+  size_t n = sorted.size ();
+
+  gdb_assert (n > 0 && sorted[0].addr == 0);
+
+  struct addrmap_fixed *fixed = XOBNEW (obstack, struct addrmap_fixed);
+  fixed->addrmap.funcs = &addrmap_fixed_funcs;
+  fixed->num_transitions = n;
+  fixed->values = XOBNEWVEC (obstack, void *, n);
+
+  /* Count the levels.  */
+  fixed->num_levels = 1;
+  for (size_t size = n; size > ADDRMAP_FIXED_BLOCK;
+       size = (size + ADDRMAP_FIXED_BLOCK - 1) / ADDRMAP_FIXED_BLOCK)
+    fixed->num_levels++;
+  fixed->levels = XOBNEWVEC (obstack, struct addrmap_fixed_level,
+			     fixed->num_levels);
+
+  fixed->levels[0].size = n;
+  fixed->levels[0].addrs = addrmap_fixed_alloc_addrs (obstack, n);
+  for (size_t i = 0; i < n; i++)
+    {
+      fixed->levels[0].addrs[i] = sorted[i].addr;
+      fixed->values[i] = sorted[i].value;
+    }
+
+  for (int l = 1; l < fixed->num_levels; l++)
+    {
+      const struct addrmap_fixed_level &below = fixed->levels[l - 1];
+      struct addrmap_fixed_level &level = fixed->levels[l];
+
+      level.size = ((below.size + ADDRMAP_FIXED_BLOCK - 1)
+		    / ADDRMAP_FIXED_BLOCK);
+      level.addrs = addrmap_fixed_alloc_addrs (obstack, level.size);
+      for (size_t i = 0; i < level.size; i++)
+	level.addrs[i] = below.addrs[i * ADDRMAP_FIXED_BLOCK];
+    }
+
+  return (struct addrmap *) fixed;
+}
+
+
+/* See addrmap.h.  */
+
+struct addrmap *
+addrmap_create_fixed (gdb::array_view<const addrmap_range> ranges,
+		      struct obstack *obstack)
+{
+  std::vector<addrmap_transition> sorted;
+  sorted.push_back ({ 0, NULL });
+
+  /* Add a transition to VALUE at ADDR, which is at or above the last
+     transition, merging it with the ones that map to the same
+     value.  */
+  auto add_transition = [&] (CORE_ADDR addr, void *value)
+    {
+      if (sorted.back ().addr == addr)
+	sorted.pop_back ();
+      if (sorted.empty () || sorted.back ().value != value)
+	sorted.push_back ({ addr, value });
+    };
+
+  /* The lowest address the next range may start at, unless the last
+     range ended at the top of the address space.  */
+  CORE_ADDR next_start = 0;
+  bool full = false;
+
+  for (const addrmap_range &range : ranges)
+    {
+      gdb_assert (range.obj != NULL);
+      gdb_assert (range.start <= range.end_inclusive);
+      gdb_assert (!full && range.start >= next_start);
+
+      add_transition (range.start, range.obj);
+      if (range.end_inclusive == CORE_ADDR_MAX)
+	full = true;
+      else
+	{
+	  next_start = range.end_inclusive + 1;
+	  add_transition (next_start, NULL);
+	}
+    }
+
+  return addrmap_fixed_create (sorted, obstack);
+}
+
+
+
 
 /* Mutable address maps.  */
 
@@ -398,30 +539,15 @@ addrmap_mutable_find (struct addrmap *self, CORE_ADDR addr)
 }
 
 
-/* A function to pass to splay_tree_foreach to count the number of nodes
-   in the tree.  */
-static int
-splay_foreach_count (splay_tree_node n, void *closure)
-{
-  size_t *count = (size_t *) closure;
-
-  (*count)++;
-  return 0;
-}
-
-
 /* A function to pass to splay_tree_foreach to copy entries into a
-   fixed address map.  */
+   vector of transitions.  */
 static int
 splay_foreach_copy (splay_tree_node n, void *closure)
 {
-  struct addrmap_fixed *fixed = (struct addrmap_fixed *) closure;
-  struct addrmap_transition *t = &fixed->transitions[fixed->num_transitions];
-
-  t->addr = addrmap_node_key (n);
-  t->value = addrmap_node_value (n);
-  fixed->num_transitions++;
+  std::vector<addrmap_transition> *transitions
+    = (std::vector<addrmap_transition> *) closure;
 
+  transitions->push_back ({ addrmap_node_key (n), addrmap_node_value (n) });
   return 0;
 }
 
@@ -430,34 +556,17 @@ static struct addrmap *
 addrmap_mutable_create_fixed (struct addrmap *self, struct obstack *obstack)
 {
   struct addrmap_mutable *mutable_obj = (struct addrmap_mutable *) self;
-  struct addrmap_fixed *fixed;
-  size_t num_transitions;
-  size_t alloc_len;
-
-  /* Count the number of transitions in the tree.  */
-  num_transitions = 0;
-  splay_tree_foreach (mutable_obj->tree, splay_foreach_count, &num_transitions);
+  std::vector<addrmap_transition> transitions;
 
   /* Include an extra entry for the transition at zero (which fixed
      maps have, but mutable maps do not.)  */
-  num_transitions++;
+  transitions.push_back ({ 0, NULL });
 
-  alloc_len = sizeof (*fixed)
-	      + (num_transitions * sizeof (fixed->transitions[0]));
-  fixed = (struct addrmap_fixed *) obstack_alloc (obstack, alloc_len);
-  fixed->addrmap.funcs = &addrmap_fixed_funcs;
-  fixed->num_transitions = 1;
-  fixed->transitions[0].addr = 0;
-  fixed->transitions[0].value = NULL;
-
-  /* Copy all entries from the splay tree to the array, in order 
+  /* Copy all entries from the splay tree to the vector, in order
      of increasing address.  */
-  splay_tree_foreach (mutable_obj->tree, splay_foreach_copy, fixed);
+  splay_tree_foreach (mutable_obj->tree, splay_foreach_copy, &transitions);
 
-  /* We should have filled the array.  */
-  gdb_assert (fixed->num_transitions == num_transitions);
-
-  return (struct addrmap *) fixed;
+  return addrmap_fixed_create (transitions, obstack);
 }
 
 
@@ -592,3 +701,293 @@ addrmap_create_mutable (struct obstack *obstack)
 
   return (struct addrmap *) map;
 }
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* A generator of pseudo-random numbers, so that the tests below are
+   reproducible.  */
+
+struct addrmap_test_random
+{
+  uint32_t next ()
+  {
+    m_state = m_state * 1103515245 + 12345;
+    return m_state >> 8;
+  }
+
+private:
+  uint32_t m_state = 1;
+};
+
+/* Return COUNT sorted, non-overlapping ranges with random gaps and
+   sizes, mapped to the elements of OBJS.  Some ranges are adjacent,
+   and some adjacent ranges map to the same object.  */
+
+static std::vector<addrmap_range>
+make_test_ranges (size_t count, std::vector<int> &objs)
+{
+  addrmap_test_random random;
+  std::vector<addrmap_range> ranges;
+  CORE_ADDR addr = 0x1000;
+
+  objs.resize (count);
+  for (size_t i = 0; i < count; ++i)
+    {
+      uint32_t r = random.next ();
+      addr += r % 4 == 0 ? 0 : r % 64;
+      CORE_ADDR size = 1 + (r >> 6) % 256;
+      void *obj = (r % 7 == 0 && i > 0 ? ranges.back ().obj : &objs[i]);
+
+      ranges.push_back ({ addr, addr + size - 1, obj });
+      addr += size;
+    }
+
+  return ranges;
+}
+
+/* Return the object RANGES map ADDR to, by a binary search.  */
+
+static void *
+find_in_test_ranges (const std::vector<addrmap_range> &ranges,
+		     CORE_ADDR addr)
+{
+  auto it = std::upper_bound (ranges.begin (), ranges.end (), addr,
+			      [] (CORE_ADDR a, const addrmap_range &r)
+			      {
+				return a < r.start;
+			      });
+
+  if (it == ranges.begin ())
+    return NULL;
+  --it;
+  return addr <= it->end_inclusive ? it->obj : NULL;
+}
+
+/* An addrmap_foreach_fn collecting the transitions of a map.  */
+
+static int
+collect_transitions (void *data, CORE_ADDR start_addr, void *obj)
+{
+  std::vector<addrmap_transition> *transitions
+    = (std::vector<addrmap_transition> *) data;
+
+  transitions->push_back ({ start_addr, obj });
+  return 0;
+}
+
+static void
+test_addrmap_fixed ()
+{
+  auto_obstack obstack;
+  std::vector<int> objs;
+  std::vector<addrmap_range> ranges = make_test_ranges (1000, objs);
+
+  /* Build the same map from the ranges, and through a mutable map.  */
+  struct addrmap *fixed = addrmap_create_fixed (ranges, &obstack);
+  struct addrmap *mutable_map = addrmap_create_mutable (&obstack);
+  for (const addrmap_range &range : ranges)
+    addrmap_set_empty (mutable_map, range.start, range.end_inclusive,
+		       range.obj);
+  struct addrmap *from_mutable = addrmap_create_fixed (mutable_map, &obstack);
+
+  CORE_ADDR last = ranges.back ().end_inclusive;
+  for (CORE_ADDR addr = 0; addr <= last + 2; ++addr)
+    {
+      void *expected = find_in_test_ranges (ranges, addr);
+
+      SELF_CHECK (addrmap_find (fixed, addr) == expected);
+      SELF_CHECK (addrmap_find (from_mutable, addr) == expected);
+    }
+  SELF_CHECK (addrmap_find (fixed, CORE_ADDR_MAX) == NULL);
+
+  /* Both maps have the same transitions, in order.  */
+  std::vector<addrmap_transition> transitions, transitions_from_mutable;
+  addrmap_foreach (fixed, collect_transitions, &transitions);
+  addrmap_foreach (from_mutable, collect_transitions,
+		   &transitions_from_mutable);
+  SELF_CHECK (transitions.size () == transitions_from_mutable.size ());
+  for (size_t i = 0; i < transitions.size (); ++i)
+    {
+      SELF_CHECK (transitions[i].addr
+		  == transitions_from_mutable[i].addr);
+      SELF_CHECK (transitions[i].value
+		  == transitions_from_mutable[i].value);
+      SELF_CHECK (i == 0 || transitions[i].addr > transitions[i - 1].addr);
+      SELF_CHECK (i == 0
+		  || transitions[i].value != transitions[i - 1].value);
+    }
+
+  addrmap_relocate (fixed, 0x100);
+  SELF_CHECK (addrmap_find (fixed, ranges[0].start + 0x100)
+	      == ranges[0].obj);
+  SELF_CHECK (addrmap_find (fixed, ranges[0].start + 0xff) == NULL);
+
+  /* Ranges up to the top of the address space.  */
+  int top_obj;
+  std::vector<addrmap_range> top_ranges
+    = { { 0, 9, &objs[0] }, { CORE_ADDR_MAX - 9, CORE_ADDR_MAX, &top_obj } };
+  struct addrmap *top = addrmap_create_fixed (top_ranges, &obstack);
+  SELF_CHECK (addrmap_find (top, 0) == &objs[0]);
+  SELF_CHECK (addrmap_find (top, 10) == NULL);
+  SELF_CHECK (addrmap_find (top, CORE_ADDR_MAX) == &top_obj);
+
+  /* An empty map.  */
+  struct addrmap *empty
+    = addrmap_create_fixed (gdb::array_view<const addrmap_range> (),
+			    &obstack);
+  SELF_CHECK (addrmap_find (empty, 0) == NULL);
+  SELF_CHECK (addrmap_find (empty, CORE_ADDR_MAX) == NULL);
+}
+
+/* Check lookups in a map of a million ranges, such as a large program
+   may have.  */
+
+static void
+test_addrmap_fixed_large ()
+{
+  auto_obstack obstack;
+  std::vector<int> objs;
+  std::vector<addrmap_range> ranges = make_test_ranges (1000000, objs);
+  struct addrmap *fixed = addrmap_create_fixed (ranges, &obstack);
+
+  for (const addrmap_range &range : ranges)
+    {
+      SELF_CHECK (addrmap_find (fixed, range.start) == range.obj);
+      SELF_CHECK (addrmap_find (fixed, range.end_inclusive) == range.obj);
+      SELF_CHECK (addrmap_find (fixed, range.end_inclusive + 1)
+		  == find_in_test_ranges (ranges, range.end_inclusive + 1));
+    }
+}
+
+/* Return the object TRANSITIONS, the transitions of a map, map ADDR
+   to, by a binary search, as fixed maps used to do.  */
+
+static void *
+find_in_transitions (const std::vector<addrmap_transition> &transitions,
+		     CORE_ADDR addr)
+{
+  auto it = std::upper_bound (transitions.begin (), transitions.end (), addr,
+			      [] (CORE_ADDR a, const addrmap_transition &t)
+			      {
+				return a < t.addr;
+			      });
+
+  gdb_assert (it != transitions.begin ());
+  return (it - 1)->value;
+}
+
+/* Time building a fixed map of a million ranges, through a mutable map
+   and straight from the sorted ranges.  Then time looking addresses up
+   in it, by a binary search over its transitions as fixed maps used to
+   do, and by addrmap_find.  The addresses looked up are either a
+   thousand hot addresses, as when unwinding the same stacks again and
+   again, or spread uniformly over the map.  Print the timings, and
+   check that both lookups agree.  */
+
+static void
+test_addrmap_fixed_benchmark ()
+{
+  using namespace std::chrono;
+  const size_t n_ranges = 1000000;
+  const size_t n_lookups = 1000000;
+
+  auto_obstack obstack;
+  std::vector<int> objs;
+  std::vector<addrmap_range> ranges = make_test_ranges (n_ranges, objs);
+
+  steady_clock::time_point start = steady_clock::now ();
+  struct addrmap *mutable_map = addrmap_create_mutable (&obstack);
+  for (const addrmap_range &range : ranges)
+    addrmap_set_empty (mutable_map, range.start, range.end_inclusive,
+		       range.obj);
+  struct addrmap *from_mutable = addrmap_create_fixed (mutable_map,
+						      &obstack);
+  steady_clock::duration mutable_build_time = steady_clock::now () - start;
+
+  start = steady_clock::now ();
+  struct addrmap *fixed = addrmap_create_fixed (ranges, &obstack);
+  steady_clock::duration fixed_build_time = steady_clock::now () - start;
+
+  printf_unfiltered ("%zu ranges: built through a mutable map in %ld ms, "
+		     "from the sorted ranges in %ld ms\n", n_ranges,
+		     (long) duration_cast<milliseconds>
+		       (mutable_build_time).count (),
+		     (long) duration_cast<milliseconds>
+		       (fixed_build_time).count ());
+
+  std::vector<addrmap_transition> transitions;
+  addrmap_foreach (from_mutable, collect_transitions, &transitions);
+
+  addrmap_test_random random;
+  CORE_ADDR first = ranges.front ().start;
+  CORE_ADDR span = ranges.back ().end_inclusive + 2 - first;
+  auto random_addr = [&] ()
+    {
+      CORE_ADDR r = ((CORE_ADDR) random.next () << 24) | random.next ();
+      return first + r % span;
+    };
+
+  std::vector<CORE_ADDR> hot (1000);
+  for (CORE_ADDR &addr : hot)
+    addr = random_addr ();
+
+  for (int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<CORE_ADDR> addrs (n_lookups);
+      for (size_t i = 0; i < n_lookups; ++i)
+	addrs[i] = pass == 0 ? hot[i % hot.size ()] : random_addr ();
+
+      /* Sum the objects found, so that the lookups are not optimized
+	 away, and can be compared.  */
+      uintptr_t sums[2];
+      double ns_per_lookup[2];
+      for (int method = 0; method < 2; ++method)
+	{
+	  uintptr_t sum = 0;
+
+	  start = steady_clock::now ();
+	  for (CORE_ADDR addr : addrs)
+	    {
+	      void *obj;
+
+	      if (method == 0)
+		obj = find_in_transitions (transitions, addr);
+	      else
+		obj = addrmap_find (fixed, addr);
+	      sum += (uintptr_t) obj;
+	    }
+	  steady_clock::duration time = steady_clock::now () - start;
+
+	  sums[method] = sum;
+	  ns_per_lookup[method]
+	    = (double) duration_cast<nanoseconds> (time).count () / n_lookups;
+	}
+
+      SELF_CHECK (sums[0] == sums[1]);
+
+      printf_unfiltered ("%zu lookups of %s: binary search %.0f ns, "
+			 "fixed map %.0f ns per lookup\n",
+			 n_lookups,
+			 pass == 0 ? "1000 hot addresses" : "uniform addresses",
+			 ns_per_lookup[0], ns_per_lookup[1]);
+    }
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void _initialize_addrmap ();
+void
+_initialize_addrmap ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("addrmap_fixed", selftests::test_addrmap_fixed);
+  selftests::register_test ("addrmap_fixed_large",
+			    selftests::test_addrmap_fixed_large);
+  selftests::register_test ("addrmap_fixed_benchmark",
+			    selftests::test_addrmap_fixed_benchmark);
+#endif
+}
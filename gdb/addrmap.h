@@ -20,6 +20,8 @@
 #ifndef ADDRMAP_H
 #define ADDRMAP_H
 
+#include "gdbsupport/array-view.h"
+
 /* An address map is essentially a table mapping CORE_ADDRs onto GDB
    data structures, like blocks, symtabs, partial symtabs, and so on.
    An address map uses memory proportional to the number of
@@ -28,8 +30,9 @@
 
    Address maps come in two flavors: fixed, and mutable.  Mutable
    address maps consume more memory, but can be changed and extended.
-   A fixed address map, once constructed (from a mutable address map),
-   can't be edited.  Both kinds of map are allocated in obstacks.  */
+   A fixed address map, once constructed (from a mutable address map,
+   or from a sorted list of ranges), can't be edited, but is faster to
+   search.  Both kinds of map are allocated in obstacks.  */
 
 /* The opaque type representing address maps.  */
 struct addrmap;
@@ -87,6 +90,22 @@ void *addrmap_find (struct addrmap *map, CORE_ADDR addr);
 struct addrmap *addrmap_create_fixed (struct addrmap *original,
                                       struct obstack *obstack);
 
+/* A range of addresses, for addrmap_create_fixed.  */
+struct addrmap_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end_inclusive;
+  void *obj;
+};
+
+/* Create a fixed address map which associates the addresses of each
+   of RANGES with its object, and any other address with NULL, without
+   going through a mutable address map.  RANGES must be sorted by
+   address and must not overlap, and their objects must not be NULL.
+   Allocate entries in OBSTACK.  */
+struct addrmap *addrmap_create_fixed
+  (gdb::array_view<const addrmap_range> ranges, struct obstack *obstack);
+
 /* Relocate all the addresses in MAP by OFFSET.  (This can be applied
    to either mutable or immutable maps.)  */
 void addrmap_relocate (struct addrmap *map, CORE_ADDR offset);
@@ -215,8 +215,13 @@ enum ugll_insert_mode
 
 static void update_global_location_list (enum ugll_insert_mode);
 
+static void do_update_global_location_list (enum ugll_insert_mode);
+
 static void update_global_location_list_nothrow (enum ugll_insert_mode);
 
+static void add_breakpoint_locations_to_global_list (struct breakpoint *,
+						     enum ugll_insert_mode);
+
 static void insert_breakpoint_locations (void);
 
 static void trace_pass_command (const char *, int);
@@ -232,6 +237,35 @@ static struct bp_location **get_first_locp_gte_addr (CORE_ADDR address);
 
 static int strace_marker_p (struct breakpoint *b);
 
+static int bkpt_breakpoint_hit (const struct bp_location *bl,
+				const address_space *aspace,
+				CORE_ADDR bp_addr,
+				const struct target_waitstatus *ws);
+
+static int dprintf_breakpoint_hit (const struct bp_location *bl,
+				   const address_space *aspace,
+				   CORE_ADDR bp_addr,
+				   const struct target_waitstatus *ws);
+
+static int tracepoint_breakpoint_hit (const struct bp_location *bl,
+				      const address_space *aspace,
+				      CORE_ADDR bp_addr,
+				      const struct target_waitstatus *ws);
+
+static void bkpt_re_set (struct breakpoint *b);
+
+static void dprintf_re_set (struct breakpoint *b);
+
+static void tracepoint_re_set (struct breakpoint *b);
+
+static std::vector<symtab_and_line> bkpt_decode_location
+  (struct breakpoint *b, const struct event_location *location,
+   struct program_space *search_pspace);
+
+static std::vector<symtab_and_line> tracepoint_decode_location
+  (struct breakpoint *b, const struct event_location *location,
+   struct program_space *search_pspace);
+
 /* The breakpoint_ops structure to be inherited by all breakpoint_ops
    that are implemented on top of software or hardware breakpoints
    (user breakpoints, internal and momentary breakpoints, etc.).  */
@@ -536,6 +570,18 @@ static struct bp_location **bp_locations;
 
 static unsigned bp_locations_count;
 
+/* Number of elements allocated for BP_LOCATIONS.  */
+
+static unsigned bp_locations_allocated;
+
+/* True if BP_LOCATIONS holds all the locations of the breakpoints in
+   BREAKPOINT_CHAIN, and their duplicate flags are up to date.  This is
+   false while the array is being rebuilt, or if rebuilding it failed
+   or was deferred; add_breakpoint_locations_to_global_list then
+   rebuilds it in full.  */
+
+static bool bp_locations_up_to_date = true;
+
 /* Maximum alignment offset between bp_target_info.PLACED_ADDRESS and
    ADDRESS for the current elements of BP_LOCATIONS which get a valid
    result from bp_location_has_shadow.  You can use it for roughly
@@ -629,6 +675,45 @@ scoped_rbreak_breakpoints::~scoped_rbreak_breakpoints ()
   prev_breakpoint_count = rbreak_start_breakpoint_count;
 }
 
+/* The number of live scoped_batch_location_list_update objects.  */
+
+static int location_list_batch_depth;
+
+/* True if update_global_location_list was called while
+   LOCATION_LIST_BATCH_DEPTH was nonzero.  */
+
+static bool location_list_batch_pending;
+
+/* The strongest insert mode update_global_location_list was called
+   with while LOCATION_LIST_BATCH_DEPTH was nonzero.  */
+
+static enum ugll_insert_mode location_list_batch_insert_mode;
+
+scoped_batch_location_list_update::scoped_batch_location_list_update ()
+{
+  if (location_list_batch_depth++ == 0)
+    {
+      location_list_batch_pending = false;
+      location_list_batch_insert_mode = UGLL_DONT_INSERT;
+    }
+}
+
+scoped_batch_location_list_update::~scoped_batch_location_list_update ()
+{
+  if (--location_list_batch_depth > 0 || !location_list_batch_pending)
+    return;
+
+  location_list_batch_pending = false;
+  try
+    {
+      do_update_global_location_list (location_list_batch_insert_mode);
+    }
+  catch (const gdb_exception &ex)
+    {
+      exception_print (gdb_stderr, ex);
+    }
+}
+
 /* Used in run_command to zero the hit count when a new run starts.  */
 
 void
@@ -5254,20 +5339,78 @@ need_moribund_for_location_type (struct bp_location *loc)
 	      && !target_supports_stopped_by_hw_breakpoint ()));
 }
 
+/* Statistics about the lookups done by build_bpstat_chain.  See "maint
+   print breakpoint-lookup-statistics".  */
+
+struct bpstat_lookup_stats
+{
+  /* The number of times build_bpstat_chain was called.  */
+  unsigned long stops = 0;
+
+  /* The number of breakpoints whose locations were checked.  */
+  unsigned long breakpoints_checked = 0;
+
+  /* The number of locations checked with the breakpoint_hit method.  */
+  unsigned long locations_checked = 0;
+
+  /* The number of locations checked on the last stop.  */
+  unsigned int last_locations_checked = 0;
+};
+
+static struct bpstat_lookup_stats bpstat_lookup_statistics;
+
+/* Return true if the locations of B can only explain a stop at their
+   own address.  This is the case for all the breakpoints implemented
+   on top of software or hardware breakpoints, but not for e.g.
+   watchpoints, catchpoints or ranged breakpoints.  */
+
+static bool
+breakpoint_hit_only_at_address (const struct breakpoint *b)
+{
+  return (b->ops->breakpoint_hit == bkpt_breakpoint_hit
+	  || b->ops->breakpoint_hit == dprintf_breakpoint_hit
+	  || b->ops->breakpoint_hit == tracepoint_breakpoint_hit);
+}
+
+/* The breakpoints for which breakpoint_hit_only_at_address is false,
+   in breakpoint chain order.  build_bpstat_chain checks them on every
+   stop.  */
+
+static std::vector<breakpoint *> breakpoints_hit_anywhere;
+
 /* See breakpoint.h.  */
 
 bpstat
 build_bpstat_chain (const address_space *aspace, CORE_ADDR bp_addr,
 		    const struct target_waitstatus *ws)
 {
-  struct breakpoint *b;
+  struct bp_location **locp, **loc_start = NULL;
   bpstat bs_head = NULL, *bs_link = &bs_head;
+  unsigned int locations_checked = 0;
+
+  /* The breakpoints that may explain the stop: those for which
+     breakpoint_hit_only_at_address is false, and the others that have
+     a location at BP_ADDR, found in the address-sorted BP_LOCATIONS
+     array.  The bpstat chain is built in breakpoint chain order.  */
+  std::vector<breakpoint *> candidates = breakpoints_hit_anywhere;
+  ALL_BP_LOCATIONS_AT_ADDR (locp, loc_start, bp_addr)
+    if (breakpoint_hit_only_at_address ((*locp)->owner))
+      candidates.push_back ((*locp)->owner);
+  std::sort (candidates.begin (), candidates.end (),
+	     [] (const breakpoint *a, const breakpoint *b)
+	     {
+	       return a->chain_order < b->chain_order;
+	     });
+  candidates.erase (std::unique (candidates.begin (), candidates.end ()),
+		    candidates.end ());
 
-  ALL_BREAKPOINTS (b)
+  for (breakpoint *b : candidates)
     {
       if (!breakpoint_enabled (b))
 	continue;
 
+      bpstat_lookup_statistics.breakpoints_checked++;
+
       for (bp_location *bl = b->loc; bl != NULL; bl = bl->next)
 	{
 	  /* For hardware watchpoints, we look only at the first
@@ -5281,6 +5424,7 @@ build_bpstat_chain (const address_space *aspace, CORE_ADDR bp_addr,
 	  if (!bl->enabled || bl->shlib_disabled)
 	    continue;
 
+	  locations_checked++;
 	  if (!bpstat_check_location (bl, aspace, bp_addr, ws))
 	    continue;
 
@@ -5327,9 +5471,31 @@ build_bpstat_chain (const address_space *aspace, CORE_ADDR bp_addr,
 	}
     }
 
+  bpstat_lookup_statistics.stops++;
+  bpstat_lookup_statistics.locations_checked += locations_checked;
+  bpstat_lookup_statistics.last_locations_checked = locations_checked;
+
   return bs_head;
 }
 
+/* The "maint print breakpoint-lookup-statistics" command.  */
+
+static void
+maintenance_print_breakpoint_lookup_statistics (const char *args,
+						int from_tty)
+{
+  const struct bpstat_lookup_stats &stats = bpstat_lookup_statistics;
+
+  printf_filtered (_("Stops: %lu\n"), stats.stops);
+  printf_filtered (_("Breakpoints checked: %lu\n"), stats.breakpoints_checked);
+  printf_filtered (_("Locations checked: %lu\n"), stats.locations_checked);
+  if (stats.stops > 0)
+    printf_filtered (_("Average locations checked per stop: %.2f\n"),
+		     (double) stats.locations_checked / stats.stops);
+  printf_filtered (_("Locations checked on the last stop: %u\n"),
+		   stats.last_locations_checked);
+}
+
 /* See breakpoint.h.  */
 
 bpstat
@@ -7014,9 +7180,14 @@ decref_bp_location (struct bp_location **blp)
 static breakpoint *
 add_to_breakpoint_chain (std::unique_ptr<breakpoint> &&b)
 {
+  static unsigned long last_chain_order;
   struct breakpoint *b1;
   struct breakpoint *result = b.get ();
 
+  result->chain_order = ++last_chain_order;
+  if (!breakpoint_hit_only_at_address (result))
+    breakpoints_hit_anywhere.push_back (result);
+
   /* Add this breakpoint to the end of the chain so that a list of
      breakpoints will come out in order of increasing numbers.  */
 
@@ -8135,7 +8306,7 @@ install_breakpoint (int internal, std::unique_ptr<breakpoint> &&arg, int update_
   gdb::observers::breakpoint_created.notify (b);
 
   if (update_gll)
-    update_global_location_list (UGLL_MAY_INSERT);
+    add_breakpoint_locations_to_global_list (b, UGLL_MAY_INSERT);
 }
 
 static void
@@ -8607,6 +8778,10 @@ add_location_to_breakpoint (struct breakpoint *b,
   loc->symbol = sal->symbol;
   loc->msymbol = sal->msymbol;
   loc->objfile = sal->objfile;
+  if (loc->objfile == NULL && sal->symtab != NULL)
+    loc->objfile = SYMTAB_OBJFILE (sal->symtab);
+  if (loc->objfile == NULL && sal->section != NULL)
+    loc->objfile = sal->section->objfile;
 
   set_breakpoint_location_function (loc);
 
@@ -11511,6 +11686,33 @@ bp_location_is_less_than (const bp_location *a, const bp_location *b)
   return a < b;
 }
 
+/* Grow bp_locations_placed_address_before_address_max and
+   bp_locations_shadow_len_after_address_max to account for BL.  */
+
+static void
+bp_location_target_extensions_update (struct bp_location *bl)
+{
+  CORE_ADDR start, end, addr;
+
+  if (!bp_location_has_shadow (bl))
+    return;
+
+  start = bl->target_info.placed_address;
+  end = start + bl->target_info.shadow_len;
+
+  gdb_assert (bl->address >= start);
+  addr = bl->address - start;
+  if (addr > bp_locations_placed_address_before_address_max)
+    bp_locations_placed_address_before_address_max = addr;
+
+  /* Zero SHADOW_LEN would not pass bp_location_has_shadow.  */
+
+  gdb_assert (bl->address < end);
+  addr = end - bl->address;
+  if (addr > bp_locations_shadow_len_after_address_max)
+    bp_locations_shadow_len_after_address_max = addr;
+}
+
 /* Set bp_locations_placed_address_before_address_max and
    bp_locations_shadow_len_after_address_max according to the current
    content of the bp_locations array.  */
@@ -11524,27 +11726,7 @@ bp_locations_target_extensions_update (void)
   bp_locations_shadow_len_after_address_max = 0;
 
   ALL_BP_LOCATIONS (bl, blp_tmp)
-    {
-      CORE_ADDR start, end, addr;
-
-      if (!bp_location_has_shadow (bl))
-	continue;
-
-      start = bl->target_info.placed_address;
-      end = start + bl->target_info.shadow_len;
-
-      gdb_assert (bl->address >= start);
-      addr = bl->address - start;
-      if (addr > bp_locations_placed_address_before_address_max)
-	bp_locations_placed_address_before_address_max = addr;
-
-      /* Zero SHADOW_LEN would not pass bp_location_has_shadow.  */
-
-      gdb_assert (bl->address < end);
-      addr = end - bl->address;
-      if (addr > bp_locations_shadow_len_after_address_max)
-	bp_locations_shadow_len_after_address_max = addr;
-    }
+    bp_location_target_extensions_update (bl);
 }
 
 /* Download tracepoint locations if they haven't been.  */
@@ -11676,16 +11858,150 @@ force_breakpoint_reinsertion (struct bp_location *bl)
     }
 }
 
+/* Scan the locations in [BEGIN, END), a sorted range of the global
+   location list, marking the first location at each address and
+   section as "first" and any others as "duplicates".  This is so that
+   the bpt instruction is only inserted once.  If we have a permanent
+   breakpoint at the same place as BPT, make that one the official one,
+   and the rest as duplicates.  Permanent breakpoints are sorted first
+   for the same address.
+
+   Do the same for hardware watchpoints, but also considering the
+   watchpoint's type (regular/access/read) and length.
+
+   Locations at different addresses are never duplicates, so the range
+   may be as small as the locations at a single address.  */
+
+static void
+mark_duplicate_locations (struct bp_location **begin,
+			  struct bp_location **end)
+{
+  /* Points to the first bp_location of a given address.  Breakpoints
+     and watchpoints of different types are never duplicates of each
+     other.  Keep one pointer for each type of breakpoint/watchpoint,
+     so we only need to loop over all locations once.  */
+  struct bp_location *bp_loc_first = NULL;  /* breakpoint */
+  struct bp_location *wp_loc_first = NULL;  /* hardware watchpoint */
+  struct bp_location *awp_loc_first = NULL; /* access watchpoint */
+  struct bp_location *rwp_loc_first = NULL; /* read watchpoint */
+
+  for (struct bp_location **locp = begin; locp < end; locp++)
+    {
+      /* Locations in the global list have LOC->OWNER always
+	 non-NULL.  */
+      struct bp_location *loc = *locp;
+      struct breakpoint *b = loc->owner;
+      struct bp_location **loc_first_p;
+
+      if (!unduplicated_should_be_inserted (loc)
+	  || !bl_address_is_meaningful (loc)
+	  /* Don't detect duplicate for tracepoint locations because they are
+	   never duplicated.  See the comments in field `duplicate' of
+	   `struct bp_location'.  */
+	  || is_tracepoint (b))
+	{
+	  /* Clear the condition modification flag.  */
+	  loc->condition_changed = condition_unchanged;
+	  continue;
+	}
+
+      if (b->type == bp_hardware_watchpoint)
+	loc_first_p = &wp_loc_first;
+      else if (b->type == bp_read_watchpoint)
+	loc_first_p = &rwp_loc_first;
+      else if (b->type == bp_access_watchpoint)
+	loc_first_p = &awp_loc_first;
+      else
+	loc_first_p = &bp_loc_first;
+
+      if (*loc_first_p == NULL
+	  || (overlay_debugging && loc->section != (*loc_first_p)->section)
+	  || !breakpoint_locations_match (loc, *loc_first_p))
+	{
+	  *loc_first_p = loc;
+	  loc->duplicate = 0;
+
+	  if (is_breakpoint (loc->owner) && loc->condition_changed)
+	    {
+	      loc->needs_update = 1;
+	      /* Clear the condition modification flag.  */
+	      loc->condition_changed = condition_unchanged;
+	    }
+	  continue;
+	}
+
+
+      /* This and the above ensure the invariant that the first location
+	 is not duplicated, and is the inserted one.
+	 All following are marked as duplicated, and are not inserted.  */
+      if (loc->inserted)
+	swap_insertion (loc, *loc_first_p);
+      loc->duplicate = 1;
+
+      /* Clear the condition modification flag.  */
+      loc->condition_changed = condition_unchanged;
+    }
+}
+
+/* Insert the locations of the global location list, or download the
+   tracepoint locations, as INSERT_MODE says.  This is the last step of
+   updating the global location list.  */
+
+static void
+finish_global_location_list_update (enum ugll_insert_mode insert_mode)
+{
+  if (insert_mode == UGLL_INSERT || breakpoints_should_be_inserted_now ())
+    {
+      if (insert_mode != UGLL_DONT_INSERT)
+	insert_breakpoint_locations ();
+      else
+	{
+	  /* Even though the caller told us to not insert new
+	     locations, we may still need to update conditions on the
+	     target's side of breakpoints that were already inserted
+	     if the target is evaluating breakpoint conditions.  We
+	     only update conditions for locations that are marked
+	     "needs_update".  */
+	  update_inserted_breakpoint_locations ();
+	}
+    }
+
+  if (insert_mode != UGLL_DONT_INSERT)
+    download_tracepoint_locations ();
+}
+
 /* Called whether new breakpoints are created, or existing breakpoints
    deleted, to update the global location list and recompute which
    locations are duplicate of which.
 
    The INSERT_MODE flag determines whether locations may not, may, or
    shall be inserted now.  See 'enum ugll_insert_mode' for more
-   info.  */
+   info.
+
+   While a scoped_batch_location_list_update object exists, this only
+   records that an update is needed; the update is done when the
+   object is destroyed.  */
 
 static void
 update_global_location_list (enum ugll_insert_mode insert_mode)
+{
+  if (location_list_batch_depth > 0)
+    {
+      location_list_batch_pending = true;
+      bp_locations_up_to_date = false;
+      if (insert_mode > location_list_batch_insert_mode)
+	location_list_batch_insert_mode = insert_mode;
+      return;
+    }
+
+  do_update_global_location_list (insert_mode);
+}
+
+/* Worker for update_global_location_list, which see.  This always
+   updates the global location list right away.  */
+
+static void
+do_update_global_location_list (enum ugll_insert_mode insert_mode)
 {
   struct breakpoint *b;
   struct bp_location **locp, *loc;
@@ -11694,17 +12010,6 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   /* Last breakpoint location program space that was marked for update.  */
   int last_pspace_num = -1;
 
-  /* Used in the duplicates detection below.  When iterating over all
-     bp_locations, points to the first bp_location of a given address.
-     Breakpoints and watchpoints of different types are never
-     duplicates of each other.  Keep one pointer for each type of
-     breakpoint/watchpoint, so we only need to loop over all locations
-     once.  */
-  struct bp_location *bp_loc_first;  /* breakpoint */
-  struct bp_location *wp_loc_first;  /* hardware watchpoint */
-  struct bp_location *awp_loc_first; /* access watchpoint */
-  struct bp_location *rwp_loc_first; /* read watchpoint */
-
   /* Saved former bp_locations array which we compare against the newly
      built bp_locations from the current state of ALL_BREAKPOINTS.  */
   struct bp_location **old_locp;
@@ -11714,32 +12019,61 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   old_locations_count = bp_locations_count;
   bp_locations = NULL;
   bp_locations_count = 0;
+  bp_locations_allocated = 0;
+  bp_locations_up_to_date = false;
 
+  /* See if we need to "upgrade" a software breakpoint to a hardware
+     breakpoint.  Do this before deciding whether locations are
+     duplicates.  Also do this before sorting because sorting order
+     depends on location type.  */
   ALL_BREAKPOINTS (b)
     for (loc = b->loc; loc; loc = loc->next)
-      bp_locations_count++;
+      {
+	bp_locations_count++;
+	if (!loc->inserted && should_be_inserted (loc))
+	  handle_automatic_hardware_breakpoints (loc);
+      }
 
   bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
+  bp_locations_allocated = bp_locations_count;
+
+  /* The former array is sorted, and most of the locations usually
+     remain.  Rather than sorting all the locations again, keep the
+     remaining ones in their former order, and merge the new ones into
+     them.  Nothing below may throw until all the marks are cleared.  */
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      loc->ugll_mark = true;
+
   locp = bp_locations;
+  for (old_locp = old_locations.get ();
+       old_locp < old_locations.get () + old_locations_count;
+       old_locp++)
+    if ((*old_locp)->ugll_mark)
+      {
+	(*old_locp)->ugll_mark = false;
+	*locp++ = *old_locp;
+      }
+
+  struct bp_location **new_locp = locp;
   ALL_BREAKPOINTS (b)
     for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
+      if (loc->ugll_mark)
+	{
+	  loc->ugll_mark = false;
+	  *locp++ = loc;
+	}
+  gdb_assert (locp == bp_locations + bp_locations_count);
 
-  /* See if we need to "upgrade" a software breakpoint to a hardware
-     breakpoint.  Do this before deciding whether locations are
-     duplicates.  Also do this before sorting because sorting order
-     depends on location type.  */
-  for (locp = bp_locations;
-       locp < bp_locations + bp_locations_count;
-       locp++)
-    {
-      loc = *locp;
-      if (!loc->inserted && should_be_inserted (loc))
-	handle_automatic_hardware_breakpoints (loc);
-    }
+  std::sort (new_locp, locp, bp_location_is_less_than);
+  std::inplace_merge (bp_locations, new_locp, locp,
+		      bp_location_is_less_than);
 
-  std::sort (bp_locations, bp_locations + bp_locations_count,
-	     bp_location_is_less_than);
+  /* The sort keys of the remaining locations may have changed since
+     the former array was sorted, e.g. by the hardware breakpoint
+     upgrade above.  */
+  if (!std::is_sorted (bp_locations, locp, bp_location_is_less_than))
+    std::sort (bp_locations, locp, bp_location_is_less_than);
 
   bp_locations_target_extensions_update ();
 
@@ -11964,93 +12298,106 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
     }
 
   /* Rescan breakpoints at the same address and section, marking the
-     first one as "first" and any others as "duplicates".  This is so
-     that the bpt instruction is only inserted once.  If we have a
-     permanent breakpoint at the same place as BPT, make that one the
-     official one, and the rest as duplicates.  Permanent breakpoints
-     are sorted first for the same address.
-
-     Do the same for hardware watchpoints, but also considering the
-     watchpoint's type (regular/access/read) and length.  */
-
-  bp_loc_first = NULL;
-  wp_loc_first = NULL;
-  awp_loc_first = NULL;
-  rwp_loc_first = NULL;
-  ALL_BP_LOCATIONS (loc, locp)
+     first one as "first" and any others as "duplicates".  */
+  mark_duplicate_locations (bp_locations, bp_locations + bp_locations_count);
+  bp_locations_up_to_date = true;
+
+  finish_global_location_list_update (insert_mode);
+}
+
+/* Add the locations of breakpoint B, which was just added to the
+   breakpoint chain, to the global location list, and recompute which
+   locations are duplicates of the new ones.  INSERT_MODE is as for
+   update_global_location_list.
+
+   The new locations are merged into the sorted global list; only the
+   locations at their addresses are looked at again, so creating a
+   breakpoint does not cost time proportional to the number of
+   existing locations.  If the global list is not up to date, or if
+   locations are to be inserted now, which looks at all the locations
+   anyway, this falls back to update_global_location_list.  */
+
+static void
+add_breakpoint_locations_to_global_list (struct breakpoint *b,
+					 enum ugll_insert_mode insert_mode)
+{
+  if (location_list_batch_depth > 0
+      || !bp_locations_up_to_date
+      || insert_mode == UGLL_INSERT
+      || breakpoints_should_be_inserted_now ())
     {
-      /* ALL_BP_LOCATIONS bp_location has LOC->OWNER always
-	 non-NULL.  */
-      struct bp_location **loc_first_p;
-      b = loc->owner;
+      update_global_location_list (insert_mode);
+      return;
+    }
 
-      if (!unduplicated_should_be_inserted (loc)
-	  || !bl_address_is_meaningful (loc)
-	  /* Don't detect duplicate for tracepoint locations because they are
-	   never duplicated.  See the comments in field `duplicate' of
-	   `struct bp_location'.  */
-	  || is_tracepoint (b))
-	{
-	  /* Clear the condition modification flag.  */
-	  loc->condition_changed = condition_unchanged;
-	  continue;
-	}
+  std::vector<bp_location *> new_locs;
+  for (bp_location *loc = b->loc; loc != NULL; loc = loc->next)
+    {
+      /* See do_update_global_location_list.  */
+      if (!loc->inserted && should_be_inserted (loc))
+	handle_automatic_hardware_breakpoints (loc);
+      new_locs.push_back (loc);
+    }
 
-      if (b->type == bp_hardware_watchpoint)
-	loc_first_p = &wp_loc_first;
-      else if (b->type == bp_read_watchpoint)
-	loc_first_p = &rwp_loc_first;
-      else if (b->type == bp_access_watchpoint)
-	loc_first_p = &awp_loc_first;
-      else
-	loc_first_p = &bp_loc_first;
+  if (!new_locs.empty ())
+    {
+      unsigned count = bp_locations_count + new_locs.size ();
 
-      if (*loc_first_p == NULL
-	  || (overlay_debugging && loc->section != (*loc_first_p)->section)
-	  || !breakpoint_locations_match (loc, *loc_first_p))
+      if (count > bp_locations_allocated)
 	{
-	  *loc_first_p = loc;
-	  loc->duplicate = 0;
+	  bp_locations_allocated = std::max (count, 2 * bp_locations_allocated);
+	  bp_locations = XRESIZEVEC (struct bp_location *, bp_locations,
+				     bp_locations_allocated);
+	}
 
-	  if (is_breakpoint (loc->owner) && loc->condition_changed)
-	    {
-	      loc->needs_update = 1;
-	      /* Clear the condition modification flag.  */
-	      loc->condition_changed = condition_unchanged;
-	    }
-	  continue;
+      /* Merge the new locations in from the end, so that the existing
+	 locations are moved at most once.  */
+      std::sort (new_locs.begin (), new_locs.end (), bp_location_is_less_than);
+      struct bp_location **old_end = bp_locations + bp_locations_count;
+      struct bp_location **dest = bp_locations + count;
+      for (auto it = new_locs.rbegin (); it != new_locs.rend (); ++it)
+	{
+	  struct bp_location **pos
+	    = std::upper_bound (bp_locations, old_end, *it,
+				bp_location_is_less_than);
+	  dest = std::move_backward (pos, old_end, dest);
+	  *--dest = *it;
+	  old_end = pos;
 	}
+      bp_locations_count = count;
+    }
 
+  CORE_ADDR last_addr = 0;
+  for (auto it = new_locs.begin (); it != new_locs.end (); ++it)
+    {
+      struct bp_location *loc = *it;
 
-      /* This and the above ensure the invariant that the first location
-	 is not duplicated, and is the inserted one.
-	 All following are marked as duplicated, and are not inserted.  */
-      if (loc->inserted)
-	swap_insertion (loc, *loc_first_p);
-      loc->duplicate = 1;
+      bp_location_target_extensions_update (loc);
 
-      /* Clear the condition modification flag.  */
-      loc->condition_changed = condition_unchanged;
-    }
+      if (it != new_locs.begin () && loc->address == last_addr)
+	continue;
+      last_addr = loc->address;
+
+      struct bp_location **first = get_first_locp_gte_addr (loc->address);
+      struct bp_location **last = first;
+      while (last < bp_locations + bp_locations_count
+	     && (*last)->address == loc->address)
+	last++;
+
+      /* Target-side condition evaluation: if there are other
+	 breakpoints at this address, their conditions must be sent
+	 again along with the new ones.  */
+      if (loc->condition_changed == condition_modified
+	  && std::any_of (first, last, [b] (const bp_location *other)
+			  {
+			    return other->owner != b;
+			  }))
+	force_breakpoint_reinsertion (loc);
 
-  if (insert_mode == UGLL_INSERT || breakpoints_should_be_inserted_now ())
-    {
-      if (insert_mode != UGLL_DONT_INSERT)
-	insert_breakpoint_locations ();
-      else
-	{
-	  /* Even though the caller told us to not insert new
-	     locations, we may still need to update conditions on the
-	     target's side of breakpoints that were already inserted
-	     if the target is evaluating breakpoint conditions.  We
-	     only update conditions for locations that are marked
-	     "needs_update".  */
-	  update_inserted_breakpoint_locations ();
-	}
+      mark_duplicate_locations (first, last);
     }
 
-  if (insert_mode != UGLL_DONT_INSERT)
-    download_tracepoint_locations ();
+  finish_global_location_list_update (insert_mode);
 }
 
 void
@@ -13133,6 +13480,14 @@ delete_breakpoint (struct breakpoint *bpt)
   if (breakpoint_chain == bpt)
     breakpoint_chain = bpt->next;
 
+  if (!breakpoint_hit_only_at_address (bpt))
+    {
+      auto it = std::find (breakpoints_hit_anywhere.begin (),
+			   breakpoints_hit_anywhere.end (), bpt);
+      if (it != breakpoints_hit_anywhere.end ())
+	breakpoints_hit_anywhere.erase (it);
+    }
+
   ALL_BREAKPOINTS (b)
     if (b->next == bpt)
     {
@@ -13157,8 +13512,10 @@ delete_breakpoint (struct breakpoint *bpt)
      belong to this breakpoint.  Do this before freeing the breakpoint
      itself, since remove_breakpoint looks at location's owner.  It
      might be better design to have location completely
-     self-contained, but it's not the case now.  */
-  update_global_location_list (UGLL_DONT_INSERT);
+     self-contained, but it's not the case now.
+
+     This can't be batched, since the breakpoint is freed below.  */
+  do_update_global_location_list (UGLL_DONT_INSERT);
 
   /* On the chance that someone will soon try again to delete this
      same bp, we mark it as deleted before freeing its storage.  */
@@ -13517,6 +13874,7 @@ update_breakpoint_locations (struct breakpoint *b,
     return;
 
   existing_locations = hoist_existing_locations (b, filter_pspace);
+  b->needs_global_re_set = false;
 
   for (const auto &sal : sals)
     {
@@ -13545,6 +13903,7 @@ update_breakpoint_locations (struct breakpoint *b,
 			 "for breakpoint %d: %s"), 
 		       b->number, e.what ());
 	      new_loc->enabled = 0;
+	      b->needs_global_re_set = true;
 	    }
 	}
 
@@ -13786,25 +14145,110 @@ decode_location_default (struct breakpoint *b,
   return {};
 }
 
-/* Reset a breakpoint.  */
+/* Return true if adding OBJFILE to its program space may change the
+   locations of B.  This must be called with B's language and input
+   radix selected.  */
+
+static bool
+breakpoint_affected_by_objfile (struct breakpoint *b,
+				struct objfile *objfile)
+{
+  /* Only breakpoints re-set by breakpoint_re_set_default, with a
+     location that is looked up in the symbol tables, can be checked
+     against OBJFILE alone.  */
+  if ((b->ops->re_set != bkpt_re_set
+       && b->ops->re_set != dprintf_re_set
+       && b->ops->re_set != tracepoint_re_set)
+      || (b->ops->decode_location != bkpt_decode_location
+	  && b->ops->decode_location != tracepoint_decode_location)
+      || b->type == bp_static_tracepoint
+      || b->location == NULL
+      || (event_location_type (b->location.get ()) != LINESPEC_LOCATION
+	  && event_location_type (b->location.get ()) != EXPLICIT_LOCATION)
+      || b->location_range_end != NULL)
+    return true;
+
+  /* The linespec lookups restricted to OBJFILE are only known to find
+     everything OBJFILE adds for the C family of languages.  Ada and
+     Objective-C, for instance, have lookup paths of their own.  */
+  if (b->language != language_c
+      && b->language != language_cplus
+      && b->language != language_asm
+      && b->language != language_minimal)
+    return true;
+
+  /* Pending breakpoints, and breakpoints that may refer to OBJFILE
+     in a way OBJFILE's symbols don't tell, need a full re-set.  A
+     GNU ifunc's target may be resolved into any objfile, not just the
+     one defining the ifunc.  */
+  if (b->condition_not_parsed || b->needs_global_re_set
+      || b->type == bp_gnu_ifunc_resolver)
+    return true;
+
+  /* Likewise if B has no location in OBJFILE's program space, or if
+     any of its locations there is pending, comes from an unknown
+     objfile, or was set on a GNU ifunc.  */
+  bool found = false;
+  for (bp_location *loc = b->loc; loc != NULL; loc = loc->next)
+    if (loc->pspace == objfile->pspace)
+      {
+	if (loc->shlib_disabled || loc->objfile == NULL)
+	  return true;
+	if (loc->msymbol != NULL
+	    && (MSYMBOL_TYPE (loc->msymbol) == mst_text_gnu_ifunc
+		|| MSYMBOL_TYPE (loc->msymbol) == mst_data_gnu_ifunc))
+	  return true;
+	found = true;
+      }
+  if (!found)
+    return true;
+
+  try
+    {
+      return decode_line_matches_objfile (b->location.get (), objfile,
+					  b->filter.get ());
+    }
+  catch (const gdb_exception_error &e)
+    {
+      /* Let the full re-set report the error.  */
+      return true;
+    }
+}
+
+/* Reset a breakpoint.  If NEW_OBJFILES is not empty, only do so if
+   adding NEW_OBJFILES may change its locations.  */
 
 static void
-breakpoint_re_set_one (breakpoint *b)
+breakpoint_re_set_one (breakpoint *b,
+		       gdb::array_view<struct objfile *> new_objfiles)
 {
   input_radix = b->input_radix;
   set_language (b->language);
 
+  if (!new_objfiles.empty ()
+      && std::none_of (new_objfiles.begin (), new_objfiles.end (),
+		       [b] (struct objfile *objfile)
+		       {
+			 return breakpoint_affected_by_objfile (b, objfile);
+		       }))
+    return;
+
   b->ops->re_set (b);
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* Worker for breakpoint_re_set and breakpoint_re_set_objfiles.  If
+   NEW_OBJFILES is empty, re-set all the breakpoints.  */
 
-void
-breakpoint_re_set (void)
+static void
+breakpoint_re_set_1 (gdb::array_view<struct objfile *> new_objfiles)
 {
   struct breakpoint *b, *b_tmp;
 
+  /* Re-setting the breakpoints and re-creating the internal ones below
+     may update the global location list many times over.  Do it just
+     once, at the end.  */
+  scoped_batch_location_list_update batch_update;
+
   {
     scoped_restore_current_language save_language;
     scoped_restore save_input_radix = make_scoped_restore (&input_radix);
@@ -13832,7 +14276,7 @@ breakpoint_re_set (void)
       {
 	try
 	  {
-	    breakpoint_re_set_one (b);
+	    breakpoint_re_set_one (b, new_objfiles);
 	  }
 	catch (const gdb_exception &ex)
 	  {
@@ -13853,6 +14297,27 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 ({});
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (gdb::array_view<struct objfile *> objfiles)
+{
+  /* Without any objfile, this would re-set all the breakpoints.  */
+  if (objfiles.empty ())
+    return;
+
+  breakpoint_re_set_1 (objfiles);
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -15246,8 +15711,12 @@ breakpoint_free_objfile (struct objfile *objfile)
   struct bp_location **locp, *loc;
 
   ALL_BP_LOCATIONS (loc, locp)
-    if (loc->symtab != NULL && SYMTAB_OBJFILE (loc->symtab) == objfile)
-      loc->symtab = NULL;
+    {
+      if (loc->symtab != NULL && SYMTAB_OBJFILE (loc->symtab) == objfile)
+	loc->symtab = NULL;
+      if (loc->objfile == objfile)
+	loc->objfile = NULL;
+    }
 }
 
 void
@@ -15680,6 +16149,13 @@ Convenience variable \"$bpnum\" contains the number of the last\n\
 breakpoint set."),
 	   &maintenanceinfolist);
 
+  add_cmd ("breakpoint-lookup-statistics", class_maintenance,
+	   maintenance_print_breakpoint_lookup_statistics, _("\
+Print statistics about looking up the breakpoints hit at each stop.\n\
+This shows how many breakpoint locations had to be checked to find\n\
+the ones that explain a stop, in total and for the last stop."),
+	   &maintenanceprintlist);
+
   add_basic_prefix_cmd ("catch", class_breakpoint, _("\
 Set catchpoints to catch events."),
 			&catch_cmdlist, "catch ",
@@ -405,6 +405,11 @@ class bp_location
      should be downloaded and so that `tfind N' always works.  */
   bool duplicate = false;
 
+  /* Scratch flag used by update_global_location_list to tell the
+     locations that are new to the global location list from the ones
+     that were already there.  False outside of that function.  */
+  bool ugll_mark = false;
+
   /* If we someday support real thread-specific breakpoints, then
      the breakpoint location will need a thread identifier.  */
 
@@ -500,7 +505,9 @@ class bp_location
      originally set on a GNU ifunc symbol.  */
   const minimal_symbol *msymbol = NULL;
 
-  /* The objfile the symbol or minimal symbol were found in.  */
+  /* The objfile the symbol or minimal symbol were found in, or else
+     the objfile of SYMTAB or SECTION.  This is NULL if unknown, and is
+     cleared when the objfile is freed.  */
   const struct objfile *objfile = NULL;
 };
 
@@ -693,6 +700,10 @@ struct breakpoint
   const breakpoint_ops *ops = NULL;
 
   breakpoint *next = NULL;
+  /* Breakpoints are always added at the end of the chain, and get
+     increasing values of this, so it orders breakpoints as the chain
+     does.  */
+  unsigned long chain_order = 0;
   /* Type of breakpoint.  */
   bptype type = bp_none;
   /* Zero means disabled; remember the info but don't break here.  */
@@ -780,6 +791,13 @@ struct breakpoint
      in.  */
   int condition_not_parsed = 0;
 
+  /* True if this breakpoint must be re-set against all the objfiles
+     when a new objfile is added, rather than only if the new objfile
+     matches its location.  This is set when the condition could not
+     be parsed at some location, since the new objfile may define what
+     the condition refers to.  */
+  bool needs_global_re_set = false;
+
   /* With a Python scripting enabled GDB, store a reference to the
      Python object that has been associated with this breakpoint.
      This is always NULL for a GDB that is not script enabled.  It can
@@ -1252,6 +1270,15 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, but after OBJFILES were added to the current
+   program space.  This only re-sets the breakpoints whose locations
+   may change because of the new objfiles: those whose location
+   matches something in one of OBJFILES, and those that are pending or
+   need to be re-set against all the objfiles anyway.  */
+
+extern void breakpoint_re_set_objfiles
+  (gdb::array_view<struct objfile *> objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
@@ -1657,6 +1684,22 @@ class scoped_rbreak_breakpoints
   DISABLE_COPY_AND_ASSIGN (scoped_rbreak_breakpoints);
 };
 
+/* Create an instance of this to create or re-set many breakpoints in
+   bulk.  While it exists, the global location list is not updated
+   each time a breakpoint is created or re-set; it is updated once,
+   when the last instance is destroyed.  Deleting a breakpoint still
+   updates the list right away.  */
+
+class scoped_batch_location_list_update
+{
+public:
+
+  scoped_batch_location_list_update ();
+  ~scoped_batch_location_list_update ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_batch_location_list_update);
+};
+
 /* Breakpoint iterator function.
 
    Calls a callback function once for each breakpoint, so long as the
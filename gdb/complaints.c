@@ -33,18 +33,16 @@ static std::unordered_map<const char *, int> counters;
 
 int stop_whining = 0;
 
-/* See complaints.h.  */
+/* Where complaints issued by the current thread are stored, if a
+   complaint_interceptor is active.  */
 
-void
-complaint_internal (const char *fmt, ...)
-{
-  va_list args;
+static thread_local intercepted_complaints *complaint_storage;
 
-  if (++counters[fmt] > stop_whining)
-    return;
-
-  va_start (args, fmt);
+/* Print a complaint, formatted using FMT and ARGS.  */
 
+static void ATTRIBUTE_PRINTF (1, 0)
+vprint_complaint (const char *fmt, va_list args)
+{
   if (deprecated_warning_hook)
     (*deprecated_warning_hook) (fmt, args);
   else
@@ -53,7 +51,40 @@ complaint_internal (const char *fmt, ...)
       vfprintf_filtered (gdb_stderr, fmt, args);
       fputs_filtered ("\n", gdb_stderr);
     }
+}
+
+/* Like vprint_complaint, but with a variable argument list.  */
+
+static void ATTRIBUTE_PRINTF (1, 2)
+print_complaint (const char *fmt, ...)
+{
+  va_list args;
 
+  va_start (args, fmt);
+  vprint_complaint (fmt, args);
+  va_end (args);
+}
+
+/* See complaints.h.  */
+
+void
+complaint_internal (const char *fmt, ...)
+{
+  va_list args;
+
+  if (complaint_storage != nullptr)
+    {
+      va_start (args, fmt);
+      complaint_storage->push_back ({fmt, string_vprintf (fmt, args)});
+      va_end (args);
+      return;
+    }
+
+  if (++counters[fmt] > stop_whining)
+    return;
+
+  va_start (args, fmt);
+  vprint_complaint (fmt, args);
   va_end (args);
 }
 
@@ -65,6 +96,35 @@ clear_complaints ()
   counters.clear ();
 }
 
+/* See complaints.h.  */
+
+complaint_interceptor::complaint_interceptor (intercepted_complaints *storage)
+  : m_saved (complaint_storage)
+{
+  complaint_storage = storage;
+}
+
+complaint_interceptor::~complaint_interceptor ()
+{
+  complaint_storage = m_saved;
+}
+
+/* See complaints.h.  */
+
+void
+re_emit_complaints (const intercepted_complaints &complaints)
+{
+  gdb_assert (complaint_storage == nullptr);
+
+  for (const intercepted_complaint &c : complaints)
+    {
+      if (++counters[c.fmt] > stop_whining)
+	continue;
+
+      print_complaint ("%s", c.message.c_str ());
+    }
+}
+
 static void
 complaints_show_value (struct ui_file *file, int from_tty,
 		       struct cmd_list_element *cmd, const char *value)
@@ -46,5 +46,44 @@ extern int stop_whining;
 
 extern void clear_complaints ();
 
+/* A complaint that was issued while a complaint_interceptor was
+   active.  FMT is the format string, which is also the key used to
+   count complaints, and MESSAGE is the formatted text.  */
+
+struct intercepted_complaint
+{
+  const char *fmt;
+  std::string message;
+};
+
+typedef std::vector<intercepted_complaint> intercepted_complaints;
+
+/* While an object of this type exists, complaints issued by the
+   current thread are not printed, but are instead appended to
+   STORAGE.  This is used by code that reads debug info on worker
+   threads; the complaints can then be re-emitted on the main thread,
+   in a deterministic order, using re_emit_complaints.  */
+
+class complaint_interceptor
+{
+public:
+
+  explicit complaint_interceptor (intercepted_complaints *storage);
+  ~complaint_interceptor ();
+
+  DISABLE_COPY_AND_ASSIGN (complaint_interceptor);
+
+private:
+
+  /* The storage that was active when this object was created.  */
+  intercepted_complaints *m_saved;
+};
+
+/* Emit the complaints in COMPLAINTS, in order, as if they had been
+   issued by the current thread.  This must be called on the main
+   thread.  */
+
+extern void re_emit_complaints (const intercepted_complaints &complaints);
+
 
 #endif /* !defined (COMPLAINTS_H) */
@@ -26,6 +26,8 @@
 #include "splay-tree.h"
 #include "gdbarch.h"
 
+#include <algorithm>
+
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
 static struct cmd_list_element *dcache_show_list = NULL;
@@ -458,6 +460,89 @@ dcache_init (void)
 }
 
 
+/* If this is a different inferior from what DCACHE has recorded,
+   flush it.  */
+
+static void
+dcache_check_ptid (DCACHE *dcache)
+{
+  if (inferior_ptid != dcache->ptid)
+    {
+      dcache_invalidate (dcache);
+      dcache->ptid = inferior_ptid;
+    }
+}
+
+/* See dcache.h.  */
+
+void
+dcache_prefetch (struct target_ops *ops, DCACHE *dcache,
+		 gdb::array_view<const mem_range> ranges)
+{
+  std::vector<CORE_ADDR> candidates, lines;
+
+  dcache_check_ptid (dcache);
+
+  /* The lines covering RANGES, without duplicates: ranges may overlap
+     or share lines.  Reading more lines than the cache holds would
+     evict some of them right away.  */
+  for (const mem_range &range : ranges)
+    {
+      if (range.length <= 0)
+	continue;
+
+      CORE_ADDR last = MASK (dcache, range.start + range.length - 1);
+      unsigned count = 0;
+      for (CORE_ADDR addr = MASK (dcache, range.start);
+	   count < dcache_size;
+	   addr += dcache->line_size, count++)
+	{
+	  candidates.push_back (addr);
+	  if (addr == last)
+	    break;
+	}
+    }
+  std::sort (candidates.begin (), candidates.end ());
+  candidates.erase (std::unique (candidates.begin (), candidates.end ()),
+		    candidates.end ());
+
+  /* Find the lines to read.  Leave those that are not entirely in a
+     readable memory region to dcache_read_line, which reads them
+     piecewise.  */
+  for (CORE_ADDR addr : candidates)
+    {
+      struct mem_region *region = lookup_mem_region (addr);
+
+      if ((region->attrib.mode == MEM_RW || region->attrib.mode == MEM_RO)
+	  && (region->hi == 0 || addr + dcache->line_size <= region->hi)
+	  && splay_tree_lookup (dcache->tree, (splay_tree_key) addr) == NULL)
+	{
+	  lines.push_back (addr);
+	  if (lines.size () == dcache_size)
+	    break;
+	}
+    }
+
+  /* A single line is read just as fast when it is needed.  */
+  if (lines.size () < 2)
+    return;
+
+  std::vector<memory_read_request> requests;
+  for (CORE_ADDR addr : lines)
+    {
+      struct dcache_block *db = dcache_alloc (dcache, addr);
+
+      requests.emplace_back (addr, db->data, dcache->line_size);
+    }
+
+  target_read_raw_memory_multiple (ops, requests);
+
+  /* Don't keep partially read lines.  */
+  for (const memory_read_request &req : requests)
+    if (req.xfered_len != req.len)
+      dcache_invalidate_line (dcache, req.addr);
+}
+
 /* Read LEN bytes from dcache memory at MEMADDR, transferring to
    debugger address MYADDR.  If the data is presently cached, this
    fills the cache.  Arguments/return are like the target_xfer_partial
@@ -470,13 +555,17 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
 {
   ULONGEST i;
 
-  /* If this is a different inferior from what we've recorded,
-     flush the cache.  */
+  dcache_check_ptid (dcache);
 
-  if (inferior_ptid != dcache->ptid)
+  /* If this read spans several lines, read those that are missing all
+     at once.  */
+  if (XFORM (dcache, memaddr) + len > dcache->line_size)
     {
-      dcache_invalidate (dcache);
-      dcache->ptid = inferior_ptid;
+      ULONGEST max = (ULONGEST) dcache_size * dcache->line_size;
+      mem_range range (memaddr, std::min (std::min (len, max),
+					  (ULONGEST) INT_MAX));
+
+      dcache_prefetch (ops, dcache, range);
     }
 
   for (i = 0; i < len; i++)
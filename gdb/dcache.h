@@ -22,6 +22,7 @@
 #define DCACHE_H
 
 #include "target.h"	/* for enum target_xfer_status */
+#include "memrange.h"
 
 typedef struct dcache_struct DCACHE;
 
@@ -48,6 +49,13 @@ enum target_xfer_status
 			      CORE_ADDR memaddr, gdb_byte *myaddr,
 			      ULONGEST len, ULONGEST *xfered_len);
 
+/* Read into DCACHE the lines covering RANGES that it does not hold
+   yet, reading them from target OPS at once if it can.  Lines that
+   can't be read are left out.  */
+
+void dcache_prefetch (struct target_ops *ops, DCACHE *dcache,
+		      gdb::array_view<const mem_range> ranges);
+
 void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
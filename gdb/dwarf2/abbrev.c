@@ -51,6 +51,135 @@ eq_abbrev (const void *lhs, const void *rhs)
   return l_info->number == r_info->number;
 }
 
+/* Return true if TAG is a tag of a type that we might generate a
+   partial symbol for.  */
+
+static bool
+is_type_tag_for_partial (int tag)
+{
+  switch (tag)
+    {
+#if 0
+    /* Some types that would be reasonable to generate partial symbols for,
+       that we don't at present.  */
+    case DW_TAG_array_type:
+    case DW_TAG_file_type:
+    case DW_TAG_ptr_to_member_type:
+    case DW_TAG_set_type:
+    case DW_TAG_string_type:
+    case DW_TAG_subroutine_type:
+#endif
+    case DW_TAG_base_type:
+    case DW_TAG_class_type:
+    case DW_TAG_interface_type:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_subrange_type:
+    case DW_TAG_typedef:
+    case DW_TAG_union_type:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Return true if load_partial_dies may need a partial DIE for a DIE
+   with tag TAG.  Normally we would not be interested in members here,
+   but there may be later variables referencing them via
+   DW_AT_specification (for static members).  */
+
+static bool
+tag_interesting_for_partial_die (enum dwarf_tag tag)
+{
+  if (is_type_tag_for_partial (tag))
+    return true;
+
+  switch (tag)
+    {
+    case DW_TAG_constant:
+    case DW_TAG_enumerator:
+    case DW_TAG_subprogram:
+    case DW_TAG_inlined_subroutine:
+    case DW_TAG_lexical_block:
+    case DW_TAG_variable:
+    case DW_TAG_namespace:
+    case DW_TAG_module:
+    case DW_TAG_member:
+    case DW_TAG_imported_unit:
+    case DW_TAG_imported_declaration:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Return the size of an attribute of form FORM, if it is the same in
+   all compilation units, or -1 otherwise.  */
+
+static int
+constant_form_size (enum dwarf_form form)
+{
+  switch (form)
+    {
+    case DW_FORM_flag_present:
+    case DW_FORM_implicit_const:
+      return 0;
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+    case DW_FORM_flag:
+    case DW_FORM_strx1:
+      return 1;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+    case DW_FORM_strx2:
+      return 2;
+    case DW_FORM_strx3:
+      return 3;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+    case DW_FORM_strx4:
+      return 4;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+      return 8;
+    case DW_FORM_data16:
+      return 16;
+    default:
+      /* The size of the other forms depends on the header of the
+	 compilation unit, or on the data itself.  */
+      return -1;
+    }
+}
+
+/* Return true if an attribute named NAME, of form FORM, can be read
+   directly, see attr_abbrev::direct.  */
+
+static bool
+attr_can_be_read_directly (enum dwarf_attribute name, enum dwarf_form form)
+{
+  switch (form)
+    {
+    case DW_FORM_data4:
+      /* read_attribute_value checks the value of DW_AT_byte_size
+	 attributes of this form.  */
+      return name != DW_AT_byte_size;
+    case DW_FORM_flag_present:
+    case DW_FORM_implicit_const:
+    case DW_FORM_data1:
+    case DW_FORM_data2:
+    case DW_FORM_data8:
+    case DW_FORM_flag:
+    case DW_FORM_ref1:
+    case DW_FORM_ref2:
+    case DW_FORM_ref4:
+    case DW_FORM_ref8:
+      return true;
+    default:
+      return false;
+    }
+}
+
 /* Abbreviation tables.
 
    In DWARF version 2, the description of the debugging information is
@@ -152,7 +281,37 @@ abbrev_table::read (struct objfile *objfile,
 	  cur_attr.name = (enum dwarf_attribute) abbrev_name;
 	  cur_attr.form = (enum dwarf_form) abbrev_form;
 	  cur_attr.implicit_const = implicit_const;
+	  cur_attr.direct = attr_can_be_read_directly (cur_attr.name,
+						       cur_attr.form);
+	}
+
+      cur_abbrev->interesting
+	= tag_interesting_for_partial_die (cur_abbrev->tag);
+
+      /* Compute the size of the DIEs using this abbrev, and the offset
+	 of their DW_AT_sibling attribute, when they can be known before
+	 reading the DIE.  This lets skip_one_die jump over DIEs without
+	 decoding their attributes.  */
+      bool is_csize = true;
+      unsigned int size = 0;
+      cur_abbrev->sibling_offset = (unsigned short) -1;
+      for (const attr_abbrev &cur_attr : cur_attrs)
+	{
+	  if (cur_attr.name == DW_AT_sibling
+	      && cur_attr.form == DW_FORM_ref4
+	      && is_csize)
+	    cur_abbrev->sibling_offset = size;
+
+	  int form_size = constant_form_size (cur_attr.form);
+	  if (form_size < 0)
+	    is_csize = false;
+	  else
+	    size += form_size;
+
+	  if (size >= (unsigned short) -1)
+	    is_csize = false;
 	}
+      cur_abbrev->size_if_constant = is_csize ? size : 0;
 
       cur_abbrev->num_attrs = cur_attrs.size ();
       cur_abbrev->attrs =
@@ -35,6 +35,16 @@ struct abbrev_info
     unsigned int number;	/* number identifying abbrev */
     enum dwarf_tag tag;		/* dwarf tag */
     unsigned short has_children;		/* boolean */
+    /* True if load_partial_dies may need a partial DIE for a DIE of
+       this abbrev.  Other DIEs are skipped, with their children.  */
+    bool interesting;
+    /* The size of the attributes of a DIE using this abbrev, or 0 if it
+       is not known before reading the DIE.  */
+    unsigned short size_if_constant;
+    /* The offset of the DW_AT_sibling attribute from the start of the
+       attributes, if it is known before reading the DIE and the
+       attribute uses DW_FORM_ref4.  Otherwise, (unsigned short) -1.  */
+    unsigned short sibling_offset;
     unsigned short num_attrs;	/* number of attributes */
     struct attr_abbrev *attrs;	/* an array of attribute descriptions */
   };
@@ -44,6 +54,12 @@ struct attr_abbrev
     ENUM_BITFIELD(dwarf_attribute) name : 16;
     ENUM_BITFIELD(dwarf_form) form : 16;
 
+    /* True if the value of this attribute is a constant, a flag or a
+       CU-relative reference whose size does not depend on the CU
+       header, and that needs no further processing once read.  Such
+       values are read without going through read_attribute_value.  */
+    bool direct;
+
     /* It is valid only if FORM is DW_FORM_implicit_const.  */
     LONGEST implicit_const;
   };
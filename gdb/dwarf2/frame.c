@@ -973,6 +973,11 @@ struct dwarf2_frame_cache
   void *tailcall_cache;
 };
 
+/* The number of bytes of stack past the CFA that dwarf2_frame_cache
+   reads along with the saved registers of a frame.  */
+
+#define DWARF2_FRAME_PREFETCH_SIZE 256
+
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 {
@@ -1191,6 +1196,27 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
+  /* Unwinding registers reads them one at a time.  Read the stack
+     slots they are saved in at once instead, which matters when each
+     read is a round trip to a remote target.  Read the stack right
+     outside of the CFA along with them: the caller's frame, whose
+     registers are unwound next when going up the stack, usually
+     starts there.  */
+  {
+    std::vector<mem_range> saved;
+
+    for (int regnum = 0; regnum < num_regs; regnum++)
+      if (cache->reg[regnum].how == DWARF2_FRAME_REG_SAVED_OFFSET)
+	saved.emplace_back (cache->cfa + cache->reg[regnum].loc.offset,
+			    register_size (gdbarch, regnum));
+    if (gdbarch_inner_than (gdbarch, 1, 2))
+      saved.emplace_back (cache->cfa, DWARF2_FRAME_PREFETCH_SIZE);
+    else
+      saved.emplace_back (cache->cfa - DWARF2_FRAME_PREFETCH_SIZE,
+			  DWARF2_FRAME_PREFETCH_SIZE);
+    target_prefetch_stack (saved);
+  }
+
   if (fs.retaddr_column < fs.regs.reg.size ()
       && fs.regs.reg[fs.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
@@ -30,8 +30,19 @@
 #include "dwarf2/dwz.h"
 #include "objfiles.h"
 #include "gdbsupport/selftest.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/gdb_unlinker.h"
+#if CXX_STD_THREAD
+#include "gdbsupport/thread-pool.h"
+#endif
+#include <algorithm>
 #include <string>
 #include <stdlib.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <utime.h>
 
 /* When set to true, show debug messages about the index cache.  */
 static bool debug_index_cache = false;
@@ -39,6 +50,18 @@ static bool debug_index_cache = false;
 /* The index cache directory, used for "set/show index-cache directory".  */
 static char *index_cache_directory = NULL;
 
+/* The maximum size of the index cache directory, in megabytes, used for
+   "set/show index-cache max-size".  -1 means unlimited.  */
+static int index_cache_max_size = -1;
+
+/* Whether minimal symbol tables are stored in the cache, used for
+   "set/show index-cache minimal-symbols".  */
+static bool index_cache_minsyms = false;
+
+/* The name of the lock file taken while evicting index files from the
+   cache directory.  */
+#define INDEX_CACHE_LOCK_FILE "index-cache.lock"
+
 /* See dwarf-index.cache.h.  */
 index_cache global_index_cache;
 
@@ -86,6 +109,191 @@ index_cache::disable ()
 
 /* See dwarf-index-cache.h.  */
 
+void
+index_cache::set_max_size (ULONGEST max_size)
+{
+  m_max_size = max_size;
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: maximum size is now %s\n",
+		       (m_max_size == (ULONGEST) -1
+			? "unlimited" : pulongest (m_max_size)));
+}
+
+/* An index file in the cache directory.  */
+
+struct index_cache_file
+{
+  /* The name of the file, relative to the cache directory.  */
+  std::string name;
+
+  /* The size of the file.  */
+  ULONGEST size;
+
+  /* The last time the file was written or used, see
+     index_cache::lookup_file.  */
+  time_t mtime;
+};
+
+/* Return true if NAME ends with SUFFIX, and is longer.  */
+
+static bool
+has_suffix (const char *name, const char *suffix)
+{
+  size_t name_len = strlen (name);
+  size_t suffix_len = strlen (suffix);
+
+  return (name_len > suffix_len
+	  && strcmp (name + name_len - suffix_len, suffix) == 0);
+}
+
+/* List the index and minimal symbol table files found in DIR.  Files
+   that are still being written, which have a temporary name, are not
+   listed.  */
+
+static std::vector<index_cache_file>
+list_index_cache_files (const std::string &dir)
+{
+  std::vector<index_cache_file> files;
+
+  DIR *dirp = opendir (dir.c_str ());
+  if (dirp == nullptr)
+    return files;
+
+  struct dirent *dp;
+  while ((dp = readdir (dirp)) != nullptr)
+    {
+      if (!has_suffix (dp->d_name, INDEX4_SUFFIX)
+	  && !has_suffix (dp->d_name, MINSYMS_SUFFIX))
+	continue;
+
+      std::string filename = dir + SLASH_STRING + dp->d_name;
+      struct stat st;
+
+      if (stat (filename.c_str (), &st) != 0 || !S_ISREG (st.st_mode))
+	continue;
+
+      files.push_back ({ dp->d_name, (ULONGEST) st.st_size, st.st_mtime });
+    }
+
+  closedir (dirp);
+  return files;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::evict ()
+{
+  if (!enabled () || m_dir.empty ())
+    return;
+
+  evict (m_dir, m_max_size);
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::evict (const std::string &dir, ULONGEST max_size)
+{
+  if (max_size == (ULONGEST) -1)
+    return;
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> evict_guard (m_evict_mutex);
+#endif
+
+  /* Several GDB processes may share the cache directory.  Take an
+     advisory lock, so that they don't try to evict the same files at
+     the same time.  The lock is released when the file is closed.  */
+  std::string lock_filename = dir + SLASH_STRING + INDEX_CACHE_LOCK_FILE;
+  scoped_fd lock_fd (gdb_open_cloexec (lock_filename, O_RDWR | O_CREAT,
+				       0666));
+#ifdef F_SETLKW
+  if (lock_fd.get () >= 0)
+    {
+      struct flock fl;
+
+      memset (&fl, 0, sizeof (fl));
+      fl.l_type = F_WRLCK;
+      fl.l_whence = SEEK_SET;
+
+      /* If the lock can't be taken, go on anyway: the worst that can
+	 happen is that another GDB fails to remove a file that is
+	 already gone.  */
+      while (fcntl (lock_fd.get (), F_SETLKW, &fl) != 0 && errno == EINTR)
+	;
+    }
+#endif
+
+  std::vector<index_cache_file> files = list_index_cache_files (dir);
+
+  ULONGEST total_size = 0;
+  for (const index_cache_file &file : files)
+    total_size += file.size;
+
+  if (total_size <= max_size)
+    return;
+
+  /* Remove the least recently used files first.  The access time is
+     not reliable, as the file system may be mounted with noatime or
+     relatime, so cache hits update the modification time instead.  */
+  std::sort (files.begin (), files.end (),
+	     [] (const index_cache_file &a, const index_cache_file &b)
+	     {
+	       return a.mtime < b.mtime;
+	     });
+
+  unsigned int n_evictions = 0;
+  for (const index_cache_file &file : files)
+    {
+      if (total_size <= max_size)
+	break;
+
+      std::string filename = dir + SLASH_STRING + file.name;
+      if (unlink (filename.c_str ()) == 0 || errno == ENOENT)
+	{
+	  total_size -= file.size;
+	  n_evictions++;
+	}
+    }
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  m_n_evictions += n_evictions;
+}
+
+/* Return true if the index of PER_OBJFILE can be written by a worker
+   thread while the main thread goes on.  */
+
+static bool
+can_store_in_background (dwarf2_per_objfile *per_objfile)
+{
+#if CXX_STD_THREAD
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return false;
+
+  /* Type units read from DWO files are added to the signatured_types
+     table as they are needed, which the index writer would race with.  */
+  if (per_objfile->per_bfd->dwo_files != nullptr)
+    return false;
+
+  /* Writing the names of Ada symbols uses ada_decode, ada_encode and
+     main_name, which are not thread-safe.  */
+  for (dwarf2_per_cu_data *per_cu : per_objfile->per_bfd->all_comp_units)
+    if (per_cu->lang == language_ada)
+      return false;
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* See dwarf-index-cache.h.  */
+
 void
 index_cache::store (dwarf2_per_objfile *per_objfile)
 {
@@ -109,7 +317,6 @@ index_cache::store (dwarf2_per_objfile *per_objfile)
   /* Get build id of dwz file, if present.  */
   gdb::optional<std::string> dwz_build_id_str;
   const dwz_file *dwz = dwarf2_get_dwz_file (per_objfile->per_bfd);
-  const char *dwz_build_id_ptr = NULL;
 
   if (dwz != nullptr)
     {
@@ -124,7 +331,6 @@ index_cache::store (dwarf2_per_objfile *per_objfile)
 	}
 
       dwz_build_id_str = build_id_to_string (dwz_build_id);
-      dwz_build_id_ptr = dwz_build_id_str->c_str ();
     }
 
   if (m_dir.empty ())
@@ -133,32 +339,234 @@ index_cache::store (dwarf2_per_objfile *per_objfile)
       return;
     }
 
-  try
+  /* Try to create the containing directory.  */
+  if (!mkdir_recursive (m_dir.c_str ()))
     {
-      /* Try to create the containing directory.  */
-      if (!mkdir_recursive (m_dir.c_str ()))
-	{
-	  warning (_("index cache: could not make cache directory: %s"),
-		   safe_strerror (errno));
-	  return;
-	}
+      warning (_("index cache: could not make cache directory: %s"),
+	       safe_strerror (errno));
+      return;
+    }
 
+  pending_store store { per_objfile, m_dir, m_max_size,
+			std::move (build_id_str),
+			std::move (dwz_build_id_str), nullptr };
+
+  if (!can_store_in_background (per_objfile))
+    {
       if (debug_index_cache)
-        printf_unfiltered ("index cache: writing index cache for objfile %s\n",
+	printf_unfiltered ("index cache: writing index cache for objfile %s\n",
 			   objfile_name (obj));
 
-      /* Write the index itself to the directory, using the build id as the
-         filename.  */
-      write_psymtabs_to_index (per_objfile, m_dir.c_str (),
-			       build_id_str.c_str (), dwz_build_id_ptr,
-			       dw_index_kind::GDB_INDEX);
+      do_store (store, false);
+      return;
+    }
+
+#if CXX_STD_THREAD
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: queuing index cache write for "
+		       "objfile %s\n", objfile_name (obj));
+
+  /* The main thread goes on changing the CUs while the index is
+     written; copy what the writer needs of them now.  */
+  store.snapshot.reset (new index_write_snapshot (per_objfile));
+
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+
+  m_pending_stores.push_back (std::move (store));
+
+  /* A single task writes all the queued indices one after the other.
+     It does all the work of each itself: waiting for the thread pool
+     while holding a worker thread could starve the pool.  */
+  if (!m_store_task_running)
+    {
+      m_store_task_running = true;
+      gdb::thread_pool::g_thread_pool->post_task ([this] ()
+	{
+	  process_pending_stores ();
+	});
+    }
+#endif
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::do_store (const pending_store &store, bool background)
+{
+  const char *dwz_build_id_ptr = (store.dwz_build_id_str.has_value ()
+				  ? store.dwz_build_id_str->c_str ()
+				  : nullptr);
+  bool ok = false;
+
+  try
+    {
+      /* Write the index itself to the directory, using the build id as
+	 the filename.  The index is written to a temporary file which is
+	 then renamed, so that a reader never sees a partial index.  */
+      write_psymtabs_to_index (store.per_objfile, store.dir.c_str (),
+			       store.build_id_str.c_str (), dwz_build_id_ptr,
+			       dw_index_kind::GDB_INDEX,
+			       store.snapshot.get ());
+      ok = true;
+
+      /* Make room for the new index.  */
+      evict (store.dir, store.max_size);
     }
   catch (const gdb_exception_error &except)
     {
-      if (debug_index_cache)
+      /* Debug output may only be printed by the main thread.  */
+      if (debug_index_cache && !background)
 	printf_unfiltered ("index cache: couldn't store index cache for objfile "
-			   "%s: %s", objfile_name (obj), except.what ());
+			   "%s: %s\n", objfile_name (store.per_objfile->objfile),
+			   except.what ());
     }
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  if (ok)
+    m_n_completed_stores++;
+  else
+    m_n_failed_stores++;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::process_pending_stores ()
+{
+#if CXX_STD_THREAD
+  std::unique_lock<std::mutex> lock (m_store_mutex);
+
+  while (!m_pending_stores.empty ())
+    {
+      pending_store store = std::move (m_pending_stores.front ());
+      m_pending_stores.pop_front ();
+      m_current_store = store.per_objfile;
+
+      lock.unlock ();
+      try
+	{
+	  do_store (store, true);
+	}
+      catch (...)
+	{
+	  /* Nothing may escape the worker thread, or the waiters would
+	     never be woken up.  */
+	  lock.lock ();
+	  m_n_failed_stores++;
+	  lock.unlock ();
+	}
+      lock.lock ();
+
+      m_current_store = nullptr;
+      m_store_cv.notify_all ();
+    }
+
+  m_store_task_running = false;
+  m_store_cv.notify_all ();
+#endif
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::wait_for_store (dwarf2_per_objfile *per_objfile)
+{
+#if CXX_STD_THREAD
+  std::unique_lock<std::mutex> lock (m_store_mutex);
+
+  m_pending_stores.erase
+    (std::remove_if (m_pending_stores.begin (), m_pending_stores.end (),
+		     [=] (const pending_store &store)
+		     {
+		       return store.per_objfile == per_objfile;
+		     }),
+     m_pending_stores.end ());
+
+  m_store_cv.wait (lock, [=] ()
+    {
+      return m_current_store != per_objfile;
+    });
+#endif
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::wait_for_all_stores ()
+{
+#if CXX_STD_THREAD
+  std::unique_lock<std::mutex> lock (m_store_mutex);
+
+  m_store_cv.wait (lock, [this] ()
+    {
+      return !m_store_task_running;
+    });
+#endif
+}
+
+/* See dwarf-index-cache.h.  */
+
+unsigned int
+index_cache::n_pending_stores ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  return m_pending_stores.size () + (m_current_store != nullptr);
+}
+
+/* See dwarf-index-cache.h.  */
+
+unsigned int
+index_cache::n_completed_stores ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  return m_n_completed_stores;
+}
+
+/* See dwarf-index-cache.h.  */
+
+unsigned int
+index_cache::n_failed_stores ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  return m_n_failed_stores;
+}
+
+/* See dwarf-index-cache.h.  */
+
+unsigned int
+index_cache::n_evictions ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_store_mutex);
+#endif
+
+  return m_n_evictions;
+}
+
+/* See dwarf-index-cache.h.  */
+
+ULONGEST
+index_cache::disk_usage () const
+{
+  ULONGEST total_size = 0;
+
+  if (!m_dir.empty ())
+    for (const index_cache_file &file : list_index_cache_files (m_dir))
+      total_size += file.size;
+
+  return total_size;
 }
 
 #if HAVE_SYS_MMAN_H
@@ -179,8 +587,8 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_file (const bfd_build_id *build_id, const char *suffix,
+			  std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -192,8 +600,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect the file for this build id to be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -208,6 +616,13 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       /* Yay, it worked!  Hand the resource to the caller.  */
       resource->reset (mmap_resource);
 
+      /* Record the hit in the modification time of the file, which is
+	 what eviction orders by.  A failure only makes the file look
+	 older than it is.  */
+      if (utime (filename.c_str (), nullptr) != 0 && debug_index_cache)
+	printf_unfiltered ("index cache: couldn't update the time of "
+			   "%s: %s\n", filename.c_str (), safe_strerror (errno));
+
       return gdb::array_view<const gdb_byte>
 	  ((const gdb_byte *) mmap_resource->mapping.get (),
 	   mmap_resource->mapping.size ());
@@ -227,8 +642,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_file (const bfd_build_id *build_id, const char *suffix,
+			  std::unique_ptr<index_cache_resource> *resource)
 {
   return {};
 }
@@ -237,6 +652,113 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 
 /* See dwarf-index-cache.h.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_file (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* Return the suffix of the name of the minimal symbol table file, see
+   index_cache::lookup_minsyms.  */
+
+static const char *
+minsyms_suffix (bool separate_debug)
+{
+  return separate_debug ? ".debug" MINSYMS_SUFFIX : MINSYMS_SUFFIX;
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_minsyms (const bfd_build_id *build_id,
+			     bool separate_debug,
+			     std::unique_ptr<index_cache_resource> *resource)
+{
+  if (!minsyms_enabled ())
+    return {};
+
+  gdb::array_view<const gdb_byte> contents
+    = lookup_file (build_id, minsyms_suffix (separate_debug), resource);
+
+  if (contents.empty ())
+    m_n_minsyms_misses++;
+  else
+    m_n_minsyms_hits++;
+
+  return contents;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_minsyms (const bfd_build_id *build_id,
+			    bool separate_debug,
+			    gdb::array_view<const gdb_byte> contents)
+{
+  if (!minsyms_enabled ())
+    return;
+
+  if (m_dir.empty ())
+    {
+      warning (_("The index cache directory name is empty, skipping store."));
+      return;
+    }
+
+  /* Try to create the containing directory.  */
+  if (!mkdir_recursive (m_dir.c_str ()))
+    {
+      warning (_("index cache: could not make cache directory: %s"),
+	       safe_strerror (errno));
+      return;
+    }
+
+  std::string filename
+    = make_index_filename (build_id, minsyms_suffix (separate_debug));
+
+  try
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: writing %s\n", filename.c_str ());
+
+      /* As for indices, write to a temporary file which is then renamed,
+	 so that a reader never sees a partial file.  */
+      gdb::char_vector filename_temp = make_temp_filename (filename);
+      scoped_fd out_file_fd (gdb_mkostemp_cloexec (filename_temp.data (),
+						   O_BINARY));
+      if (out_file_fd.get () == -1)
+	perror_with_name (("mkstemp"));
+
+      gdb::unlinker unlink_file (filename_temp.data ());
+      gdb_file_up out_file = out_file_fd.to_file ("wb");
+      if (out_file == nullptr)
+	error (_("Can't open `%s' for writing"), filename_temp.data ());
+
+      if (fwrite (contents.data (), 1, contents.size (), out_file.get ())
+	  != contents.size ())
+	error (_("couldn't write %s: %s"), filename_temp.data (),
+	       safe_strerror (errno));
+
+      /* The file must be closed before being renamed on MS-Windows.  */
+      if (fclose (out_file.release ()) != 0)
+	perror_with_name (("fclose"));
+      if (rename (filename_temp.data (), filename.c_str ()) != 0)
+	perror_with_name (("rename"));
+      unlink_file.keep ();
+
+      /* Make room for the new file.  */
+      evict (m_dir, m_max_size);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't store %s: %s\n",
+			   filename.c_str (), except.what ());
+    }
+}
+
+/* See dwarf-index-cache.h.  */
+
 std::string
 index_cache::make_index_filename (const bfd_build_id *build_id,
 				  const char *suffix) const
@@ -296,6 +818,15 @@ set_index_cache_directory_command (const char *arg, int from_tty,
   global_index_cache.set_directory (index_cache_directory);
 }
 
+/* "set index-cache minimal-symbols" handler.  */
+
+static void
+set_index_cache_minsyms_command (const char *arg, int from_tty,
+				 cmd_list_element *element)
+{
+  global_index_cache.set_minsyms_enabled (index_cache_minsyms);
+}
+
 /* "show index-cache stats" handler.  */
 
 static void
@@ -315,6 +846,68 @@ show_index_cache_stats_command (const char *arg, int from_tty)
 		     indent, global_index_cache.n_hits ());
   printf_unfiltered (_("%sCache misses (this session): %u\n"),
 		     indent, global_index_cache.n_misses ());
+  printf_unfiltered (_("%s  Minimal symbol table hits: %u\n"),
+		     indent, global_index_cache.n_minsyms_hits ());
+  printf_unfiltered (_("%sMinimal symbol table misses: %u\n"),
+		     indent, global_index_cache.n_minsyms_misses ());
+  printf_unfiltered (_("%s  Background writes pending: %u\n"),
+		     indent, global_index_cache.n_pending_stores ());
+  printf_unfiltered (_("%sBackground writes completed: %u\n"),
+		     indent, global_index_cache.n_completed_stores ());
+  printf_unfiltered (_("%s   Background writes failed: %u\n"),
+		     indent, global_index_cache.n_failed_stores ());
+  printf_unfiltered (_("%s   Evictions (this session): %u\n"),
+		     indent, global_index_cache.n_evictions ());
+  printf_unfiltered (_("%s   Bytes in cache directory: %s\n"),
+		     indent, pulongest (global_index_cache.disk_usage ()));
+}
+
+/* "set index-cache max-size" handler.  */
+
+static void
+set_index_cache_max_size_command (const char *arg, int from_tty,
+				  cmd_list_element *element)
+{
+  if (index_cache_max_size == -1)
+    global_index_cache.set_max_size ((ULONGEST) -1);
+  else
+    global_index_cache.set_max_size
+      ((ULONGEST) index_cache_max_size * 1024 * 1024);
+
+  /* Apply the new size right away.  */
+  global_index_cache.evict ();
+}
+
+/* "show index-cache max-size" handler.  */
+
+static void
+show_index_cache_max_size_command (struct ui_file *file, int from_tty,
+				   struct cmd_list_element *c,
+				   const char *value)
+{
+  if (index_cache_max_size == -1)
+    fprintf_filtered (file, _("The maximum size of the index cache "
+			      "is unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The maximum size of the index cache "
+			      "is %s megabytes.\n"), value);
+}
+
+/* "maintenance wait-for-index-cache" handler.  */
+
+static void
+maintenance_wait_for_index_cache_command (const char *arg, int from_tty)
+{
+  global_index_cache.wait_for_all_stores ();
+}
+
+/* Wait for the pending index cache writes before GDB exits, so that
+   they are not lost.  */
+
+static void
+wait_for_index_cache_cleanup (void *arg)
+{
+  global_index_cache.wait_for_all_stores ();
 }
 
 void _initialize_index_cache ();
@@ -359,11 +952,45 @@ _initialize_index_cache ()
 			    &set_index_cache_prefix_list,
 			    &show_index_cache_prefix_list);
 
+  /* set index-cache max-size */
+  add_setshow_zuinteger_unlimited_cmd ("max-size", class_files,
+				       &index_cache_max_size, _("\
+Set the maximum size of the index cache, in megabytes."), _("\
+Show the maximum size of the index cache, in megabytes."), _("\
+When the index files in the cache directory take more space than this,\n\
+the least recently accessed ones are removed.  Specifying \"unlimited\"\n\
+or -1 disables the limit."),
+				       set_index_cache_max_size_command,
+				       show_index_cache_max_size_command,
+				       &set_index_cache_prefix_list,
+				       &show_index_cache_prefix_list);
+
+  /* set index-cache minimal-symbols */
+  add_setshow_boolean_cmd ("minimal-symbols", class_files,
+			   &index_cache_minsyms, _("\
+Set whether minimal symbol tables are stored in the index cache."), _("\
+Show whether minimal symbol tables are stored in the index cache."), _("\
+When on, and the index cache is enabled, the minimal symbol table read\n\
+from the ELF symbol tables of each object file with a build id is\n\
+stored in the cache directory, with its demangled names.  Subsequent\n\
+loads of the file map it instead of reading the symbols again."),
+			   set_index_cache_minsyms_command, NULL,
+			   &set_index_cache_prefix_list,
+			   &show_index_cache_prefix_list);
+
   /* show index-cache stats */
   add_cmd ("stats", class_files, show_index_cache_stats_command,
 	   _("Show some stats about the index cache."),
 	   &show_index_cache_prefix_list);
 
+  /* maintenance wait-for-index-cache */
+  add_cmd ("wait-for-index-cache", class_maintenance,
+	   maintenance_wait_for_index_cache_command, _("\
+Wait until all the pending index cache writes are done."),
+	   &maintenancelist);
+
+  make_final_cleanup (wait_for_index_cache_cleanup, nullptr);
+
   /* set debug index-cache */
   add_setshow_boolean_cmd ("index-cache", class_maintenance,
 			   &debug_index_cache,
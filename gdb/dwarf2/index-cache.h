@@ -23,6 +23,17 @@
 #include "dwarf2/index-common.h"
 #include "gdbsupport/array-view.h"
 #include "symfile.h"
+#include <deque>
+#if CXX_STD_THREAD
+#include <condition_variable>
+#include <mutex>
+#endif
+
+struct index_write_snapshot;
+
+/* The suffix of the files holding minimal symbol tables in the index
+   cache.  See minsyms.c for their format.  */
+#define MINSYMS_SUFFIX ".gdb-minsyms"
 
 /* Base of the classes used to hold the resources of the indices loaded from
    the cache (e.g. mmapped files).  */
@@ -52,9 +63,28 @@ class index_cache
   /* Disable the cache.  */
   void disable ();
 
-  /* Store an index for the specified object file in the cache.  */
+  /* Set the maximum size, in bytes, of the index files in the cache
+     directory.  (ULONGEST) -1 means that there is no limit.  */
+  void set_max_size (ULONGEST max_size);
+
+  /* Remove the least recently accessed index files from the cache
+     directory until their total size fits in the maximum size.  */
+  void evict ();
+
+  /* Store an index for the specified object file in the cache.  When
+     possible, the index is written by a worker thread, and this
+     returns before it is done.  */
   void store (dwarf2_per_objfile *per_objfile);
 
+  /* Wait until the index of PER_OBJFILE is no longer being written in
+     the background.  A store of that index that has not started yet is
+     dropped.  This must be called before PER_OBJFILE is destroyed.  */
+  void wait_for_store (dwarf2_per_objfile *per_objfile);
+
+  /* Wait until all the indices queued for writing in the background
+     have been written.  */
+  void wait_for_all_stores ();
+
   /* Look for an index file matching BUILD_ID.  If found, return the contents
      as an array_view and store the underlying resources (allocated memory,
      mapped file, etc) in RESOURCE.  The returned array_view is valid as long
@@ -65,6 +95,42 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Return true if minimal symbol tables are stored in the cache, in
+     addition to indices.  */
+  bool minsyms_enabled () const
+  {
+    return m_enabled && m_minsyms_enabled;
+  }
+
+  /* Set whether minimal symbol tables are stored in the cache.  */
+  void set_minsyms_enabled (bool enabled)
+  {
+    m_minsyms_enabled = enabled;
+  }
+
+  /* Look for a minimal symbol table file matching BUILD_ID, in the same
+     way as lookup_gdb_index.  SEPARATE_DEBUG is true for the table of a
+     separate debug file, which has the same build id as the file it
+     was separated from.  Record a hit or a miss.  */
+  gdb::array_view<const gdb_byte>
+  lookup_minsyms (const bfd_build_id *build_id, bool separate_debug,
+		  std::unique_ptr<index_cache_resource> *resource);
+
+  /* Store CONTENTS as the minimal symbol table file for BUILD_ID, see
+     lookup_minsyms.  Unlike indices, minimal symbol tables are written
+     right away.  */
+  void store_minsyms (const bfd_build_id *build_id, bool separate_debug,
+		      gdb::array_view<const gdb_byte> contents);
+
+  /* Return the number of minimal symbol tables found in the cache.  */
+  unsigned int n_minsyms_hits () const
+  { return m_n_minsyms_hits; }
+
+  /* Return the number of minimal symbol tables not found in the
+     cache.  */
+  unsigned int n_minsyms_misses () const
+  { return m_n_minsyms_misses; }
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -87,8 +153,68 @@ class index_cache
       m_n_misses++;
   }
 
+  /* Return the number of indices queued or being written in the
+     background.  */
+  unsigned int n_pending_stores ();
+
+  /* Return the number of indices successfully written.  */
+  unsigned int n_completed_stores ();
+
+  /* Return the number of indices that could not be written.  */
+  unsigned int n_failed_stores ();
+
+  /* Return the number of index files removed from the cache directory
+     to respect the maximum size.  */
+  unsigned int n_evictions ();
+
+  /* Return the total size of the index files in the cache
+     directory.  */
+  ULONGEST disk_usage () const;
+
 private:
 
+  /* A request to write the index of an objfile in the background.  */
+  struct pending_store
+  {
+    /* The objfile whose index is to be written.  */
+    dwarf2_per_objfile *per_objfile;
+
+    /* The directory in which to write it.  */
+    std::string dir;
+
+    /* The maximum size of the directory, see set_max_size.  */
+    ULONGEST max_size;
+
+    /* The build ids of the objfile and of its dwz file, if any, used
+       as the names of the index files.  */
+    std::string build_id_str;
+    gdb::optional<std::string> dwz_build_id_str;
+
+    /* What the index writer needs of the CUs of the objfile, copied
+       when the store was queued; NULL when writing the index on the
+       main thread.  */
+    std::unique_ptr<index_write_snapshot> snapshot;
+  };
+
+  /* Write the index described by STORE, and record the result in the
+     stats.  BACKGROUND is true if this is called by a worker thread.  */
+  void do_store (const pending_store &store, bool background);
+
+  /* Remove the least recently accessed index files from DIR until
+     their total size is at most MAX_SIZE.  This may be called by a
+     worker thread.  */
+  void evict (const std::string &dir, ULONGEST max_size);
+
+  /* Write the queued indices until the queue is empty.  This is run by
+     a worker thread.  */
+  void process_pending_stores ();
+
+  /* Map the file of the cache directory named after BUILD_ID and
+     SUFFIX, for lookup_gdb_index and lookup_minsyms.  */
+  gdb::array_view<const gdb_byte>
+  lookup_file (const bfd_build_id *build_id, const char *suffix,
+	       std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -101,9 +227,51 @@ class index_cache
   /* Whether the cache is enabled.  */
   bool m_enabled = false;
 
+  /* Whether minimal symbol tables are stored in the cache.  */
+  bool m_minsyms_enabled = false;
+
+  /* The maximum size of the index files in M_DIR, or (ULONGEST) -1 if
+     there is no limit.  */
+  ULONGEST m_max_size = (ULONGEST) -1;
+
   /* Number of cache hits and misses during this GDB session.  */
   unsigned int m_n_hits = 0;
   unsigned int m_n_misses = 0;
+
+  /* Number of minimal symbol table hits and misses during this GDB
+     session.  */
+  unsigned int m_n_minsyms_hits = 0;
+  unsigned int m_n_minsyms_misses = 0;
+
+  /* Number of indices written, and that couldn't be written, during
+     this GDB session.  */
+  unsigned int m_n_completed_stores = 0;
+  unsigned int m_n_failed_stores = 0;
+
+  /* Number of index files evicted during this GDB session.  */
+  unsigned int m_n_evictions = 0;
+
+  /* The indices waiting to be written in the background.  */
+  std::deque<pending_store> m_pending_stores;
+
+  /* The objfile whose index is being written in the background, if
+     any.  */
+  dwarf2_per_objfile *m_current_store = nullptr;
+
+  /* True if a worker thread is processing M_PENDING_STORES.  */
+  bool m_store_task_running = false;
+
+#if CXX_STD_THREAD
+  /* Mutex protecting the fields above, which are updated by the worker
+     thread that writes the indices, and the condition variable used to
+     wait for it.  */
+  std::mutex m_store_mutex;
+  std::condition_variable m_store_cv;
+
+  /* Mutex ensuring that only one thread of this GDB evicts files at a
+     time.  Other GDB processes are kept out by a lock file.  */
+  std::mutex m_evict_mutex;
+#endif
 };
 
 /* The global instance of the index cache.  */
@@ -26,6 +26,7 @@
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/parallel-for.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
 #include "complaints.h"
@@ -44,7 +45,6 @@
 #include <forward_list>
 #include <set>
 #include <unordered_map>
-#include <unordered_set>
 
 /* Ensure only legit values are used.  */
 #define DW2_GDB_INDEX_SYMBOL_STATIC_SET_VALUE(cu_index, value) \
@@ -133,6 +133,13 @@ class data_buf
     ::store_unsigned_integer (grow (len), len, byte_order, val);
   }
 
+  /* Make room for at least SIZE bytes in the buffer without
+     reallocating.  */
+  void reserve (size_t size)
+  {
+    m_vec.reserve (size);
+  }
+
   /* Return the size of the buffer.  */
   size_t size () const
   {
@@ -168,6 +175,8 @@ struct symtab_index_entry
 {
   /* The name of the symbol.  */
   const char *name;
+  /* The hash of NAME, as computed by mapped_index_string_hash.  */
+  offset_type hash;
   /* The offset of the name in the constant pool.  */
   offset_type index_offset;
   /* A sorted vector of the indices of all the CUs that hold an object
@@ -190,16 +199,24 @@ struct mapped_symtab
   auto_obstack m_string_obstack;
 };
 
-/* Find a slot in SYMTAB for the symbol NAME.  Returns a reference to
-   the slot.
+/* Return the hash of NAME used in the symbol table.
 
    Function is used only during write_hash_table so no index format backward
    compatibility is needed.  */
 
+static offset_type
+symtab_name_hash (const char *name)
+{
+  return mapped_index_string_hash (INT_MAX, name);
+}
+
+/* Find a slot in SYMTAB for the symbol NAME, whose hash is HASH.
+   Returns a reference to the slot.  */
+
 static symtab_index_entry &
-find_slot (struct mapped_symtab *symtab, const char *name)
+find_slot (struct mapped_symtab *symtab, const char *name, offset_type hash)
 {
-  offset_type index, step, hash = mapped_index_string_hash (INT_MAX, name);
+  offset_type index, step;
 
   index = hash & (symtab->data.size () - 1);
   step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
@@ -213,6 +230,23 @@ find_slot (struct mapped_symtab *symtab, const char *name)
     }
 }
 
+/* Find the first empty slot in SYMTAB on the probe sequence of HASH.
+   Returns a reference to the slot.  */
+
+static symtab_index_entry &
+find_empty_slot (struct mapped_symtab *symtab, offset_type hash)
+{
+  offset_type index, step;
+
+  index = hash & (symtab->data.size () - 1);
+  step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
+
+  while (symtab->data[index].name != NULL)
+    index = (index + step) & (symtab->data.size () - 1);
+
+  return symtab->data[index];
+}
+
 /* Expand SYMTAB's hash table.  */
 
 static void
@@ -223,21 +257,25 @@ hash_expand (struct mapped_symtab *symtab)
   symtab->data.clear ();
   symtab->data.resize (old_entries.size () * 2);
 
+  /* The names in the table are all distinct, so there is no need to
+     compare them; each entry goes in the first empty slot of its
+     probe sequence, exactly where find_slot would put it.  */
   for (auto &it : old_entries)
     if (it.name != NULL)
       {
-	auto &ref = find_slot (symtab, it.name);
+	auto &ref = find_empty_slot (symtab, it.hash);
 	ref = std::move (it);
       }
 }
 
-/* Add an entry to SYMTAB.  NAME is the name of the symbol.
+/* Add an entry to SYMTAB.  NAME is the name of the symbol and HASH
+   its hash, as computed by symtab_name_hash.
    CU_INDEX is the index of the CU in which the symbol appears.
    IS_STATIC is one if the symbol is static, otherwise zero (global).  */
 
 static void
 add_index_entry (struct mapped_symtab *symtab, const char *name,
-		 int is_static, gdb_index_symbol_kind kind,
+		 offset_type hash, int is_static, gdb_index_symbol_kind kind,
 		 offset_type cu_index)
 {
   offset_type cu_index_and_attrs;
@@ -246,10 +284,11 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   if (4 * symtab->n_elements / 3 >= symtab->data.size ())
     hash_expand (symtab);
 
-  symtab_index_entry &slot = find_slot (symtab, name);
+  symtab_index_entry &slot = find_slot (symtab, name, hash);
   if (slot.name == NULL)
     {
       slot.name = name;
+      slot.hash = hash;
       /* index_offset is set later.  */
     }
 
@@ -268,21 +307,36 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   slot.cu_indices.push_back (cu_index_and_attrs);
 }
 
-/* Sort and remove duplicates of all symbols' cu_indices lists.  */
+/* Sort and remove duplicates of all symbols' cu_indices lists.  Each
+   entry is independent of the others, so this is done in parallel if
+   PARALLEL is true.  */
 
 static void
-uniquify_cu_indices (struct mapped_symtab *symtab)
+uniquify_cu_indices (struct mapped_symtab *symtab, bool parallel)
 {
-  for (auto &entry : symtab->data)
+  typedef std::vector<symtab_index_entry>::iterator iter_type;
+
+  auto uniquify = [] (iter_type first, iter_type last)
     {
-      if (entry.name != NULL && !entry.cu_indices.empty ())
+      for (; first != last; ++first)
 	{
-	  auto &cu_indices = entry.cu_indices;
-	  std::sort (cu_indices.begin (), cu_indices.end ());
-	  auto from = std::unique (cu_indices.begin (), cu_indices.end ());
-	  cu_indices.erase (from, cu_indices.end ());
+	  symtab_index_entry &entry = *first;
+
+	  if (entry.name != NULL && !entry.cu_indices.empty ())
+	    {
+	      auto &cu_indices = entry.cu_indices;
+	      std::sort (cu_indices.begin (), cu_indices.end ());
+	      auto from = std::unique (cu_indices.begin (), cu_indices.end ());
+	      cu_indices.erase (from, cu_indices.end ());
+	    }
 	}
-    }
+    };
+
+  if (parallel)
+    gdb::parallel_for_each (symtab->data.begin (), symtab->data.end (),
+			    uniquify);
+  else
+    uniquify (symtab->data.begin (), symtab->data.end ());
 }
 
 /* A form of 'const char *' suitable for container keys.  Only the
@@ -341,6 +395,9 @@ class vector_hasher
 static void
 write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
 {
+  /* Each slot is a pair of offsets.  */
+  output.reserve (symtab->data.size () * 2 * sizeof (offset_type));
+
   {
     /* Elements are sorted vectors of the indices of all the CUs that
        hold an object of this name.  */
@@ -496,13 +553,13 @@ write_address_map (struct objfile *objfile, data_buf &addr_vec,
 		       addrmap_index_data.previous_cu_index);
 }
 
-/* Return the symbol kind of PSYM.  */
+/* Return the symbol kind of symbol PSYM of POOL.  */
 
 static gdb_index_symbol_kind
-symbol_kind (struct partial_symbol *psym)
+symbol_kind (const psymbol_pool &pool, psymbol_index psym)
 {
-  domain_enum domain = psym->domain;
-  enum address_class aclass = psym->aclass;
+  domain_enum domain = pool.domain (psym);
+  enum address_class aclass = pool.aclass (psym);
 
   switch (domain)
     {
@@ -534,97 +591,190 @@ symbol_kind (struct partial_symbol *psym)
     }
 }
 
+/* Mark PSYM in PSYMS_SEEN, which is indexed by psymbol_index.  Return
+   true if it was not marked already.  */
+
+static bool
+mark_psymbol_seen (std::vector<bool> &psyms_seen, psymbol_index psym)
+{
+  if (psyms_seen[psym])
+    return false;
+  psyms_seen[psym] = true;
+  return true;
+}
+
+/* Add the partial symbol PSYM of POOL to SYMTAB.  */
+
+static void
+write_psymbol (struct mapped_symtab *symtab,
+	       const psymbol_pool &pool,
+	       std::vector<bool> &psyms_seen,
+	       psymbol_index psym,
+	       offset_type cu_index,
+	       int is_static)
+{
+  const char *name = pool.search_name (psym);
+
+  if (pool.language (psym) == language_ada)
+    {
+      /* We want to ensure that the Ada main function's name appears
+	 verbatim in the index.  However, this name will be of the
+	 form "_ada_mumble", and will be rewritten by ada_decode.
+	 So, recognize it specially here and add it to the index by
+	 hand.  */
+      if (strcmp (main_name (), name) == 0)
+	{
+	  gdb_index_symbol_kind kind = symbol_kind (pool, psym);
+
+	  add_index_entry (symtab, name, symtab_name_hash (name),
+			   is_static, kind, cu_index);
+	}
+
+      /* In order for the index to work when read back into gdb, it
+	 has to supply a funny form of the name: it should be the
+	 encoded name, with any suffixes stripped.  Using the
+	 ordinary encoded name will not work properly with the
+	 searching logic in find_name_components_bounds; nor will
+	 using the decoded name.  Furthermore, an Ada "verbatim"
+	 name (of the form "<MumBle>") must be entered without the
+	 angle brackets.  Note that the current index is unusual,
+	 see PR symtab/24820 for details.  */
+      std::string decoded = ada_decode (name);
+      if (decoded[0] == '<')
+	name = (char *) obstack_copy0 (&symtab->m_string_obstack,
+				       decoded.c_str () + 1,
+				       decoded.length () - 2);
+      else
+	name = obstack_strdup (&symtab->m_string_obstack,
+			       ada_encode (decoded.c_str ()));
+    }
+
+  /* Only add a given psymbol once.  */
+  if (mark_psymbol_seen (psyms_seen, psym))
+    {
+      gdb_index_symbol_kind kind = symbol_kind (pool, psym);
+
+      add_index_entry (symtab, name, symtab_name_hash (name),
+		       is_static, kind, cu_index);
+    }
+}
+
 /* Add a list of partial symbols to SYMTAB.  */
 
 static void
 write_psymbols (struct mapped_symtab *symtab,
-		std::unordered_set<partial_symbol *> &psyms_seen,
-		struct partial_symbol **psymp,
+		const psymbol_pool &pool,
+		std::vector<bool> &psyms_seen,
+		const psymbol_index *psymp,
 		int count,
 		offset_type cu_index,
 		int is_static)
 {
   for (; count-- > 0; ++psymp)
-    {
-      struct partial_symbol *psym = *psymp;
-      const char *name = psym->ginfo.search_name ();
+    write_psymbol (symtab, pool, psyms_seen, *psymp, cu_index, is_static);
+}
 
-      if (psym->ginfo.language () == language_ada)
-	{
-	  /* We want to ensure that the Ada main function's name appears
-	     verbatim in the index.  However, this name will be of the
-	     form "_ada_mumble", and will be rewritten by ada_decode.
-	     So, recognize it specially here and add it to the index by
-	     hand.  */
-	  if (strcmp (main_name (), name) == 0)
-	    {
-	      gdb_index_symbol_kind kind = symbol_kind (psym);
+/* A partial symbol that write_psymbol is going to add to the symbol
+   table.  These are collected ahead of time, possibly on a worker
+   thread, so that the name, hash and kind of the symbol do not have to
+   be computed while the symbol table is being filled in.  */
 
-	      add_index_entry (symtab, name, is_static, kind, cu_index);
-	    }
+struct pending_psymbol
+{
+  /* The partial symbol.  */
+  psymbol_index psym;
+  /* The name of the symbol, or NULL if the symbol must be handed to
+     write_psymbol as is.  This is the case for Ada symbols, whose
+     names are rewritten using functions that are not thread-safe.  */
+  const char *name;
+  /* The hash of NAME.  */
+  offset_type hash;
+  /* The kind of the symbol.  */
+  gdb_index_symbol_kind kind;
+  /* True if the symbol is static.  */
+  bool is_static;
+};
 
-	  /* In order for the index to work when read back into gdb, it
-	     has to supply a funny form of the name: it should be the
-	     encoded name, with any suffixes stripped.  Using the
-	     ordinary encoded name will not work properly with the
-	     searching logic in find_name_components_bounds; nor will
-	     using the decoded name.  Furthermore, an Ada "verbatim"
-	     name (of the form "<MumBle>") must be entered without the
-	     angle brackets.  Note that the current index is unusual,
-	     see PR symtab/24820 for details.  */
-	  std::string decoded = ada_decode (name);
-	  if (decoded[0] == '<')
-	    name = (char *) obstack_copy0 (&symtab->m_string_obstack,
-					   decoded.c_str () + 1,
-					   decoded.length () - 2);
-	  else
-	    name = obstack_strdup (&symtab->m_string_obstack,
-				   ada_encode (decoded.c_str ()));
-	}
+/* Append to PENDING the partial symbols of POOL in the COUNT symbols
+   at PSYMP.  IS_STATIC is true if they are static symbols.  This only
+   reads the symbols, so is safe to call from a worker thread.  */
 
-      /* Only add a given psymbol once.  */
-      if (psyms_seen.insert (psym).second)
+static void
+collect_psymbols (const psymbol_pool &pool,
+		  std::vector<pending_psymbol> &pending,
+		  const psymbol_index *psymp, int count, bool is_static)
+{
+  for (; count-- > 0; ++psymp)
+    {
+      psymbol_index psym = *psymp;
+
+      if (pool.language (psym) == language_ada)
+	pending.push_back ({ psym, nullptr, 0, GDB_INDEX_SYMBOL_KIND_NONE,
+			     is_static });
+      else
 	{
-	  gdb_index_symbol_kind kind = symbol_kind (psym);
+	  const char *name = pool.search_name (psym);
 
-	  add_index_entry (symtab, name, is_static, kind, cu_index);
+	  pending.push_back ({ psym, name, symtab_name_hash (name),
+			       symbol_kind (pool, psym), is_static });
 	}
     }
 }
 
+/* Add the partial symbols in PENDING, collected by collect_psymbols,
+   to SYMTAB.  */
+
+static void
+write_pending_psymbols (struct mapped_symtab *symtab,
+			const psymbol_pool &pool,
+			std::vector<bool> &psyms_seen,
+			const std::vector<pending_psymbol> &pending,
+			offset_type cu_index)
+{
+  for (const pending_psymbol &p : pending)
+    {
+      if (p.name == nullptr)
+	write_psymbol (symtab, pool, psyms_seen, p.psym, cu_index,
+		       p.is_static);
+      /* Only add a given psymbol once.  */
+      else if (mark_psymbol_seen (psyms_seen, p.psym))
+	add_index_entry (symtab, p.name, p.hash, p.is_static, p.kind,
+			 cu_index);
+    }
+}
+
 /* A helper struct used when iterating over debug_types.  */
 struct signatured_type_index_data
 {
   signatured_type_index_data (data_buf &types_list_,
-                              std::unordered_set<partial_symbol *> &psyms_seen_)
+                              std::vector<bool> &psyms_seen_)
     : types_list (types_list_), psyms_seen (psyms_seen_)
   {}
 
   struct objfile *objfile;
   struct mapped_symtab *symtab;
   data_buf &types_list;
-  std::unordered_set<partial_symbol *> &psyms_seen;
+  std::vector<bool> &psyms_seen;
   int cu_index;
 };
 
-/* A helper function that writes a single signatured_type to an
+/* A helper function that writes a single type unit, ENTRY, to an
    obstack.  */
 
-static int
-write_one_signatured_type (void **slot, void *d)
+static void
+write_one_signatured_type (const index_write_snapshot::type_unit &entry,
+			   signatured_type_index_data *info)
 {
-  struct signatured_type_index_data *info
-    = (struct signatured_type_index_data *) d;
-  struct signatured_type *entry = (struct signatured_type *) *slot;
-  partial_symtab *psymtab = entry->per_cu.v.psymtab;
+  partial_symtab *psymtab = entry.psymtab;
+  const psymbol_pool &pool = info->objfile->partial_symtabs->psymbols;
 
-  write_psymbols (info->symtab,
+  write_psymbols (info->symtab, pool,
 		  info->psyms_seen,
 		  (info->objfile->partial_symtabs->global_psymbols.data ()
 		   + psymtab->globals_offset),
 		  psymtab->n_global_syms, info->cu_index,
 		  0);
-  write_psymbols (info->symtab,
+  write_psymbols (info->symtab, pool,
 		  info->psyms_seen,
 		  (info->objfile->partial_symtabs->static_psymbols.data ()
 		   + psymtab->statics_offset),
@@ -632,62 +782,102 @@ write_one_signatured_type (void **slot, void *d)
 		  1);
 
   info->types_list.append_uint (8, BFD_ENDIAN_LITTLE,
-				to_underlying (entry->per_cu.sect_off));
+				to_underlying (entry.sect_off));
   info->types_list.append_uint (8, BFD_ENDIAN_LITTLE,
-				to_underlying (entry->type_offset_in_tu));
-  info->types_list.append_uint (8, BFD_ENDIAN_LITTLE, entry->signature);
+				to_underlying (entry.type_offset_in_tu));
+  info->types_list.append_uint (8, BFD_ENDIAN_LITTLE, entry.signature);
 
   ++info->cu_index;
-
-  return 1;
 }
 
-/* Recurse into all "included" dependencies and count their symbols as
-   if they appeared in this psymtab.  */
+/* Recurse into all "included" dependencies and collect their symbols
+   as if they appeared in this psymtab.  */
 
 static void
-recursively_count_psymbols (partial_symtab *psymtab,
-			    size_t &psyms_seen)
+recursively_collect_psymbols (struct objfile *objfile,
+			      partial_symtab *psymtab,
+			      std::vector<pending_psymbol> &pending)
 {
-  for (int i = 0; i < psymtab->number_of_dependencies; ++i)
+  int i;
+
+  for (i = 0; i < psymtab->number_of_dependencies; ++i)
     if (psymtab->dependencies[i]->user != NULL)
-      recursively_count_psymbols (psymtab->dependencies[i],
-				  psyms_seen);
+      recursively_collect_psymbols (objfile, psymtab->dependencies[i],
+				    pending);
+
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
 
-  psyms_seen += psymtab->n_global_syms;
-  psyms_seen += psymtab->n_static_syms;
+  collect_psymbols (pool, pending,
+		    (objfile->partial_symtabs->global_psymbols.data ()
+		     + psymtab->globals_offset),
+		    psymtab->n_global_syms, false);
+  collect_psymbols (pool, pending,
+		    (objfile->partial_symtabs->static_psymbols.data ()
+		     + psymtab->statics_offset),
+		    psymtab->n_static_syms, true);
 }
 
-/* Recurse into all "included" dependencies and write their symbols as
-   if they appeared in this psymtab.  */
+/* The number of CUs whose partial symbols each thread collects at a
+   time in write_cu_psymbols.  This bounds the memory used to hold the
+   collected symbols.  */
+
+static const size_t index_write_units_per_thread = 64;
+
+/* Add the partial symbols of ALL_CUS, all the CUs of OBJFILE, to
+   SYMTAB.
+
+   If PARALLEL is true, the symbols of a batch of CUs are collected in
+   parallel, then added to SYMTAB in CU order, so that the resulting
+   table is the same as if the CUs were processed one at a time.  */
 
 static void
-recursively_write_psymbols (struct objfile *objfile,
-			    partial_symtab *psymtab,
-			    struct mapped_symtab *symtab,
-			    std::unordered_set<partial_symbol *> &psyms_seen,
-			    offset_type cu_index)
+write_cu_psymbols (struct objfile *objfile,
+		   const std::vector<index_write_snapshot::comp_unit> &all_cus,
+		   struct mapped_symtab *symtab,
+		   std::vector<bool> &psyms_seen,
+		   bool parallel)
 {
-  int i;
+  size_t n_threads = 1;
+#if CXX_STD_THREAD
+  if (parallel)
+    n_threads = std::max (gdb::thread_pool::g_thread_pool->thread_count (),
+			  (size_t) 1);
+#endif
+  const size_t batch_size = n_threads * index_write_units_per_thread;
+
+  std::vector<std::vector<pending_psymbol>> pending;
+  for (size_t start = 0; start < all_cus.size (); start += batch_size)
+    {
+      size_t end = std::min (start + batch_size, all_cus.size ());
 
-  for (i = 0; i < psymtab->number_of_dependencies; ++i)
-    if (psymtab->dependencies[i]->user != NULL)
-      recursively_write_psymbols (objfile,
-				  psymtab->dependencies[i],
-				  symtab, psyms_seen, cu_index);
+      pending.clear ();
+      pending.resize (end - start);
 
-  write_psymbols (symtab,
-		  psyms_seen,
-		  (objfile->partial_symtabs->global_psymbols.data ()
-		   + psymtab->globals_offset),
-		  psymtab->n_global_syms, cu_index,
-		  0);
-  write_psymbols (symtab,
-		  psyms_seen,
-		  (objfile->partial_symtabs->static_psymbols.data ()
-		   + psymtab->statics_offset),
-		  psymtab->n_static_syms, cu_index,
-		  1);
+      typedef std::vector<index_write_snapshot::comp_unit>::const_iterator
+	iter_type;
+      auto collect = [&] (iter_type first, iter_type last)
+	{
+	  for (; first != last; ++first)
+	    {
+	      partial_symtab *psymtab = first->psymtab;
+
+	      if (psymtab != NULL && psymtab->user == NULL)
+		recursively_collect_psymbols
+		  (objfile, psymtab,
+		   pending[first - all_cus.begin () - start]);
+	    }
+	};
+
+      if (parallel)
+	gdb::parallel_for_each (all_cus.begin () + start,
+				all_cus.begin () + end, collect);
+      else
+	collect (all_cus.begin () + start, all_cus.begin () + end);
+
+      for (size_t i = start; i < end; ++i)
+	write_pending_psymbols (symtab, objfile->partial_symtabs->psymbols,
+				psyms_seen, pending[i - start], i);
+    }
 }
 
 /* DWARF-5 .debug_names builder.  */
@@ -716,16 +906,16 @@ class debug_names
   /* Is this symbol from DW_TAG_compile_unit or DW_TAG_type_unit?  */
   enum class unit_kind { cu, tu };
 
-  /* Insert one symbol.  */
-  void insert (const partial_symbol *psym, int cu_index, bool is_static,
-	       unit_kind kind)
+  /* Insert symbol PSYM of POOL.  */
+  void insert (const psymbol_pool &pool, psymbol_index psym, int cu_index,
+	       bool is_static, unit_kind kind)
   {
-    const int dwarf_tag = psymbol_tag (psym);
+    const int dwarf_tag = psymbol_tag (pool, psym);
     if (dwarf_tag == 0)
       return;
-    const char *name = psym->ginfo.search_name ();
+    const char *name = pool.search_name (psym);
 
-    if (psym->ginfo.language () == language_ada)
+    if (pool.language (psym) == language_ada)
       {
 	/* We want to ensure that the Ada main function's name appears
 	   verbatim in the index.  However, this name will be of the
@@ -904,7 +1094,7 @@ class debug_names
   void recursively_write_psymbols
     (struct objfile *objfile,
      partial_symtab *psymtab,
-     std::unordered_set<partial_symbol *> &psyms_seen,
+     std::vector<bool> &psyms_seen,
      int cu_index)
   {
     for (int i = 0; i < psymtab->number_of_dependencies; ++i)
@@ -912,11 +1102,13 @@ class debug_names
 	recursively_write_psymbols
 	  (objfile, psymtab->dependencies[i], psyms_seen, cu_index);
 
-    write_psymbols (psyms_seen,
+    const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+
+    write_psymbols (pool, psyms_seen,
 		    (objfile->partial_symtabs->global_psymbols.data ()
 		     + psymtab->globals_offset),
 		    psymtab->n_global_syms, cu_index, false, unit_kind::cu);
-    write_psymbols (psyms_seen,
+    write_psymbols (pool, psyms_seen,
 		    (objfile->partial_symtabs->static_psymbols.data ()
 		     + psymtab->statics_offset),
 		    psymtab->n_static_syms, cu_index, true, unit_kind::cu);
@@ -1209,13 +1401,13 @@ class debug_names
     offset_vec_tmpl<OffsetSize> m_name_table_entry_offs;
   };
 
-  /* Try to reconstruct original DWARF tag for given partial_symbol.
+  /* Try to reconstruct original DWARF tag for symbol PSYM of POOL.
      This function is not DWARF-5 compliant but it is sufficient for
      GDB as a DWARF-5 index consumer.  */
-  static int psymbol_tag (const struct partial_symbol *psym)
+  static int psymbol_tag (const psymbol_pool &pool, psymbol_index psym)
   {
-    domain_enum domain = psym->domain;
-    enum address_class aclass = psym->aclass;
+    domain_enum domain = pool.domain (psym);
+    enum address_class aclass = pool.aclass (psym);
 
     switch (domain)
       {
@@ -1250,17 +1442,18 @@ class debug_names
   }
 
   /* Call insert for all partial symbols and mark them in PSYMS_SEEN.  */
-  void write_psymbols (std::unordered_set<partial_symbol *> &psyms_seen,
-		       struct partial_symbol **psymp, int count, int cu_index,
+  void write_psymbols (const psymbol_pool &pool,
+		       std::vector<bool> &psyms_seen,
+		       const psymbol_index *psymp, int count, int cu_index,
 		       bool is_static, unit_kind kind)
   {
     for (; count-- > 0; ++psymp)
       {
-	struct partial_symbol *psym = *psymp;
+	psymbol_index psym = *psymp;
 
 	/* Only add a given psymbol once.  */
-	if (psyms_seen.insert (psym).second)
-	  insert (psym, cu_index, is_static, kind);
+	if (mark_psymbol_seen (psyms_seen, psym))
+	  insert (pool, psym, cu_index, is_static, kind);
       }
   }
 
@@ -1271,13 +1464,14 @@ class debug_names
 			     struct signatured_type_index_data *info)
   {
     partial_symtab *psymtab = entry->per_cu.v.psymtab;
+    const psymbol_pool &pool = info->objfile->partial_symtabs->psymbols;
 
-    write_psymbols (info->psyms_seen,
+    write_psymbols (pool, info->psyms_seen,
 		    (info->objfile->partial_symtabs->global_psymbols.data ()
 		     + psymtab->globals_offset),
 		    psymtab->n_global_syms, info->cu_index, false,
 		    unit_kind::tu);
-    write_psymbols (info->psyms_seen,
+    write_psymbols (pool, info->psyms_seen,
 		    (info->objfile->partial_symtabs->static_psymbols.data ()
 		     + psymtab->statics_offset),
 		    psymtab->n_static_syms, info->cu_index, true,
@@ -1344,28 +1538,6 @@ check_dwarf64_offsets (dwarf2_per_objfile *per_objfile)
   return false;
 }
 
-/* The psyms_seen set is potentially going to be largish (~40k
-   elements when indexing a -g3 build of GDB itself).  Estimate the
-   number of elements in order to avoid too many rehashes, which
-   require rebuilding buckets and thus many trips to
-   malloc/free.  */
-
-static size_t
-psyms_seen_size (dwarf2_per_objfile *per_objfile)
-{
-  size_t psyms_count = 0;
-  for (dwarf2_per_cu_data *per_cu : per_objfile->per_bfd->all_comp_units)
-    {
-      partial_symtab *psymtab = per_cu->v.psymtab;
-
-      if (psymtab != NULL && psymtab->user == NULL)
-	recursively_count_psymbols (psymtab, psyms_count);
-    }
-  /* Generating an index for gdb itself shows a ratio of
-     TOTAL_SEEN_SYMS/UNIQUE_SYMS or ~5.  4 seems like a good bet.  */
-  return psyms_count / 4;
-}
-
 /* Assert that FILE's size is EXPECTED_SIZE.  Assumes file's seek
    position is at the end of the file.  */
 
@@ -1431,11 +1603,14 @@ write_gdbindex_1 (FILE *out_file,
 /* Write contents of a .gdb_index section for OBJFILE into OUT_FILE.
    If OBJFILE has an associated dwz file, write contents of a .gdb_index
    section for that dwz file into DWZ_OUT_FILE.  If OBJFILE does not have an
-   associated dwz file, DWZ_OUT_FILE must be NULL.  */
+   associated dwz file, DWZ_OUT_FILE must be NULL.  The CUs and type
+   units are taken from SNAPSHOT.  If PARALLEL is true, work is spread
+   over the worker threads.  */
 
 static void
 write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
-		FILE *dwz_out_file)
+		FILE *dwz_out_file, const index_write_snapshot &snapshot,
+		bool parallel)
 {
   struct objfile *objfile = per_objfile->objfile;
   mapped_symtab symtab;
@@ -1447,25 +1622,24 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
      in the index file).  This will later be needed to write the address
      table.  */
   psym_index_map cu_index_htab;
-  cu_index_htab.reserve (per_objfile->per_bfd->all_comp_units.size ());
+  cu_index_htab.reserve (snapshot.comp_units.size ());
 
   /* The CU list is already sorted, so we don't need to do additional
      work here.  Also, the debug_types entries do not appear in
      all_comp_units, but only in their own hash table.  */
 
-  std::unordered_set<partial_symbol *> psyms_seen
-    (psyms_seen_size (per_objfile));
-  for (int i = 0; i < per_objfile->per_bfd->all_comp_units.size (); ++i)
+  std::vector<bool> psyms_seen (objfile->partial_symtabs->psymbols.size ());
+  write_cu_psymbols (objfile, snapshot.comp_units, &symtab, psyms_seen,
+		     parallel);
+
+  objfile_cu_list.reserve (snapshot.comp_units.size () * 16);
+  for (int i = 0; i < snapshot.comp_units.size (); ++i)
     {
-      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->all_comp_units[i];
-      partial_symtab *psymtab = per_cu->v.psymtab;
+      const index_write_snapshot::comp_unit &cu = snapshot.comp_units[i];
+      partial_symtab *psymtab = cu.psymtab;
 
       if (psymtab != NULL)
 	{
-	  if (psymtab->user == NULL)
-	    recursively_write_psymbols (objfile, psymtab, &symtab,
-					psyms_seen, i);
-
 	  const auto insertpair = cu_index_htab.emplace (psymtab, i);
 	  gdb_assert (insertpair.second);
 	}
@@ -1473,10 +1647,9 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
       /* The all_comp_units list contains CUs read from the objfile as well as
 	 from the eventual dwz file.  We need to place the entry in the
 	 corresponding index.  */
-      data_buf &cu_list = per_cu->is_dwz ? dwz_cu_list : objfile_cu_list;
-      cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			   to_underlying (per_cu->sect_off));
-      cu_list.append_uint (8, BFD_ENDIAN_LITTLE, per_cu->length);
+      data_buf &cu_list = cu.is_dwz ? dwz_cu_list : objfile_cu_list;
+      cu_list.append_uint (8, BFD_ENDIAN_LITTLE, to_underlying (cu.sect_off));
+      cu_list.append_uint (8, BFD_ENDIAN_LITTLE, cu.length);
     }
 
   /* Dump the address map.  */
@@ -1485,21 +1658,17 @@ write_gdbindex (dwarf2_per_objfile *per_objfile, FILE *out_file,
 
   /* Write out the .debug_type entries, if any.  */
   data_buf types_cu_list;
-  if (per_objfile->per_bfd->signatured_types)
-    {
-      signatured_type_index_data sig_data (types_cu_list,
-					   psyms_seen);
+  signatured_type_index_data sig_data (types_cu_list, psyms_seen);
 
-      sig_data.objfile = objfile;
-      sig_data.symtab = &symtab;
-      sig_data.cu_index = per_objfile->per_bfd->all_comp_units.size ();
-      htab_traverse_noresize (per_objfile->per_bfd->signatured_types.get (),
-			      write_one_signatured_type, &sig_data);
-    }
+  sig_data.objfile = objfile;
+  sig_data.symtab = &symtab;
+  sig_data.cu_index = snapshot.comp_units.size ();
+  for (const index_write_snapshot::type_unit &tu : snapshot.type_units)
+    write_one_signatured_type (tu, &sig_data);
 
   /* Now that we've processed all symbols we can shrink their cu_indices
      lists.  */
-  uniquify_cu_indices (&symtab);
+  uniquify_cu_indices (&symtab, parallel);
 
   data_buf symtab_vec, constant_pool;
   write_hash_table (&symtab, symtab_vec, constant_pool);
@@ -1534,8 +1703,7 @@ write_debug_names (dwarf2_per_objfile *per_objfile,
      all_comp_units, but only in their own hash table.  */
   data_buf cu_list;
   debug_names nametable (per_objfile, dwarf5_is_dwarf64, dwarf5_byte_order);
-  std::unordered_set<partial_symbol *>
-    psyms_seen (psyms_seen_size (per_objfile));
+  std::vector<bool> psyms_seen (objfile->partial_symtabs->psymbols.size ());
   for (int i = 0; i < per_objfile->per_bfd->all_comp_units.size (); ++i)
     {
       const dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->all_comp_units[i];
@@ -1702,7 +1870,8 @@ struct index_wip_file
 void
 write_psymtabs_to_index (dwarf2_per_objfile *per_objfile, const char *dir,
 			 const char *basename, const char *dwz_basename,
-			 dw_index_kind index_kind)
+			 dw_index_kind index_kind,
+			 const index_write_snapshot *snapshot)
 {
   struct objfile *objfile = per_objfile->objfile;
 
@@ -1739,9 +1908,18 @@ write_psymtabs_to_index (dwarf2_per_objfile *per_objfile, const char *dir,
       str_wip_file.finalize ();
     }
   else
-    write_gdbindex (per_objfile, objfile_index_wip.out_file.get (),
-		    (dwz_index_wip.has_value ()
-		     ? dwz_index_wip->out_file.get () : NULL));
+    {
+      /* On the main thread, copy the CUs now and use the worker
+	 threads.  */
+      gdb::optional<index_write_snapshot> local_snapshot;
+      if (snapshot == NULL)
+	snapshot = &local_snapshot.emplace (per_objfile);
+
+      write_gdbindex (per_objfile, objfile_index_wip.out_file.get (),
+		      (dwz_index_wip.has_value ()
+		       ? dwz_index_wip->out_file.get () : NULL),
+		      *snapshot, local_snapshot.has_value ());
+    }
 
   objfile_index_wip.finalize ();
 
@@ -1749,6 +1927,36 @@ write_psymtabs_to_index (dwarf2_per_objfile *per_objfile, const char *dir,
     dwz_index_wip->finalize ();
 }
 
+/* A helper function for htab_traverse_noresize that adds the
+   signatured_type in SLOT to the vector of type units D.  */
+
+static int
+add_type_unit_to_snapshot (void **slot, void *d)
+{
+  signatured_type *entry = (signatured_type *) *slot;
+  auto units = (std::vector<index_write_snapshot::type_unit> *) d;
+
+  units->push_back ({ entry->per_cu.v.psymtab, entry->per_cu.sect_off,
+		      entry->type_offset_in_tu, entry->signature });
+  return 1;
+}
+
+/* See dwarf-index-write.h.  */
+
+index_write_snapshot::index_write_snapshot (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  comp_units.reserve (per_bfd->all_comp_units.size ());
+  for (dwarf2_per_cu_data *per_cu : per_bfd->all_comp_units)
+    comp_units.push_back ({ per_cu->v.psymtab, per_cu->sect_off,
+			    per_cu->length, (bool) per_cu->is_dwz });
+
+  if (per_bfd->signatured_types != nullptr)
+    htab_traverse_noresize (per_bfd->signatured_types.get (),
+			    add_type_unit_to_snapshot, &type_units);
+}
+
 /* Implementation of the `save gdb-index' command.
 
    Note that the .gdb_index file format used by this command is
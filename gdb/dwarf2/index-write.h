@@ -23,6 +23,43 @@
 #include "symfile.h"
 #include "dwarf2/read.h"
 
+/* What write_psymtabs_to_index reads of the CUs and type units of an
+   objfile, copied by the main thread.  Reading the CUs, which the main
+   thread may do while a worker thread writes the index, changes some
+   of these fields, and others share their word with bit-fields that
+   it sets.  */
+
+struct index_write_snapshot
+{
+  explicit index_write_snapshot (dwarf2_per_objfile *per_objfile);
+
+  /* A CU of all_comp_units.  */
+  struct comp_unit
+  {
+    partial_symtab *psymtab;
+    sect_offset sect_off;
+    unsigned int length;
+
+    /* Whether the CU comes from the dwz file.  */
+    bool is_dwz;
+  };
+
+  /* A type unit of signatured_types.  */
+  struct type_unit
+  {
+    partial_symtab *psymtab;
+    sect_offset sect_off;
+    cu_offset type_offset_in_tu;
+    ULONGEST signature;
+  };
+
+  /* The CUs, in the order of all_comp_units.  */
+  std::vector<comp_unit> comp_units;
+
+  /* The type units, in the order of a traversal of signatured_types.  */
+  std::vector<type_unit> type_units;
+};
+
 /* Create index files for OBJFILE in the directory DIR.
 
    An index file is created for OBJFILE itself, and is created for its
@@ -30,10 +67,16 @@
 
    BASENAME is the desired filename base for OBJFILE's index.  An extension
    derived from INDEX_KIND is added to this base name.  DWZ_BASENAME is the
-   same, but for the dwz file's index.  */
+   same, but for the dwz file's index.
+
+   SNAPSHOT is NULL when called by the main thread.  Otherwise, this is
+   called by a worker thread, which takes the data of the CUs and type
+   units from SNAPSHOT, and does all the work itself rather than wait
+   for other worker threads.  */
 
 extern void write_psymtabs_to_index
   (dwarf2_per_objfile *per_objfile, const char *dir, const char *basename,
-   const char *dwz_basename, dw_index_kind index_kind);
+   const char *dwz_basename, dw_index_kind index_kind,
+   const index_write_snapshot *snapshot = nullptr);
 
 #endif /* DWARF_INDEX_WRITE_H */
@@ -27,57 +27,62 @@
 #include "defs.h"
 #include "dwarf2/leb.h"
 
+/* See leb.h.  */
+
 ULONGEST
-read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
-			  unsigned int *bytes_read_ptr)
+read_unsigned_leb128_multi (const gdb_byte *buf,
+			    unsigned int *bytes_read_ptr)
 {
-  ULONGEST result;
-  unsigned int num_read;
-  int shift;
-  unsigned char byte;
-
-  result = 0;
-  shift = 0;
-  num_read = 0;
-  while (1)
+  ULONGEST result = buf[0] & 0x7f;
+
+  /* Two-byte values are the next most common ones; DIE offsets,
+     line numbers and small sizes.  */
+  if ((buf[1] & 0x80) == 0)
+    {
+      *bytes_read_ptr = 2;
+      return result | ((ULONGEST) buf[1] << 7);
+    }
+
+  unsigned int num_read = 1;
+  int shift = 0;
+  gdb_byte byte;
+
+  do
     {
-      byte = bfd_get_8 (abfd, buf);
-      buf++;
-      num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
-      if ((byte & 128) == 0)
-	{
-	  break;
-	}
+      byte = buf[num_read++];
       shift += 7;
+      /* Ignore the bits that do not fit in the result, like an
+	 oversized shift would on most hosts, but without the undefined
+	 behavior.  */
+      if (shift < 8 * sizeof (result))
+	result |= (ULONGEST) (byte & 0x7f) << shift;
     }
+  while ((byte & 0x80) != 0);
+
   *bytes_read_ptr = num_read;
   return result;
 }
 
+/* See leb.h.  */
+
 LONGEST
-read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
-		    unsigned int *bytes_read_ptr)
+read_signed_leb128_multi (const gdb_byte *buf,
+			  unsigned int *bytes_read_ptr)
 {
-  ULONGEST result;
-  int shift, num_read;
-  unsigned char byte;
-
-  result = 0;
-  shift = 0;
-  num_read = 0;
-  while (1)
+  ULONGEST result = buf[0] & 0x7f;
+  unsigned int num_read = 1;
+  int shift = 7;
+  gdb_byte byte;
+
+  do
     {
-      byte = bfd_get_8 (abfd, buf);
-      buf++;
-      num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
+      byte = buf[num_read++];
+      if (shift < 8 * sizeof (result))
+	result |= (ULONGEST) (byte & 0x7f) << shift;
       shift += 7;
-      if ((byte & 128) == 0)
-	{
-	  break;
-	}
     }
+  while ((byte & 0x80) != 0);
+
   if ((shift < 8 * sizeof (result)) && (byte & 0x40))
     result |= -(((ULONGEST) 1) << shift);
   *bytes_read_ptr = num_read;
@@ -27,6 +27,8 @@
 #ifndef GDB_DWARF2_LEB_H
 #define GDB_DWARF2_LEB_H
 
+#include "leb128.h"
+
 /* Read dwarf information from a buffer.  */
 
 static inline unsigned int
@@ -85,9 +87,46 @@ read_8_bytes (bfd *abfd, const gdb_byte *buf)
   return bfd_get_64 (abfd, buf);
 }
 
-extern LONGEST read_signed_leb128 (bfd *, const gdb_byte *, unsigned int *);
+/* Read a LEB128 value of more than one byte from BUF.  These are the
+   slow paths of read_signed_leb128 and read_unsigned_leb128.  */
+
+extern LONGEST read_signed_leb128_multi (const gdb_byte *,
+					 unsigned int *);
+
+extern ULONGEST read_unsigned_leb128_multi (const gdb_byte *,
+					    unsigned int *);
+
+/* Read a signed LEB128 value from BUF, and store the number of bytes
+   it used in *BYTES_READ_PTR.  Most LEB128 values in DWARF fit in a
+   single byte, this case is handled inline.  */
+
+static inline LONGEST
+read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
+		    unsigned int *bytes_read_ptr)
+{
+  gdb_byte byte = *buf;
+
+  if (!leb128_single_byte_p (byte))
+    return read_signed_leb128_multi (buf, bytes_read_ptr);
+
+  *bytes_read_ptr = 1;
+  return sleb128_single_byte_value (byte);
+}
+
+/* Likewise, for an unsigned LEB128 value.  */
+
+static inline ULONGEST
+read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
+		      unsigned int *bytes_read_ptr)
+{
+  gdb_byte byte = *buf;
 
-extern ULONGEST read_unsigned_leb128 (bfd *, const gdb_byte *, unsigned int *);
+  if (!leb128_single_byte_p (byte))
+    return read_unsigned_leb128_multi (buf, bytes_read_ptr);
+
+  *bytes_read_ptr = 1;
+  return byte;
+}
 
 /* Read the initial length from a section.  The (draft) DWARF 3
    specification allows the initial length to take up either 4 bytes
@@ -77,6 +77,7 @@
 #include "gdbsupport/gdb_optional.h"
 #include "gdbsupport/underlying.h"
 #include "gdbsupport/hash_enum.h"
+#include "gdbsupport/parallel-for.h"
 #include "filename-seen-cache.h"
 #include "producer.h"
 #include <fcntl.h>
@@ -227,16 +228,31 @@ struct mapped_index final : public mapped_index_base
   /* The address table data.  */
   gdb::array_view<const gdb_byte> address_table;
 
+  /* True once the address table has been used to populate the
+     psymtabs_addrmap.  This is done lazily, see dw2_get_addrmap.  */
+  bool address_table_read = false;
+
   /* The symbol table, implemented as a hash table.  */
   gdb::array_view<symbol_table_slot> symbol_table;
 
   /* A pointer to the constant pool.  */
   const char *constant_pool = nullptr;
 
+  /* The size of the constant pool, in bytes.  */
+  offset_type constant_pool_size = 0;
+
+  /* Return true if the name and the CU vector of BUCKET both lie
+     within the constant pool.  The index is often used directly from
+     a mapped file, so the slots are only checked when they are used,
+     rather than all at once when the index is read.  */
+  bool slot_in_bounds (const symbol_table_slot &bucket) const;
+
   bool symbol_name_slot_invalid (offset_type idx) const override
   {
     const auto &bucket = this->symbol_table[idx];
-    return bucket.name == 0 && bucket.vec == 0;
+    if (bucket.name == 0 && bucket.vec == 0)
+      return true;
+    return !slot_in_bounds (bucket);
   }
 
   /* Convenience method to get at the name of the symbol at IDX in the
@@ -521,6 +537,13 @@ struct dwarf2_cu
      after all type information has been read.  */
   std::vector<delayed_method_info> method_list;
 
+  /* The demangled forms of the linkage names of the DIEs of this CU,
+     computed before the DIEs are processed, see
+     demangle_linkage_names.  The value is NULL if the name does not
+     demangle.  */
+  std::unordered_map<const char *, gdb::unique_xmalloc_ptr<char>>
+    demangled_linkage_names;
+
   /* To be copied to symtab->call_site_htab.  */
   htab_t call_site_htab = nullptr;
 
@@ -951,7 +974,8 @@ class cutu_reader : public die_reader_specs
 	       dwarf2_per_objfile *per_objfile,
 	       struct abbrev_table *abbrev_table,
 	       dwarf2_cu *existing_cu,
-	       bool skip_partial);
+	       bool skip_partial,
+	       bool follow_dwo = true);
 
   explicit cutu_reader (struct dwarf2_per_cu_data *this_cu,
 			dwarf2_per_objfile *per_objfile,
@@ -1280,7 +1304,8 @@ static void add_partial_subprogram (struct partial_die_info *pdi,
 static unsigned int peek_abbrev_code (bfd *, const gdb_byte *);
 
 static struct partial_die_info *load_partial_dies
-  (const struct die_reader_specs *, const gdb_byte *, int);
+  (const struct die_reader_specs *, const gdb_byte *, int,
+   std::vector<partial_die_info *> *deferred = nullptr);
 
 /* A pair of partial_die_info and compilation unit.  */
 struct cu_partial_die_info
@@ -1604,10 +1629,16 @@ static void create_all_comp_units (dwarf2_per_objfile *per_objfile);
 
 static int create_all_type_units (dwarf2_per_objfile *per_objfile);
 
+struct full_cu_prefetch;
+
 static void load_full_comp_unit (dwarf2_per_cu_data *per_cu,
 				 dwarf2_per_objfile *per_objfile,
 				 bool skip_partial,
-				 enum language pretend_language);
+				 enum language pretend_language,
+				 full_cu_prefetch *prefetch = nullptr);
+
+static void read_full_comp_unit_dies (cutu_reader *reader,
+				      enum language pretend_language);
 
 static void process_full_comp_unit (dwarf2_cu *cu,
 				    enum language pretend_language);
@@ -2376,18 +2407,108 @@ create_quick_file_names_table (unsigned int nr_initial_entries)
 				     delete_file_name_entry, xcalloc, xfree));
 }
 
+/* Read in all the sections that may be needed to read the DIEs of the
+   compilation units of PER_OBJFILE, so that code running on worker
+   threads only ever finds them already read in.  */
+
+static void
+read_sections_for_worker_threads (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct objfile *objfile = per_objfile->objfile;
+
+  per_bfd->info.read (objfile);
+  per_bfd->abbrev.read (objfile);
+  per_bfd->str.read (objfile);
+  per_bfd->str_offsets.read (objfile);
+  per_bfd->line_str.read (objfile);
+  per_bfd->addr.read (objfile);
+  per_bfd->ranges.read (objfile);
+  per_bfd->rnglists.read (objfile);
+  per_bfd->loclists.read (objfile);
+  dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if (dwz != nullptr)
+    {
+      dwz->info.read (objfile);
+      dwz->abbrev.read (objfile);
+      dwz->str.read (objfile);
+    }
+}
+
+/* The DIEs of a compilation unit, read ahead of time on a worker
+   thread so that expanding its symtab does not have to read them.
+   See dw2_instantiate_symtabs.  */
+
+struct full_cu_prefetch
+{
+  /* The reader used for the unit.  It owns the dwarf2_cu, and thus the
+     DIEs, until the unit is expanded.  NULL if the unit could not be
+     read on a worker thread; it is then read on the main thread in the
+     usual way.  */
+  std::unique_ptr<cutu_reader> reader;
+
+  /* The complaints issued while reading the unit.  */
+  intercepted_complaints complaints;
+};
+
+/* Read the DIEs of THIS_CU into PREFETCH, on behalf of
+   load_full_comp_unit.  This is called on a worker thread, so it must
+   not modify anything that is shared with other units.  If the unit
+   cannot be handled here, PREFETCH->reader is left NULL.  */
+
+static void
+prefetch_full_comp_unit (dwarf2_per_cu_data *this_cu,
+			 dwarf2_per_objfile *per_objfile,
+			 full_cu_prefetch *prefetch)
+{
+  /* Type units and units that are already expanded, or cached by
+     PER_OBJFILE, are left to the main thread.  */
+  if (this_cu->is_debug_types
+      || per_objfile->symtab_set_p (this_cu)
+      || per_objfile->get_cu (this_cu) != nullptr)
+    return;
+
+  complaint_interceptor interceptor (&prefetch->complaints);
+
+  try
+    {
+      std::unique_ptr<cutu_reader> reader
+	(new cutu_reader (this_cu, per_objfile, nullptr, nullptr, true,
+			  false));
+
+      /* Partial units are only read when imported, with the language
+	 of the importing unit, and DWO units need to open the DWO
+	 file; both are left to the main thread.  */
+      if (reader->dummy_p
+	  || reader->comp_unit_die->tag != DW_TAG_compile_unit)
+	return;
+
+      read_full_comp_unit_dies (reader.get (), language_minimal);
+      prefetch->reader = std::move (reader);
+    }
+  catch (const gdb_exception &except)
+    {
+      /* The main thread will read the unit again, and report the
+	 error in the usual way.  */
+      prefetch->complaints.clear ();
+    }
+}
+
 /* Read in CU (dwarf2_cu object) for PER_CU in the context of PER_OBJFILE.  This
    function is unrelated to symtabs, symtab would have to be created afterwards.
-   You should call age_cached_comp_units after processing the CU.  */
+   You should call age_cached_comp_units after processing the CU.
+   If PREFETCH is not NULL, it holds the result of prefetch_full_comp_unit
+   for PER_CU.  */
 
 static dwarf2_cu *
 load_cu (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
-	 bool skip_partial)
+	 bool skip_partial, full_cu_prefetch *prefetch = nullptr)
 {
   if (per_cu->is_debug_types)
     load_full_type_unit (per_cu, per_objfile);
   else
-    load_full_comp_unit (per_cu, per_objfile, skip_partial, language_minimal);
+    load_full_comp_unit (per_cu, per_objfile, skip_partial, language_minimal,
+			 prefetch);
 
   dwarf2_cu *cu = per_objfile->get_cu (per_cu);
   if (cu == nullptr)
@@ -2398,11 +2519,13 @@ load_cu (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
   return cu;
 }
 
-/* Read in the symbols for PER_CU in the context of DWARF"_PER_OBJFILE.  */
+/* Read in the symbols for PER_CU in the context of DWARF"_PER_OBJFILE.
+   PREFETCH is passed to load_cu.  */
 
 static void
 dw2_do_instantiate_symtab (dwarf2_per_cu_data *per_cu,
-			   dwarf2_per_objfile *per_objfile, bool skip_partial)
+			   dwarf2_per_objfile *per_objfile, bool skip_partial,
+			   full_cu_prefetch *prefetch = nullptr)
 {
   /* Skip type_unit_groups, reading the type units they contain
      is handled elsewhere.  */
@@ -2417,7 +2540,7 @@ dw2_do_instantiate_symtab (dwarf2_per_cu_data *per_cu,
   if (!per_objfile->symtab_set_p (per_cu))
     {
       queue_comp_unit (per_cu, per_objfile, language_minimal);
-      dwarf2_cu *cu = load_cu (per_cu, per_objfile, skip_partial);
+      dwarf2_cu *cu = load_cu (per_cu, per_objfile, skip_partial, prefetch);
 
       /* If we just loaded a CU from a DWO, and we're working with an index
 	 that may badly handle TUs, load all the TUs in that DWO as well.
@@ -2440,14 +2563,16 @@ dw2_do_instantiate_symtab (dwarf2_per_cu_data *per_cu,
 }
 
 /* Ensure that the symbols for PER_CU have been read in.  DWARF2_PER_OBJFILE is
-   the per-objfile for which this symtab is instantiated.
+   the per-objfile for which this symtab is instantiated.  If PREFETCH is
+   not NULL, it holds the result of prefetch_full_comp_unit for PER_CU.
 
    Returns the resulting symbol table.  */
 
 static struct compunit_symtab *
 dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
 			dwarf2_per_objfile *per_objfile,
-			bool skip_partial)
+			bool skip_partial,
+			full_cu_prefetch *prefetch = nullptr)
 {
   gdb_assert (per_objfile->per_bfd->using_index);
 
@@ -2455,13 +2580,82 @@ dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
     {
       free_cached_comp_units freer (per_objfile);
       scoped_restore decrementer = increment_reading_symtab ();
-      dw2_do_instantiate_symtab (per_cu, per_objfile, skip_partial);
+      dw2_do_instantiate_symtab (per_cu, per_objfile, skip_partial,
+				 prefetch);
       process_cu_includes (per_objfile);
     }
 
   return per_objfile->get_symtab (per_cu);
 }
 
+/* The number of compilation units per worker thread whose DIEs are
+   read ahead by dw2_instantiate_symtabs.  Full DIE trees are much
+   bigger than partial DIEs, so this is kept small.  */
+
+static const size_t symtab_prefetch_units_per_thread = 4;
+
+/* Call EXPAND on each unit of UNITS, in order.  EXPAND is expected to
+   expand the symtab of the unit, passing its second argument to
+   dw2_instantiate_symtab.
+
+   If worker threads are available, the units are handled in batches.
+   The DIEs of the compilation units of a batch are first read in
+   parallel, each unit using its own dwarf2_cu.  Building the symtabs,
+   which creates types and symbols and reads the line tables, is then
+   done on the main thread, in unit order, so that the result does not
+   depend on the number of threads.  UNITS must not contain the same
+   unit twice.  */
+
+static void
+dw2_instantiate_symtabs
+  (dwarf2_per_objfile *per_objfile,
+   const std::vector<dwarf2_per_cu_data *> &units,
+   gdb::function_view<void (dwarf2_per_cu_data *,
+			    full_cu_prefetch *)> expand)
+{
+  size_t batch_size = 0;
+
+#if CXX_STD_THREAD
+  /* The DIE debugging output is not thread-safe.  */
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+  if (n_threads > 1 && !dwarf_die_debug)
+    batch_size = n_threads * symtab_prefetch_units_per_thread;
+#endif
+
+  if (batch_size == 0 || units.size () < 2)
+    {
+      for (dwarf2_per_cu_data *per_cu : units)
+	expand (per_cu, nullptr);
+      return;
+    }
+
+  read_sections_for_worker_threads (per_objfile);
+
+  std::vector<full_cu_prefetch> prefetch;
+  for (size_t start = 0; start < units.size (); start += batch_size)
+    {
+      size_t end = std::min (start + batch_size, units.size ());
+
+      prefetch.clear ();
+      prefetch.resize (end - start);
+
+      gdb::parallel_for_each
+	(units.begin () + start, units.begin () + end,
+	 [&] (std::vector<dwarf2_per_cu_data *>::const_iterator first,
+	      std::vector<dwarf2_per_cu_data *>::const_iterator last)
+	 {
+	   for (auto iter = first; iter != last; ++iter)
+	     {
+	       size_t idx = iter - units.begin () - start;
+	       prefetch_full_comp_unit (*iter, per_objfile, &prefetch[idx]);
+	     }
+	 });
+
+      for (size_t i = start; i < end; ++i)
+	expand (units[i], &prefetch[i - start]);
+    }
+}
+
 /* See declaration.  */
 
 dwarf2_per_cu_data *
@@ -2687,6 +2881,63 @@ create_signatured_type_table_from_debug_names
   per_objfile->per_bfd->signatured_types = std::move (sig_types_hash);
 }
 
+/* See the mapped_index class.  */
+
+bool
+mapped_index::slot_in_bounds (const symbol_table_slot &bucket) const
+{
+  offset_type name = MAYBE_SWAP (bucket.name);
+  offset_type vec = MAYBE_SWAP (bucket.vec);
+
+  if (name >= constant_pool_size
+      || memchr (constant_pool + name, '\0', constant_pool_size - name) == NULL)
+    return false;
+
+  /* The CU vector is a count followed by that many entries.  */
+  if (constant_pool_size < sizeof (offset_type)
+      || vec > constant_pool_size - sizeof (offset_type))
+    return false;
+  offset_type len = MAYBE_SWAP (*(offset_type *) (constant_pool + vec));
+  return len < (constant_pool_size - vec) / sizeof (offset_type);
+}
+
+/* Set the psymtabs_addrmap of OBJFILE to a map of RANGES, given in the
+   order they were read.  If they are sorted and do not overlap, as in
+   the indices GDB writes, the fixed map is built from them directly.
+   Otherwise they go through a mutable map, where the first range
+   covering an address wins.  */
+
+static void
+set_psymtabs_addrmap (struct objfile *objfile,
+		      const std::vector<addrmap_range> &ranges)
+{
+  struct obstack *obstack = objfile->partial_symtabs->obstack ();
+  bool sorted = true;
+
+  for (size_t i = 1; i < ranges.size (); ++i)
+    if (ranges[i].start <= ranges[i - 1].end_inclusive)
+      {
+	sorted = false;
+	break;
+      }
+
+  if (sorted)
+    objfile->partial_symtabs->psymtabs_addrmap
+      = addrmap_create_fixed (ranges, obstack);
+  else
+    {
+      auto_obstack temp_obstack;
+      addrmap *mutable_map = addrmap_create_mutable (&temp_obstack);
+
+      for (const addrmap_range &range : ranges)
+	addrmap_set_empty (mutable_map, range.start, range.end_inclusive,
+			   range.obj);
+
+      objfile->partial_symtabs->psymtabs_addrmap
+	= addrmap_create_fixed (mutable_map, obstack);
+    }
+}
+
 /* Read the address map data from the mapped index, and use it to
    populate the objfile's psymtabs_addrmap.  */
 
@@ -2697,12 +2948,8 @@ create_addrmap_from_index (dwarf2_per_objfile *per_objfile,
   struct objfile *objfile = per_objfile->objfile;
   struct gdbarch *gdbarch = objfile->arch ();
   const gdb_byte *iter, *end;
-  struct addrmap *mutable_map;
   CORE_ADDR baseaddr;
-
-  auto_obstack temp_obstack;
-
-  mutable_map = addrmap_create_mutable (&temp_obstack);
+  std::vector<addrmap_range> ranges;
 
   iter = index->address_table.data ();
   end = iter + index->address_table.size ();
@@ -2735,12 +2982,12 @@ create_addrmap_from_index (dwarf2_per_objfile *per_objfile,
 
       lo = gdbarch_adjust_dwarf2_addr (gdbarch, lo + baseaddr) - baseaddr;
       hi = gdbarch_adjust_dwarf2_addr (gdbarch, hi + baseaddr) - baseaddr;
-      addrmap_set_empty (mutable_map, lo, hi - 1,
-			 per_objfile->per_bfd->get_cu (cu_index));
+      if (lo < hi)
+	ranges.push_back ({ lo, hi - 1,
+			    per_objfile->per_bfd->get_cu (cu_index) });
     }
 
-  objfile->partial_symtabs->psymtabs_addrmap
-    = addrmap_create_fixed (mutable_map, objfile->partial_symtabs->obstack ());
+  set_psymtabs_addrmap (objfile, ranges);
 }
 
 /* Read the address map data from DWARF-5 .debug_aranges, and use it to
@@ -2755,8 +3002,7 @@ create_addrmap_from_aranges (dwarf2_per_objfile *per_objfile,
   struct gdbarch *gdbarch = objfile->arch ();
   const CORE_ADDR baseaddr = objfile->text_section_offset ();
 
-  auto_obstack temp_obstack;
-  addrmap *mutable_map = addrmap_create_mutable (&temp_obstack);
+  std::vector<addrmap_range> ranges;
 
   std::unordered_map<sect_offset,
 		     dwarf2_per_cu_data *,
@@ -2900,12 +3146,12 @@ create_addrmap_from_aranges (dwarf2_per_objfile *per_objfile,
 		   - baseaddr);
 	  end = (gdbarch_adjust_dwarf2_addr (gdbarch, end + baseaddr)
 		 - baseaddr);
-	  addrmap_set_empty (mutable_map, start, end - 1, per_cu);
+	  if (start < end)
+	    ranges.push_back ({ start, end - 1, per_cu });
 	}
     }
 
-  objfile->partial_symtabs->psymtabs_addrmap
-    = addrmap_create_fixed (mutable_map, objfile->partial_symtabs->obstack ());
+  set_psymtabs_addrmap (objfile, ranges);
 }
 
 /* Find a slot in the mapped index INDEX for the object named NAME.
@@ -2958,6 +3204,13 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
       if (bucket.name == 0 && bucket.vec == 0)
 	return false;
 
+      if (!index->slot_in_bounds (bucket))
+	{
+	  complaint (_(".gdb_index symbol table slot %u is out of bounds"),
+		     (unsigned) slot);
+	  return false;
+	}
+
       str = index->constant_pool + MAYBE_SWAP (bucket.name);
       if (!cmp (name, str))
 	{
@@ -3049,6 +3302,39 @@ to use the section anyway."),
 
   offset_type *metadata = (offset_type *) (addr + sizeof (offset_type));
 
+  /* The header is followed by the offsets of the CU list, the types
+     list, the address table, the symbol table and the constant pool.
+     Check that they are in order and within BUFFER, so that the
+     tables can be used directly from BUFFER.  Individual symbol table
+     slots are only checked when they are used.  */
+  const size_t n_offsets = 5;
+  if (buffer.size () < (1 + n_offsets) * sizeof (offset_type))
+    {
+      warning (_("Skipping truncated .gdb_index section in %s."), filename);
+      return 0;
+    }
+  offset_type prev_offset = (1 + n_offsets) * sizeof (offset_type);
+  for (size_t j = 0; j < n_offsets; ++j)
+    {
+      offset_type offset = MAYBE_SWAP (metadata[j]);
+      if (offset < prev_offset || offset > buffer.size ())
+	{
+	  warning (_("Skipping corrupt .gdb_index section in %s."), filename);
+	  return 0;
+	}
+      prev_offset = offset;
+    }
+  offset_type symbol_table_size = (MAYBE_SWAP (metadata[4])
+				   - MAYBE_SWAP (metadata[3]));
+  offset_type symbol_table_slots = (symbol_table_size
+				    / sizeof (mapped_index::symbol_table_slot));
+  if (symbol_table_size % sizeof (mapped_index::symbol_table_slot) != 0
+      || (symbol_table_slots & (symbol_table_slots - 1)) != 0)
+    {
+      warning (_("Skipping corrupt .gdb_index section in %s."), filename);
+      return 0;
+    }
+
   int i = 0;
   *cu_list = addr + MAYBE_SWAP (metadata[i]);
   *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
@@ -3076,6 +3362,7 @@ to use the section anyway."),
 
   ++i;
   map->constant_pool = (char *) (addr + MAYBE_SWAP (metadata[i]));
+  map->constant_pool_size = buffer.size () - MAYBE_SWAP (metadata[i]);
 
   return 1;
 }
@@ -3165,8 +3452,8 @@ dwarf2_read_gdb_index
 					       types_list_elements);
     }
 
-  create_addrmap_from_index (per_objfile, map.get ());
-
+  /* The address map is only created when it is first needed, see
+     dw2_get_addrmap.  */
   per_bfd->index_table = std::move (map);
   per_bfd->using_index = 1;
   per_bfd->quick_file_names_table =
@@ -3734,17 +4021,22 @@ dw2_expand_all_symtabs (struct objfile *objfile)
   int total_units = (per_objfile->per_bfd->all_comp_units.size ()
 		     + per_objfile->per_bfd->all_type_units.size ());
 
+  std::vector<dwarf2_per_cu_data *> units;
+  units.reserve (total_units);
   for (int i = 0; i < total_units; ++i)
-    {
-      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cutu (i);
+    units.push_back (per_objfile->per_bfd->get_cutu (i));
 
+  dw2_instantiate_symtabs (per_objfile, units,
+			   [&] (dwarf2_per_cu_data *per_cu,
+				full_cu_prefetch *prefetch)
+    {
       /* We don't want to directly expand a partial CU, because if we
 	 read it with the wrong language, then assertion failures can
 	 be triggered later on.  See PR symtab/23010.  So, tell
 	 dw2_instantiate_symtab to skip partial CUs -- any important
 	 partial CU will be read via DW_TAG_imported_unit anyway.  */
-      dw2_instantiate_symtab (per_cu, per_objfile, true);
-    }
+      dw2_instantiate_symtab (per_cu, per_objfile, true, prefetch);
+    });
 }
 
 static void
@@ -3795,7 +4087,8 @@ dw2_expand_symtabs_matching_one
   (dwarf2_per_cu_data *per_cu,
    dwarf2_per_objfile *per_objfile,
    gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
-   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify);
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
+   full_cu_prefetch *prefetch = nullptr);
 
 static void
 dw2_map_matching_symbols
@@ -4622,21 +4915,22 @@ run_test ()
 /* If FILE_MATCHER is NULL or if PER_CU has
    dwarf2_per_cu_quick_data::MARK set (see
    dw_expand_symtabs_matching_file_matcher), expand the CU and call
-   EXPANSION_NOTIFY on it.  */
+   EXPANSION_NOTIFY on it.  PREFETCH is passed to dw2_instantiate_symtab.  */
 
 static void
 dw2_expand_symtabs_matching_one
   (dwarf2_per_cu_data *per_cu,
    dwarf2_per_objfile *per_objfile,
    gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
-   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
+   full_cu_prefetch *prefetch)
 {
   if (file_matcher == NULL || per_cu->v.quick->mark)
     {
       bool symtab_was_null = !per_objfile->symtab_set_p (per_cu);
 
       compunit_symtab *symtab
-	= dw2_instantiate_symtab (per_cu, per_objfile, false);
+	= dw2_instantiate_symtab (per_cu, per_objfile, false, prefetch);
       gdb_assert (symtab != nullptr);
 
       if (expansion_notify != NULL && symtab_was_null)
@@ -4644,16 +4938,70 @@ dw2_expand_symtabs_matching_one
     }
 }
 
-/* Helper for dw2_expand_matching symtabs.  Called on each symbol
-   matched, to expand corresponding CUs that were marked.  IDX is the
-   index of the symbol name that matched.  */
+/* A list of units to expand, without duplicates.  */
+
+class dw2_units_to_expand
+{
+public:
+
+  explicit dw2_units_to_expand (dwarf2_per_objfile *per_objfile)
+    : m_seen (per_objfile->per_bfd->num_psymtabs ())
+  {
+  }
+
+  /* Add PER_CU to the list, unless it is already there.  */
+  void add (dwarf2_per_cu_data *per_cu)
+  {
+    if (!m_seen[per_cu->index])
+      {
+	m_seen[per_cu->index] = true;
+	m_units.push_back (per_cu);
+      }
+  }
+
+  /* The units, in the order they were added.  */
+  const std::vector<dwarf2_per_cu_data *> &units () const
+  { return m_units; }
+
+private:
+
+  std::vector<dwarf2_per_cu_data *> m_units;
+  std::vector<bool> m_seen;
+};
+
+/* Expand the units of UNITS with dw2_expand_symtabs_matching_one.  */
 
 static void
-dw2_expand_marked_cus
-  (dwarf2_per_objfile *per_objfile, offset_type idx,
+dw2_expand_symtabs_matching_units
+  (dwarf2_per_objfile *per_objfile, const dw2_units_to_expand &units,
    gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
-   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
-   search_domain kind)
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  /* Only the marked units are expanded, don't read the others ahead.  */
+  std::vector<dwarf2_per_cu_data *> marked;
+  for (dwarf2_per_cu_data *per_cu : units.units ())
+    if (file_matcher == NULL || per_cu->v.quick->mark)
+      marked.push_back (per_cu);
+
+  dw2_instantiate_symtabs (per_objfile, marked,
+			   [&] (dwarf2_per_cu_data *per_cu,
+				full_cu_prefetch *prefetch)
+    {
+      QUIT;
+
+      dw2_expand_symtabs_matching_one (per_cu, per_objfile, file_matcher,
+				       expansion_notify, prefetch);
+    });
+}
+
+/* Helper for dw2_expand_matching symtabs.  Called on each symbol
+   matched, to find the corresponding CUs.  IDX is the index of the
+   symbol name that matched.  The CUs are added to UNITS, to be expanded
+   by the caller if they were marked.  */
+
+static void
+dw2_collect_marked_cus (dwarf2_per_objfile *per_objfile, offset_type idx,
+			search_domain kind, dw2_units_to_expand *units)
 {
   offset_type *vec, vec_len, vec_idx;
   bool global_seen = false;
@@ -4724,9 +5072,7 @@ dw2_expand_marked_cus
 	  continue;
 	}
 
-      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cutu (cu_index);
-      dw2_expand_symtabs_matching_one (per_cu, per_objfile, file_matcher,
-				       expansion_notify);
+      units->add (per_objfile->per_bfd->get_cutu (cu_index));
     }
 }
 
@@ -4824,28 +5170,28 @@ dw2_expand_symtabs_matching
 
   dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
 
+  dw2_units_to_expand units (per_objfile);
+
   if (symbol_matcher == NULL && lookup_name == NULL)
     {
       for (dwarf2_per_cu_data *per_cu : per_objfile->per_bfd->all_comp_units)
-	{
-	  QUIT;
-
-	  dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-					   file_matcher, expansion_notify);
-	}
-      return;
+	units.add (per_cu);
     }
+  else
+    {
+      mapped_index &index = *per_objfile->per_bfd->index_table;
 
-  mapped_index &index = *per_objfile->per_bfd->index_table;
+      dw2_expand_symtabs_matching_symbol (index, *lookup_name,
+					  symbol_matcher,
+					  kind, [&] (offset_type idx)
+	{
+	  dw2_collect_marked_cus (per_objfile, idx, kind, &units);
+	  return true;
+	}, per_objfile);
+    }
 
-  dw2_expand_symtabs_matching_symbol (index, *lookup_name,
-				      symbol_matcher,
-				      kind, [&] (offset_type idx)
-    {
-      dw2_expand_marked_cus (per_objfile, idx, file_matcher, expansion_notify,
-			     kind);
-      return true;
-    }, per_objfile);
+  dw2_expand_symtabs_matching_units (per_objfile, units, file_matcher,
+				     expansion_notify);
 }
 
 /* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
@@ -4876,6 +5222,26 @@ recursively_find_pc_sect_compunit_symtab (struct compunit_symtab *cust,
   return NULL;
 }
 
+/* Return the address map of PER_OBJFILE, mapping addresses to
+   dwarf2_per_cu_data objects, or NULL if there is none.  When reading
+   .gdb_index, the address map is only created here, the first time
+   it is needed, rather than when the index is read.  */
+
+static struct addrmap *
+dw2_get_addrmap (dwarf2_per_objfile *per_objfile)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  mapped_index *index = per_objfile->per_bfd->index_table.get ();
+
+  if (index != nullptr && !index->address_table_read)
+    {
+      index->address_table_read = true;
+      create_addrmap_from_index (per_objfile, index);
+    }
+
+  return objfile->partial_symtabs->psymtabs_addrmap;
+}
+
 static struct compunit_symtab *
 dw2_find_pc_sect_compunit_symtab (struct objfile *objfile,
 				  struct bound_minimal_symbol msymbol,
@@ -4885,17 +5251,17 @@ dw2_find_pc_sect_compunit_symtab (struct objfile *objfile,
 {
   struct dwarf2_per_cu_data *data;
   struct compunit_symtab *result;
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
 
-  if (!objfile->partial_symtabs->psymtabs_addrmap)
+  struct addrmap *addrmap = dw2_get_addrmap (per_objfile);
+  if (addrmap == nullptr)
     return NULL;
 
   CORE_ADDR baseaddr = objfile->text_section_offset ();
-  data = (struct dwarf2_per_cu_data *) addrmap_find
-    (objfile->partial_symtabs->psymtabs_addrmap, pc - baseaddr);
+  data = (struct dwarf2_per_cu_data *) addrmap_find (addrmap, pc - baseaddr);
   if (!data)
     return NULL;
 
-  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
   if (warn_if_readin && per_objfile->symtab_set_p (data))
     warning (_("(Internal error: pc %s in read in CU, but not in symtab.)"),
 	     paddress (objfile->arch (), pc));
@@ -5891,34 +6257,34 @@ dw2_debug_names_expand_symtabs_matching
 
   dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
 
+  dw2_units_to_expand units (per_objfile);
+
   if (symbol_matcher == NULL && lookup_name == NULL)
     {
       for (dwarf2_per_cu_data *per_cu : per_objfile->per_bfd->all_comp_units)
-	{
-	  QUIT;
-
-	  dw2_expand_symtabs_matching_one (per_cu, per_objfile, file_matcher,
-					   expansion_notify);
-	}
-      return;
+	units.add (per_cu);
     }
+  else
+    {
+      mapped_debug_names &map = *per_objfile->per_bfd->debug_names_table;
 
-  mapped_debug_names &map = *per_objfile->per_bfd->debug_names_table;
+      dw2_expand_symtabs_matching_symbol (map, *lookup_name,
+					  symbol_matcher,
+					  kind, [&] (offset_type namei)
+	{
+	  /* The name was matched, now find the corresponding CUs, to be
+	     expanded below if they were marked.  */
+	  dw2_debug_names_iterator iter (map, kind, namei, per_objfile);
 
-  dw2_expand_symtabs_matching_symbol (map, *lookup_name,
-				      symbol_matcher,
-				      kind, [&] (offset_type namei)
-    {
-      /* The name was matched, now expand corresponding CUs that were
-	 marked.  */
-      dw2_debug_names_iterator iter (map, kind, namei, per_objfile);
+	  struct dwarf2_per_cu_data *per_cu;
+	  while ((per_cu = iter.next ()) != NULL)
+	    units.add (per_cu);
+	  return true;
+	}, per_objfile);
+    }
 
-      struct dwarf2_per_cu_data *per_cu;
-      while ((per_cu = iter.next ()) != NULL)
-	dw2_expand_symtabs_matching_one (per_cu, per_objfile, file_matcher,
-					 expansion_notify);
-      return true;
-    }, per_objfile);
+  dw2_expand_symtabs_matching_units (per_objfile, units, file_matcher,
+				     expansion_notify);
 }
 
 const struct quick_symbol_functions dwarf2_debug_names_functions =
@@ -7086,13 +7452,18 @@ cutu_reader::init_tu_and_read_dwo_dies (dwarf2_per_cu_data *this_cu,
    This is an optimization for when we already have the abbrev table.
 
    If EXISTING_CU is non-NULL, then use it.  Otherwise, a new CU is
-   allocated.  */
+   allocated.
+
+   If FOLLOW_DWO is false, a CU that defers to a DWO file is treated
+   as a dummy CU.  This is used when reading on a worker thread, where
+   DWO files cannot be opened.  */
 
 cutu_reader::cutu_reader (dwarf2_per_cu_data *this_cu,
 			  dwarf2_per_objfile *per_objfile,
 			  struct abbrev_table *abbrev_table,
 			  dwarf2_cu *existing_cu,
-			  bool skip_partial)
+			  bool skip_partial,
+			  bool follow_dwo)
   : die_reader_specs {},
     m_this_cu (this_cu)
 {
@@ -7241,7 +7612,12 @@ cutu_reader::cutu_reader (dwarf2_per_cu_data *this_cu,
      Note that if USE_EXISTING_OK != 0, and THIS_CU->cu already contains a
      DWO CU, that this test will fail (the attribute will not be present).  */
   const char *dwo_name = dwarf2_dwo_name (comp_unit_die, cu);
-  if (dwo_name != nullptr)
+  if (dwo_name != nullptr && !follow_dwo)
+    {
+      dummy_p = true;
+      return;
+    }
+  else if (dwo_name != nullptr)
     {
       struct dwo_unit *dwo_unit;
       struct die_info *dwo_comp_unit_die;
@@ -7537,13 +7913,38 @@ create_partial_symtab (dwarf2_per_cu_data *per_cu,
   return pst;
 }
 
-/* DIE reader function for process_psymtab_comp_unit.  */
+/* The partial DIEs of a compilation unit, read ahead of time on a
+   worker thread.  See process_psymtab_comp_units.  */
+
+struct psymtab_cu_prefetch
+{
+  /* The reader used for the unit.  It owns the dwarf2_cu, and thus
+     the partial DIEs, as well as the abbrev table.  NULL if the unit
+     could not be read on a worker thread; it is then read on the main
+     thread in the usual way.  */
+  std::unique_ptr<cutu_reader> reader;
+
+  /* The first partial DIE below the unit DIE.  */
+  struct partial_die_info *first_die = nullptr;
+
+  /* Partial DIEs for which load_partial_dies would have added a
+     partial symbol directly.  Partial symbols can only be created on
+     the main thread, so they are added there instead.  */
+  std::vector<partial_die_info *> deferred;
+
+  /* The complaints issued while reading the unit.  */
+  intercepted_complaints complaints;
+};
+
+/* DIE reader function for process_psymtab_comp_unit.  If PREFETCH is
+   not NULL, the partial DIEs of the unit have already been read.  */
 
 static void
 process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 				  const gdb_byte *info_ptr,
 				  struct die_info *comp_unit_die,
-				  enum language pretend_language)
+				  enum language pretend_language,
+				  psymtab_cu_prefetch *prefetch = nullptr)
 {
   struct dwarf2_cu *cu = reader->cu;
   dwarf2_per_objfile *per_objfile = cu->per_objfile;
@@ -7612,7 +8013,14 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
       lowpc = ((CORE_ADDR) -1);
       highpc = ((CORE_ADDR) 0);
 
-      first_die = load_partial_dies (reader, info_ptr, 1);
+      if (prefetch != nullptr)
+	{
+	  for (partial_die_info *pdi : prefetch->deferred)
+	    add_partial_symbol (pdi, cu);
+	  first_die = prefetch->first_die;
+	}
+      else
+	first_die = load_partial_dies (reader, info_ptr, 1);
 
       scan_partial_symbols (first_die, &lowpc, &highpc,
 			    cu_bounds_kind <= PC_BOUNDS_INVALID, cu);
@@ -7674,13 +8082,16 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 }
 
 /* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
-   Process compilation unit THIS_CU for a psymtab.  */
+   Process compilation unit THIS_CU for a psymtab.  If PREFETCH is not
+   NULL, it holds the result of prefetch_psymtab_comp_unit for
+   THIS_CU.  */
 
 static void
 process_psymtab_comp_unit (dwarf2_per_cu_data *this_cu,
 			   dwarf2_per_objfile *per_objfile,
 			   bool want_partial_unit,
-			   enum language pretend_language)
+			   enum language pretend_language,
+			   psymtab_cu_prefetch *prefetch = nullptr)
 {
   /* If this compilation unit was already read in, free the
      cached copy in order to read it in again.	This is
@@ -7689,7 +8100,20 @@ process_psymtab_comp_unit (dwarf2_per_cu_data *this_cu,
      This problem could be avoided, but the benefit is unclear.  */
   per_objfile->remove_cu (this_cu);
 
-  cutu_reader reader (this_cu, per_objfile, nullptr, nullptr, false);
+  gdb::optional<cutu_reader> local_reader;
+  cutu_reader *reader_ptr;
+  if (prefetch != nullptr && prefetch->reader != nullptr)
+    {
+      re_emit_complaints (prefetch->complaints);
+      reader_ptr = prefetch->reader.get ();
+    }
+  else
+    {
+      prefetch = nullptr;
+      local_reader.emplace (this_cu, per_objfile, nullptr, nullptr, false);
+      reader_ptr = &*local_reader;
+    }
+  cutu_reader &reader = *reader_ptr;
 
   switch (reader.comp_unit_die->tag)
     {
@@ -7714,7 +8138,7 @@ process_psymtab_comp_unit (dwarf2_per_cu_data *this_cu,
 	   || reader.comp_unit_die->tag != DW_TAG_partial_unit)
     process_psymtab_comp_unit_reader (&reader, reader.info_ptr,
 				      reader.comp_unit_die,
-				      pretend_language);
+				      pretend_language, prefetch);
 
   this_cu->lang = reader.cu->language;
 
@@ -7722,6 +8146,142 @@ process_psymtab_comp_unit (dwarf2_per_cu_data *this_cu,
   per_objfile->age_comp_units ();
 }
 
+/* Read the partial DIEs of THIS_CU into PREFETCH, on behalf of
+   process_psymtab_comp_unit.  This is called on a worker thread, so it
+   must not modify anything that is shared with other units; in
+   particular, no partial symbols are created here.  If the unit cannot
+   be handled here, PREFETCH->reader is left NULL.  */
+
+static void
+prefetch_psymtab_comp_unit (dwarf2_per_cu_data *this_cu,
+			    dwarf2_per_objfile *per_objfile,
+			    psymtab_cu_prefetch *prefetch)
+{
+  /* The unit was already read as an imported unit, or a copy of it is
+     cached by PER_OBJFILE.  Leave it to the main thread.  */
+  if (this_cu->v.psymtab != nullptr
+      || per_objfile->get_cu (this_cu) != nullptr)
+    return;
+
+  complaint_interceptor interceptor (&prefetch->complaints);
+
+  try
+    {
+      std::unique_ptr<cutu_reader> reader
+	(new cutu_reader (this_cu, per_objfile, nullptr, nullptr, false,
+			  false));
+
+      /* Only plain compilation units are read here; anything else is
+	 cheap enough to be handled by the main thread.  */
+      if (reader->dummy_p
+	  || this_cu->is_debug_types
+	  || reader->comp_unit_die->tag != DW_TAG_compile_unit)
+	return;
+
+      /* This mirrors what process_psymtab_comp_unit_reader does before
+	 loading the partial DIEs.  */
+      prepare_one_comp_unit (reader->cu, reader->comp_unit_die,
+			     language_minimal);
+      dwarf2_find_base_address (reader->comp_unit_die, reader->cu);
+
+      if (reader->comp_unit_die->has_children)
+	prefetch->first_die = load_partial_dies (reader.get (),
+						 reader->info_ptr, 1,
+						 &prefetch->deferred);
+
+      prefetch->reader = std::move (reader);
+    }
+  catch (const gdb_exception &except)
+    {
+      /* The main thread will read the unit again, and report the
+	 error in the usual way.  */
+      prefetch->first_die = nullptr;
+      prefetch->deferred.clear ();
+      prefetch->complaints.clear ();
+    }
+}
+
+/* The number of compilation units per worker thread that are read
+   ahead by process_psymtab_comp_units.  This bounds the number of
+   units whose partial DIEs are in memory at the same time.  */
+
+static const size_t psymtab_prefetch_units_per_thread = 16;
+
+/* Subroutine of dwarf2_build_psymtabs_hard.  Create the psymtabs of
+   all the compilation units of PER_OBJFILE.
+
+   If worker threads are available, the units are handled in batches.
+   The partial DIEs of the units of a batch are first read in parallel,
+   each unit using its own dwarf2_cu (and thus its own obstack) and its
+   own abbrev table.  The partial symbols are then created on the main
+   thread, in unit order, so that the result does not depend on the
+   number of threads.  */
+
+static void
+process_psymtab_comp_units (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  const std::vector<dwarf2_per_cu_data *> &all_cus = per_bfd->all_comp_units;
+  size_t batch_size = 0;
+
+#if CXX_STD_THREAD
+  /* The DIE debugging output is not thread-safe.  */
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+  if (n_threads > 1 && !dwarf_die_debug)
+    batch_size = n_threads * psymtab_prefetch_units_per_thread;
+#endif
+
+  if (batch_size == 0 || all_cus.size () < 2)
+    {
+      for (dwarf2_per_cu_data *per_cu : all_cus)
+	{
+	  if (per_cu->v.psymtab != NULL)
+	    /* In case a forward DW_TAG_imported_unit has read the CU
+	       already.  */
+	    continue;
+	  process_psymtab_comp_unit (per_cu, per_objfile, false,
+				     language_minimal);
+	}
+      return;
+    }
+
+  read_sections_for_worker_threads (per_objfile);
+
+  std::vector<psymtab_cu_prefetch> prefetch;
+  for (size_t start = 0; start < all_cus.size (); start += batch_size)
+    {
+      size_t end = std::min (start + batch_size, all_cus.size ());
+
+      prefetch.clear ();
+      prefetch.resize (end - start);
+
+      gdb::parallel_for_each
+	(all_cus.begin () + start, all_cus.begin () + end,
+	 [&] (std::vector<dwarf2_per_cu_data *>::const_iterator first,
+	      std::vector<dwarf2_per_cu_data *>::const_iterator last)
+	 {
+	   for (auto iter = first; iter != last; ++iter)
+	     {
+	       size_t idx = iter - all_cus.begin () - start;
+	       prefetch_psymtab_comp_unit (*iter, per_objfile,
+					   &prefetch[idx]);
+	     }
+	 });
+
+      for (size_t i = start; i < end; ++i)
+	{
+	  dwarf2_per_cu_data *per_cu = all_cus[i];
+
+	  if (per_cu->v.psymtab != NULL)
+	    /* In case a forward DW_TAG_imported_unit has read the CU
+	       already.  */
+	    continue;
+	  process_psymtab_comp_unit (per_cu, per_objfile, false,
+				     language_minimal, &prefetch[i - start]);
+	}
+    }
+}
+
 /* Reader function for build_type_psymtabs.  */
 
 static void
@@ -8068,14 +8628,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
     = make_scoped_restore (&objfile->partial_symtabs->psymtabs_addrmap,
 			   addrmap_create_mutable (&temp_obstack));
 
-  for (dwarf2_per_cu_data *per_cu : per_objfile->per_bfd->all_comp_units)
-    {
-      if (per_cu->v.psymtab != NULL)
-	/* In case a forward DW_TAG_imported_unit has read the CU already.  */
-	continue;
-      process_psymtab_comp_unit (per_cu, per_objfile, false,
-				 language_minimal);
-    }
+  process_psymtab_comp_units (per_objfile);
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (per_objfile);
@@ -8859,6 +9412,30 @@ skip_one_die (const struct die_reader_specs *reader, const gdb_byte *info_ptr,
   const gdb_byte *buffer_end = reader->buffer_end;
   unsigned int form, i;
 
+  /* Use the layout of the attributes computed by abbrev_table::read,
+     if it is known, to avoid decoding them.  */
+  if (abbrev->sibling_offset != (unsigned short) -1)
+    {
+      /* The sibling is a DW_FORM_ref4 reference.  */
+      unsigned int offset
+	= read_4_bytes (abfd, info_ptr + abbrev->sibling_offset);
+      const gdb_byte *sibling_ptr
+	= buffer + to_underlying (cu->header.sect_off) + offset;
+
+      if (sibling_ptr >= info_ptr && sibling_ptr <= buffer_end)
+	return sibling_ptr;
+
+      /* Otherwise, read the attributes the slow way below, which
+	 complains about the bad sibling.  */
+    }
+  else if (abbrev->size_if_constant != 0)
+    {
+      info_ptr += abbrev->size_if_constant;
+      if (abbrev->has_children)
+	return skip_children (reader, info_ptr);
+      return info_ptr;
+    }
+
   for (i = 0; i < abbrev->num_attrs; i++)
     {
       /* The only abbrev we care about is DW_AT_sibling.  */
@@ -9230,23 +9807,49 @@ die_eq (const void *item_lhs, const void *item_rhs)
   return die_lhs->sect_off == die_rhs->sect_off;
 }
 
-/* Load the DIEs associated with PER_CU into memory.  */
+/* Load the DIEs associated with PER_CU into memory.  If PREFETCH is
+   not NULL and holds the DIEs of PER_CU, read on a worker thread, they
+   are used instead of reading them again.  */
 
 static void
 load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 		     dwarf2_per_objfile *per_objfile,
 		     bool skip_partial,
-		     enum language pretend_language)
+		     enum language pretend_language,
+		     full_cu_prefetch *prefetch)
 {
   gdb_assert (! this_cu->is_debug_types);
 
   dwarf2_cu *existing_cu = per_objfile->get_cu (this_cu);
+
+  if (prefetch != nullptr
+      && prefetch->reader != nullptr
+      && existing_cu == nullptr
+      && pretend_language == language_minimal)
+    {
+      re_emit_complaints (prefetch->complaints);
+      prefetch->reader->keep ();
+      prefetch->reader.reset ();
+      return;
+    }
+
   cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
   if (reader.dummy_p)
     return;
 
-  struct dwarf2_cu *cu = reader.cu;
-  const gdb_byte *info_ptr = reader.info_ptr;
+  read_full_comp_unit_dies (&reader, pretend_language);
+  reader.keep ();
+}
+
+/* Subroutine of load_full_comp_unit and prefetch_full_comp_unit.  Read
+   the DIEs of the unit being read by READER into its dwarf2_cu.  */
+
+static void
+read_full_comp_unit_dies (cutu_reader *reader,
+			  enum language pretend_language)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  const gdb_byte *info_ptr = reader->info_ptr;
 
   gdb_assert (cu->die_hash == NULL);
   cu->die_hash =
@@ -9258,11 +9861,11 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 			  hashtab_obstack_allocate,
 			  dummy_obstack_deallocate);
 
-  if (reader.comp_unit_die->has_children)
-    reader.comp_unit_die->child
-      = read_die_and_siblings (&reader, reader.info_ptr,
-			       &info_ptr, reader.comp_unit_die);
-  cu->dies = reader.comp_unit_die;
+  if (reader->comp_unit_die->has_children)
+    reader->comp_unit_die->child
+      = read_die_and_siblings (reader, reader->info_ptr,
+			       &info_ptr, reader->comp_unit_die);
+  cu->dies = reader->comp_unit_die;
   /* comp_unit_die is not stored in die_hash, no need.  */
 
   /* We try not to read any attributes in this function, because not
@@ -9272,8 +9875,6 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
      Similarly, if we do not read the producer, we can not apply
      producer-specific interpretation.  */
   prepare_one_comp_unit (cu, cu->dies, pretend_language);
-
-  reader.keep ();
 }
 
 /* Add a DIE to the delayed physname list.  */
@@ -9905,6 +10506,98 @@ process_cu_includes (dwarf2_per_objfile *per_objfile)
   per_objfile->per_bfd->just_read_cus.clear ();
 }
 
+/* Demangle MANGLED, the linkage name of a DIE, the way
+   dwarf2_physname wants it.  Return NULL if it does not demangle.  */
+
+static gdb::unique_xmalloc_ptr<char>
+demangle_linkage_name (const char *mangled)
+{
+  /* Use DMGL_RET_DROP for C++ template functions to suppress
+     their return type.  It is easier for GDB users to search
+     for such functions as `name(params)' than `long name(params)'.
+     In such case the minimal symbol names do not match the full
+     symbol names but for template functions there is never a need
+     to look up their definition from their declaration so
+     the only disadvantage remains the minimal symbol variant
+     `long name(params)' does not have the proper inferior type.  */
+  return gdb::unique_xmalloc_ptr<char>
+    (gdb_demangle (mangled, (DMGL_PARAMS | DMGL_ANSI | DMGL_RET_DROP)));
+}
+
+/* Set the value of each entry of NAMES, whose keys are linkage names,
+   to the result of demangle_linkage_name.  The names are demangled in
+   parallel; the result does not depend on the order in which they
+   are.  */
+
+static void
+demangle_linkage_names_in_parallel
+  (std::unordered_map<const char *, gdb::unique_xmalloc_ptr<char>> *names)
+{
+  typedef std::pair<const char * const, gdb::unique_xmalloc_ptr<char>> entry;
+
+  /* Each thread only writes the values of its own entries, and the
+     map is not modified otherwise meanwhile.  */
+  std::vector<entry *> entries;
+  entries.reserve (names->size ());
+  for (entry &e : *names)
+    entries.push_back (&e);
+
+  gdb::parallel_for_each
+    (entries.begin (), entries.end (),
+     [] (std::vector<entry *>::iterator start,
+	 std::vector<entry *>::iterator end)
+     {
+       for (; start != end; ++start)
+	 (*start)->second = demangle_linkage_name ((*start)->first);
+     });
+}
+
+/* Add the linkage names of DIE, its siblings and their children to
+   NAMES, with no demangled name yet.  Unlike dw2_linkage_name, do not
+   follow DW_AT_specification or DW_AT_abstract_origin: the DIEs they
+   refer to are in the tree too, or in another CU.  */
+
+static void
+collect_linkage_names
+  (die_info *die,
+   std::unordered_map<const char *, gdb::unique_xmalloc_ptr<char>> *names)
+{
+  for (; die != nullptr; die = die->sibling)
+    {
+      for (dwarf_attribute name : { DW_AT_linkage_name,
+				    DW_AT_MIPS_linkage_name })
+	{
+	  attribute *attr = die->attr (name);
+
+	  if (attr != nullptr && attr->value_as_string () != nullptr)
+	    names->emplace (attr->value_as_string (), nullptr);
+	}
+
+      collect_linkage_names (die->child, names);
+    }
+}
+
+/* Demangle the linkage names of the DIEs of CU, which are about to be
+   processed, in parallel.  dwarf2_physname then finds them in
+   CU->demangled_linkage_names, instead of demangling them one at a
+   time.  */
+
+static void
+demangle_linkage_names (dwarf2_cu *cu)
+{
+  cu->demangled_linkage_names.clear ();
+
+  /* dwarf2_physname does not demangle the names of these
+     languages.  */
+  if (cu->language == language_rust
+      || cu->language == language_go
+      || cu->language_defn->la_store_sym_names_in_linkage_form_p)
+    return;
+
+  collect_linkage_names (cu->dies, &cu->demangled_linkage_names);
+  demangle_linkage_names_in_parallel (&cu->demangled_linkage_names);
+}
+
 /* Generate full symbol information for CU, whose DIEs have
    already been loaded into memory.  */
 
@@ -9928,6 +10621,8 @@ process_full_comp_unit (dwarf2_cu *cu, enum language pretend_language)
   cu->language = pretend_language;
   cu->language_defn = language_def (cu->language);
 
+  demangle_linkage_names (cu);
+
   /* Do line number decoding in read_file_scope () */
   process_die (cu->dies, cu);
 
@@ -10001,6 +10696,7 @@ process_full_comp_unit (dwarf2_cu *cu, enum language pretend_language)
 
   /* Not needed any more.  */
   cu->reset_builder ();
+  cu->demangled_linkage_names.clear ();
 }
 
 /* Generate full symbol information for type unit CU, whose DIEs have
@@ -10024,6 +10720,8 @@ process_full_type_unit (dwarf2_cu *cu,
   cu->language = pretend_language;
   cu->language_defn = language_def (cu->language);
 
+  demangle_linkage_names (cu);
+
   /* The symbol tables are set up in read_type_unit_scope.  */
   process_die (cu->dies, cu);
 
@@ -10072,6 +10770,7 @@ process_full_type_unit (dwarf2_cu *cu,
 
   /* Not needed any more.  */
   cu->reset_builder ();
+  cu->demangled_linkage_names.clear ();
 }
 
 /* Process an imported unit DIE.  */
@@ -10632,6 +11331,7 @@ dwarf2_physname (const char *name, struct die_info *die, struct dwarf2_cu *cu)
   /* DW_AT_linkage_name is missing in some cases - depend on what GDB
      has computed.  */
   gdb::unique_xmalloc_ptr<char> demangled;
+  const char *demangled_name = nullptr;
   if (mangled != NULL)
     {
 
@@ -10647,20 +11347,20 @@ dwarf2_physname (const char *name, struct die_info *die, struct dwarf2_cu *cu)
 	}
       else
 	{
-	  /* Use DMGL_RET_DROP for C++ template functions to suppress
-	     their return type.  It is easier for GDB users to search
-	     for such functions as `name(params)' than `long name(params)'.
-	     In such case the minimal symbol names do not match the full
-	     symbol names but for template functions there is never a need
-	     to look up their definition from their declaration so
-	     the only disadvantage remains the minimal symbol variant
-	     `long name(params)' does not have the proper inferior type.  */
-	  demangled.reset (gdb_demangle (mangled,
-					 (DMGL_PARAMS | DMGL_ANSI
-					  | DMGL_RET_DROP)));
-	}
-      if (demangled)
-	canon = demangled.get ();
+	  /* The linkage names of the DIEs of CU are normally demangled
+	     before the DIEs are processed.  */
+	  auto it = cu->demangled_linkage_names.find (mangled);
+
+	  if (it != cu->demangled_linkage_names.end ())
+	    demangled_name = it->second.get ();
+	  else
+	    {
+	      demangled = demangle_linkage_name (mangled);
+	      demangled_name = demangled.get ();
+	    }
+	}
+      if (demangled_name != nullptr)
+	canon = demangled_name;
       else
 	{
 	  canon = mangled;
@@ -18647,43 +19347,31 @@ read_full_die (const struct die_reader_specs *reader,
 }
 
 
-/* Returns nonzero if TAG represents a type that we might generate a partial
-   symbol for.  */
+/* Subroutine of load_partial_dies.  Add the partial symbol for PDI, or
+   if DEFERRED is not NULL, save a copy of PDI there so that the caller
+   can add the symbol later.  */
 
-static int
-is_type_tag_for_partial (int tag)
+static void
+add_or_defer_partial_symbol (struct partial_die_info *pdi,
+			     struct dwarf2_cu *cu,
+			     std::vector<partial_die_info *> *deferred)
 {
-  switch (tag)
-    {
-#if 0
-    /* Some types that would be reasonable to generate partial symbols for,
-       that we don't at present.  */
-    case DW_TAG_array_type:
-    case DW_TAG_file_type:
-    case DW_TAG_ptr_to_member_type:
-    case DW_TAG_set_type:
-    case DW_TAG_string_type:
-    case DW_TAG_subroutine_type:
-#endif
-    case DW_TAG_base_type:
-    case DW_TAG_class_type:
-    case DW_TAG_interface_type:
-    case DW_TAG_enumeration_type:
-    case DW_TAG_structure_type:
-    case DW_TAG_subrange_type:
-    case DW_TAG_typedef:
-    case DW_TAG_union_type:
-      return 1;
-    default:
-      return 0;
-    }
+  if (deferred != nullptr)
+    deferred->push_back (new (&cu->comp_unit_obstack) partial_die_info (*pdi));
+  else
+    add_partial_symbol (pdi, cu);
 }
 
-/* Load all DIEs that are interesting for partial symbols into memory.  */
+/* Load all DIEs that are interesting for partial symbols into memory.
+
+   If DEFERRED is not NULL, then no partial symbols are created.
+   Instead, the partial DIEs whose symbols would have been added
+   directly are appended to DEFERRED, in order.  */
 
 static struct partial_die_info *
 load_partial_dies (const struct die_reader_specs *reader,
-		   const gdb_byte *info_ptr, int building_psymtab)
+		   const gdb_byte *info_ptr, int building_psymtab,
+		   std::vector<partial_die_info *> *deferred)
 {
   struct dwarf2_cu *cu = reader->cu;
   struct objfile *objfile = cu->per_objfile->objfile;
@@ -18753,23 +19441,9 @@ load_partial_dies (const struct die_reader_specs *reader,
 	  continue;
 	}
 
-      /* Check whether this DIE is interesting enough to save.  Normally
-	 we would not be interested in members here, but there may be
-	 later variables referencing them via DW_AT_specification (for
-	 static members).  */
-      if (!load_all
-	  && !is_type_tag_for_partial (abbrev->tag)
-	  && abbrev->tag != DW_TAG_constant
-	  && abbrev->tag != DW_TAG_enumerator
-	  && abbrev->tag != DW_TAG_subprogram
-	  && abbrev->tag != DW_TAG_inlined_subroutine
-	  && abbrev->tag != DW_TAG_lexical_block
-	  && abbrev->tag != DW_TAG_variable
-	  && abbrev->tag != DW_TAG_namespace
-	  && abbrev->tag != DW_TAG_module
-	  && abbrev->tag != DW_TAG_member
-	  && abbrev->tag != DW_TAG_imported_unit
-	  && abbrev->tag != DW_TAG_imported_declaration)
+      /* Check whether this DIE is interesting enough to save.  This is
+	 precomputed for each abbrev, see abbrev_table::read.  */
+      if (!load_all && !abbrev->interesting)
 	{
 	  /* Otherwise we skip to the next sibling, if any.  */
 	  info_ptr = skip_one_die (reader, info_ptr + bytes_read, abbrev);
@@ -18805,7 +19479,7 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || pdi.tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && pdi.raw_name != NULL)
-	    add_partial_symbol (&pdi, cu);
+	    add_or_defer_partial_symbol (&pdi, cu, deferred);
 
 	  info_ptr = locate_pdi_sibling (reader, &pdi, info_ptr);
 	  continue;
@@ -18837,7 +19511,7 @@ load_partial_dies (const struct die_reader_specs *reader,
 	  if (pdi.raw_name == NULL)
 	    complaint (_("malformed enumerator DIE ignored"));
 	  else if (building_psymtab)
-	    add_partial_symbol (&pdi, cu);
+	    add_or_defer_partial_symbol (&pdi, cu, deferred);
 
 	  info_ptr = locate_pdi_sibling (reader, &pdi, info_ptr);
 	  continue;
@@ -19927,6 +20601,58 @@ read_attribute_value (const struct die_reader_specs *reader,
   return info_ptr;
 }
 
+/* Read the value of an attribute described by ABBREV, for which
+   ABBREV->direct is true, from INFO_PTR into ATTR.  This is a fast path
+   of read_attribute_value for the most common forms.  */
+
+static inline const gdb_byte *
+read_direct_attribute_value (const struct die_reader_specs *reader,
+			     struct attribute *attr,
+			     const struct attr_abbrev *abbrev,
+			     const gdb_byte *info_ptr)
+{
+  bfd *abfd = reader->abfd;
+  ULONGEST cu_off = to_underlying (reader->cu->header.sect_off);
+
+  attr->form = abbrev->form;
+  switch (abbrev->form)
+    {
+    case DW_FORM_flag_present:
+      DW_UNSND (attr) = 1;
+      return info_ptr;
+    case DW_FORM_implicit_const:
+      DW_SND (attr) = abbrev->implicit_const;
+      return info_ptr;
+    case DW_FORM_data1:
+    case DW_FORM_flag:
+      DW_UNSND (attr) = read_1_byte (abfd, info_ptr);
+      return info_ptr + 1;
+    case DW_FORM_data2:
+      DW_UNSND (attr) = read_2_bytes (abfd, info_ptr);
+      return info_ptr + 2;
+    case DW_FORM_data4:
+      DW_UNSND (attr) = read_4_bytes (abfd, info_ptr);
+      return info_ptr + 4;
+    case DW_FORM_data8:
+      DW_UNSND (attr) = read_8_bytes (abfd, info_ptr);
+      return info_ptr + 8;
+    case DW_FORM_ref1:
+      DW_UNSND (attr) = cu_off + read_1_byte (abfd, info_ptr);
+      return info_ptr + 1;
+    case DW_FORM_ref2:
+      DW_UNSND (attr) = cu_off + read_2_bytes (abfd, info_ptr);
+      return info_ptr + 2;
+    case DW_FORM_ref4:
+      DW_UNSND (attr) = cu_off + read_4_bytes (abfd, info_ptr);
+      return info_ptr + 4;
+    case DW_FORM_ref8:
+      DW_UNSND (attr) = cu_off + read_8_bytes (abfd, info_ptr);
+      return info_ptr + 8;
+    default:
+      gdb_assert_not_reached ("unexpected form in direct attribute");
+    }
+}
+
 /* Read an attribute described by an abbreviated attribute.  */
 
 static const gdb_byte *
@@ -19935,6 +20661,15 @@ read_attribute (const struct die_reader_specs *reader,
 		const gdb_byte *info_ptr, bool *need_reprocess)
 {
   attr->name = abbrev->name;
+
+  /* References in a dwz file are turned into DW_FORM_GNU_ref_alt by
+     read_attribute_value.  */
+  if (abbrev->direct && !reader->cu->per_cu->is_dwz)
+    {
+      *need_reprocess = false;
+      return read_direct_attribute_value (reader, attr, abbrev, info_ptr);
+    }
+
   return read_attribute_value (reader, attr, abbrev->form,
 			       abbrev->implicit_const, info_ptr,
 			       need_reprocess);
@@ -24198,6 +24933,108 @@ run_test ()
   SELF_CHECK (units[result] == &four);
 }
 
+}
+
+namespace parallel_demangle {
+
+/* Add to CU a DIE with tag TAG as the first child of PARENT, with
+   linkage name LINKAGE_NAME in attribute ATTR if that is not NULL.  */
+
+static die_info *
+add_die (dwarf2_cu *cu, die_info *parent, dwarf_tag tag,
+	 dwarf_attribute attr, const char *linkage_name)
+{
+  die_info *die = dwarf_alloc_die (cu, 1);
+
+  die->tag = tag;
+  if (linkage_name != nullptr)
+    {
+      die->num_attrs = 1;
+      die->attrs[0].name = attr;
+      die->attrs[0].form = DW_FORM_string;
+      DW_STRING (&die->attrs[0])
+	= obstack_strdup (&cu->comp_unit_obstack, linkage_name);
+    }
+
+  if (parent != nullptr)
+    {
+      die->parent = parent;
+      die->sibling = parent->child;
+      parent->child = die;
+      parent->has_children = 1;
+    }
+
+  return die;
+}
+
+/* Check that the physnames dwarf2_physname computes for the DIEs of a
+   CU are the same whether the linkage names of the CU were demangled
+   in parallel beforehand or are demangled one at a time.  */
+
+static void
+run_test ()
+{
+  objfile_up objfile (objfile::make (nullptr, "<< selftest >>",
+				     OBJF_NOT_FILENAME));
+  dwarf2_per_objfile per_objfile (objfile.get (), nullptr);
+  dwarf2_per_cu_data per_cu {};
+  dwarf2_cu cu (&per_cu, &per_objfile);
+
+  cu.language = language_cplus;
+  cu.language_defn = language_def (cu.language);
+
+  die_info *cu_die = add_die (&cu, nullptr, DW_TAG_compile_unit,
+			      DW_AT_name, nullptr);
+  cu.dies = cu_die;
+
+  std::vector<die_info *> subprograms;
+  subprograms.push_back (add_die (&cu, cu_die, DW_TAG_subprogram,
+				  DW_AT_linkage_name, "_Z3fooi"));
+  subprograms.push_back (add_die (&cu, cu_die, DW_TAG_subprogram,
+				  DW_AT_linkage_name, "main"));
+  subprograms.push_back (add_die (&cu, cu_die, DW_TAG_subprogram,
+				  DW_AT_linkage_name, "_Z1fIiEvT_"));
+
+  die_info *ns_die = add_die (&cu, cu_die, DW_TAG_namespace,
+			      DW_AT_name, nullptr);
+  subprograms.push_back (add_die (&cu, ns_die, DW_TAG_subprogram,
+				  DW_AT_linkage_name, "_ZN2ns3barEv"));
+  subprograms.push_back (add_die (&cu, ns_die, DW_TAG_subprogram,
+				  DW_AT_MIPS_linkage_name, "_ZN2ns3bazEd"));
+
+  /* Enough names for the work to be split between threads.  */
+  for (int i = 0; i < 1000; ++i)
+    {
+      std::string name = "f" + std::to_string (i);
+      std::string mangled
+	= "_Z" + std::to_string (name.size ()) + name + "i";
+
+      subprograms.push_back (add_die (&cu, cu_die, DW_TAG_subprogram,
+				      DW_AT_linkage_name, mangled.c_str ()));
+    }
+
+  /* With no names demangled beforehand, dwarf2_physname demangles
+     each of them itself.  */
+  std::vector<std::string> serial;
+  for (die_info *die : subprograms)
+    serial.emplace_back (dwarf2_physname (nullptr, die, &cu));
+
+  demangle_linkage_names (&cu);
+
+  SELF_CHECK (cu.demangled_linkage_names.size () == subprograms.size ());
+  SELF_CHECK (cu.demangled_linkage_names.at (dw2_linkage_name
+					     (subprograms[1], &cu))
+	      == nullptr);
+
+  for (size_t i = 0; i < subprograms.size (); ++i)
+    SELF_CHECK (serial[i] == dwarf2_physname (nullptr, subprograms[i], &cu));
+
+  SELF_CHECK (serial[0] == "foo(int)");
+  SELF_CHECK (serial[1] == "main");
+  SELF_CHECK (serial[3] == "ns::bar()");
+  SELF_CHECK (serial[4] == "ns::baz(double)");
+}
+
 }
 }
 
@@ -24315,6 +25152,9 @@ dwarf2_per_objfile::remove_cu (dwarf2_per_cu_data *per_cu)
 
 dwarf2_per_objfile::~dwarf2_per_objfile ()
 {
+  /* The index cache may still be writing the index of this objfile.  */
+  global_index_cache.wait_for_store (this);
+
   remove_all_cus ();
 }
 
@@ -24678,5 +25518,7 @@ Warning: This option must be enabled before gdb reads the file."),
 			    selftests::dw2_expand_symtabs_matching::run_test);
   selftests::register_test ("dwarf2_find_containing_comp_unit",
 			    selftests::find_containing_comp_unit::run_test);
+  selftests::register_test ("dwarf2_demangle_linkage_names",
+			    selftests::parallel_demangle::run_test);
 #endif
 }
@@ -1074,6 +1074,22 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
       return;
     }
 
+  /* The readers of stabs, mdebug and CTF debug info need the symbol
+     tables read below, and some architectures record special symbols
+     while reading them, so only use the index cache without those.  */
+  struct gdbarch *gdbarch = objfile->arch ();
+  bool use_index_cache = (ei->stabsect == NULL
+			  && ei->mdebugsect == NULL
+			  && ei->ctfsect == NULL
+			  && !gdbarch_record_special_symbol_p (gdbarch));
+  if (use_index_cache && install_minimal_symbols_from_index_cache (objfile))
+    {
+      if (symtab_create_debug)
+	fprintf_unfiltered (gdb_stdlog,
+			    "... minimal symbols read from the index cache\n");
+      return;
+    }
+
   minimal_symbol_reader reader (objfile);
 
   /* Process the normal ELF symbol table first.  */
@@ -1174,6 +1190,9 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
 
   reader.install ();
 
+  if (use_index_cache)
+    store_minimal_symbols_in_index_cache (objfile);
+
   if (symtab_create_debug)
     fprintf_unfiltered (gdb_stdlog, "Done reading minimal symbols.\n");
 }
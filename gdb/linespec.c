@@ -149,6 +149,10 @@ struct linespec_state
      space.  */
   struct program_space *search_pspace;
 
+  /* If not NULL, the search is restricted to just this objfile.  See
+     decode_line_matches_objfile.  */
+  struct objfile *search_objfile;
+
   /* The default symtab to use, if no other symtab is specified.  */
   struct symtab *default_symtab;
 
@@ -363,7 +367,7 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct program_space *pspace, struct objfile *objfile);
 
 static std::vector<block_symbol> *find_label_symbols
   (struct linespec_state *self, std::vector<block_symbol> *function_symbols,
@@ -396,7 +400,8 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct program_space *pspace,
+				 struct objfile *objfile);
 
 static std::vector<symtab_and_line> decode_digits_ordinary
   (struct linespec_state *self,
@@ -1121,7 +1126,8 @@ maybe_add_address (htab_t set, struct program_space *pspace, CORE_ADDR addr)
 /* A helper that walks over all matching symtabs in all objfiles and
    calls CALLBACK for each symbol matching NAME.  If SEARCH_PSPACE is
    not NULL, then the search is restricted to just that program
-   space.  If INCLUDE_INLINE is true then symbols representing
+   space.  If STATE->SEARCH_OBJFILE is not NULL, then the search is
+   restricted to just that objfile.  If INCLUDE_INLINE is true then symbols representing
    inlined instances of functions will be included in the result.  */
 
 static void
@@ -1144,6 +1150,10 @@ iterate_over_all_matching_symtabs
 
       for (objfile *objfile : current_program_space->objfiles ())
 	{
+	  if (state->search_objfile != NULL
+	      && objfile != state->search_objfile)
+	    continue;
+
 	  if (objfile->sf)
 	    objfile->sf->qf->expand_symtabs_matching (objfile,
 						      NULL,
@@ -2103,7 +2113,8 @@ create_sals_line_offset (struct linespec_state *self,
       initialize_defaults (&self->default_symtab, &self->default_line);
       *ls->file_symtabs
 	= collect_symtabs_from_filename (self->default_symtab->filename,
-					 self->search_pspace);
+					 self->search_pspace,
+					 self->search_objfile);
       use_default = 1;
     }
 
@@ -2386,7 +2397,8 @@ convert_explicit_location_to_linespec (struct linespec_state *self,
       try
 	{
 	  *result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self->search_pspace,
+				     self->search_objfile);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2611,7 +2623,8 @@ parse_linespec (linespec_parser *parser, const char *arg,
 	{
 	  *PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser)->search_pspace,
+				     PARSER_STATE (parser)->search_objfile);
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3265,6 +3278,56 @@ decode_line_full (const struct event_location *location, int flags,
 
 /* See linespec.h.  */
 
+bool
+decode_line_matches_objfile (const struct event_location *location,
+			     struct objfile *objfile,
+			     const char *filter)
+{
+  struct linespec_result canonical;
+  struct linespec_state *state;
+  std::vector<symtab_and_line> result;
+
+  linespec_parser parser (0, current_language, objfile->pspace,
+			  NULL, 0, &canonical);
+  state = PARSER_STATE (&parser);
+  state->search_objfile = objfile;
+
+  scoped_restore_current_program_space restore_pspace;
+
+  try
+    {
+      result = event_location_to_sals (&parser, location);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      if (e.error == NOT_FOUND_ERROR)
+	return false;
+      throw;
+    }
+
+  /* Arrange for allocated canonical names to be freed.  */
+  std::vector<gdb::unique_xmalloc_ptr<char>> hold_names;
+  for (int i = 0; i < result.size (); ++i)
+    {
+      gdb_assert (state->canonical_names[i].suffix != NULL);
+      hold_names.emplace_back (state->canonical_names[i].suffix);
+    }
+
+  if (filter == NULL)
+    return !result.empty ();
+
+  std::vector<const char *> filters;
+  filters.push_back (filter);
+  filter_results (state, &result, filters);
+
+  for (const linespec_sals &lsal : canonical.lsals)
+    if (!lsal.sals.empty ())
+      return true;
+  return false;
+}
+
+/* See linespec.h.  */
+
 std::vector<symtab_and_line>
 decode_line_1 (const struct event_location *location, int flags,
 	       struct program_space *search_pspace,
@@ -3773,16 +3836,23 @@ symtab_collector::operator () (struct symtab *symtab)
 
 /* Given a file name, return a list of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   program space.  If SEARCH_OBJFILE is not NULL, the search is
+   restricted to just that objfile.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct program_space *search_pspace,
+			       struct objfile *search_objfile)
 {
   symtab_collector collector;
 
   /* Find that file's data.  */
-  if (search_pspace == NULL)
+  if (search_objfile != NULL)
+    {
+      set_current_program_space (search_objfile->pspace);
+      iterate_over_objfile_symtabs (search_objfile, file, collector);
+    }
+  else if (search_pspace == NULL)
     {
       for (struct program_space *pspace : program_spaces)
         {
@@ -3803,14 +3873,18 @@ collect_symtabs_from_filename (const char *file,
 }
 
 /* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+   not NULL, the search is restricted to just that program space.  If
+   SEARCH_OBJFILE is not NULL, the search is restricted to just that
+   objfile.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct program_space *search_pspace,
+		       struct objfile *search_objfile)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, search_pspace,
+				     search_objfile);
 
   if (result.empty ())
     {
@@ -4318,8 +4392,9 @@ add_minsym (struct minimal_symbol *minsym, struct objfile *objfile,
    is not NULL, the search is restricted to just that program
    space.
 
-   If SYMTAB is NULL, search all objfiles, otherwise
-   restrict results to the given SYMTAB.  */
+   If SYMTAB is NULL, search all objfiles (or just
+   INFO->STATE->SEARCH_OBJFILE, if not NULL), otherwise restrict
+   results to the given SYMTAB.  */
 
 static void
 search_minsyms_for_name (struct collect_info *info,
@@ -4342,6 +4417,10 @@ search_minsyms_for_name (struct collect_info *info,
 
 	  for (objfile *objfile : current_program_space->objfiles ())
 	    {
+	      if (info->state->search_objfile != NULL
+		  && objfile != info->state->search_objfile)
+		continue;
+
 	      iterate_over_minimal_symbols (objfile, name,
 					    [&] (struct minimal_symbol *msym)
 					    {
@@ -131,6 +131,17 @@ extern void decode_line_full (const struct event_location *location, int flags,
 			      const char *select_mode,
 			      const char *filter);
 
+/* Decode LOCATION like decode_line_full does, but only look for
+   matches in OBJFILE.  Return true if any location is found.  FILTER
+   is as for decode_line_full.  This is used to tell whether adding
+   OBJFILE may change the locations LOCATION resolves to: if no match
+   is found in OBJFILE, the result of decoding LOCATION across all the
+   objfiles is the same as before OBJFILE was added.  */
+
+extern bool decode_line_matches_objfile
+  (const struct event_location *location, struct objfile *objfile,
+   const char *filter);
+
 /* Given a string, return the line specified by it, using the current
    source symtab and line as defaults.
    This is for commands like "list" and "breakpoint".  */
@@ -31,6 +31,7 @@
 #include "nat/linux-ptrace.h"
 #include "nat/linux-procfs.h"
 #include "nat/linux-personality.h"
+#include "nat/linux-memory.h"
 #include "linux-fork.h"
 #include "gdbthread.h"
 #include "gdbcmd.h"
@@ -928,6 +929,9 @@ delete_lwp (ptid_t ptid)
   /* Remove from sorted-by-creation-order list.  */
   lwp_list_remove (lp);
 
+  /* Don't keep reading memory through the files of gone threads.  */
+  linux_proc_mem_lwp_exited (ptid);
+
   /* Release.  */
   lwp_free (lp);
 }
@@ -2091,6 +2095,9 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
       ourstatus->value.execd_pathname
 	= xstrdup (linux_proc_pid_to_exec_file (pid));
 
+      /* The memory file of the old program reads nothing.  */
+      linux_proc_mem_close (lp->ptid.pid ());
+
       /* The thread that execed must have been resumed, but, when a
 	 thread execs, it changes its tid to the tgid, and the old
 	 tgid thread might have not been resumed.  */
@@ -3759,6 +3766,9 @@ linux_nat_target::mourn_inferior ()
 
   purge_lwp_list (pid);
 
+  /* Don't keep the /proc/LWP/mem file of a thread of PID open.  */
+  linux_proc_mem_close (pid);
+
   if (! forks_exist_p ())
     /* Normal case, no other forks available.  */
     inf_ptrace_target::mourn_inferior ();
@@ -3856,6 +3866,20 @@ linux_proc_xfer_partial (enum target_object object,
 			 const gdb_byte *writebuf,
 			 ULONGEST offset, LONGEST len, ULONGEST *xfered_len);
 
+/* Mask ADDR to the address width of the inferior.  */
+
+static ULONGEST
+linux_nat_mask_address (ULONGEST addr)
+{
+  int addr_bit = gdbarch_addr_bit (target_gdbarch ());
+
+  /* Compare ADDR_BIT first to avoid a compiler warning on shift
+     overflow.  */
+  if (addr_bit < (sizeof (ULONGEST) * HOST_CHAR_BIT))
+    addr &= ((ULONGEST) 1 << addr_bit) - 1;
+  return addr;
+}
+
 enum target_xfer_status
 linux_nat_target::xfer_partial (enum target_object object,
 				const char *annex, gdb_byte *readbuf,
@@ -3885,17 +3909,10 @@ linux_nat_target::xfer_partial (enum target_object object,
   /* GDB calculates all addresses in the largest possible address
      width.
      The address width must be masked before its final use - either by
-     linux_proc_xfer_partial or inf_ptrace_target::xfer_partial.
-
-     Compare ADDR_BIT first to avoid a compiler warning on shift overflow.  */
+     linux_proc_xfer_partial or inf_ptrace_target::xfer_partial.  */
 
   if (object == TARGET_OBJECT_MEMORY)
-    {
-      int addr_bit = gdbarch_addr_bit (target_gdbarch ());
-
-      if (addr_bit < (sizeof (ULONGEST) * HOST_CHAR_BIT))
-	offset &= ((ULONGEST) 1 << addr_bit) - 1;
-    }
+    offset = linux_nat_mask_address (offset);
 
   xfer = linux_proc_xfer_partial (object, annex, readbuf, writebuf,
 				  offset, len, xfered_len);
@@ -3906,6 +3923,32 @@ linux_nat_target::xfer_partial (enum target_object object,
 					  offset, len, xfered_len);
 }
 
+/* Implement the "read_memory_multiple" target_ops method, with as few
+   process_vm_readv calls as possible.  */
+
+bool
+linux_nat_target::read_memory_multiple
+  (gdb::array_view<memory_read_request> requests)
+{
+  if (inferior_ptid == null_ptid || inferior_ptid.lwp () == 0)
+    return false;
+
+  std::vector<linux_memory_block> blocks (requests.size ());
+  for (size_t i = 0; i < requests.size (); i++)
+    {
+      blocks[i].addr = linux_nat_mask_address (requests[i].addr);
+      blocks[i].buf = requests[i].buf;
+      blocks[i].len = requests[i].len;
+    }
+
+  linux_proc_read_memory_multiple (inferior_ptid, blocks.data (),
+				   blocks.size ());
+
+  for (size_t i = 0; i < requests.size (); i++)
+    requests[i].xfered_len = blocks[i].xfered_len;
+  return true;
+}
+
 bool
 linux_nat_target::thread_alive (ptid_t ptid)
 {
@@ -3964,9 +4007,10 @@ linux_nat_target::pid_to_exec_file (int pid)
   return linux_proc_pid_to_exec_file (pid);
 }
 
-/* Implement the to_xfer_partial target method using /proc/<pid>/mem.
-   Because we can use a single read/write call, this can be much more
-   efficient than banging away at PTRACE_PEEKTEXT.  */
+/* Implement the to_xfer_partial target method using process_vm_readv,
+   process_vm_writev and /proc/<pid>/mem.  Because we can use a single
+   system call, this can be much more efficient than banging away at
+   PTRACE_PEEKTEXT.  */
 
 static enum target_xfer_status
 linux_proc_xfer_partial (enum target_object object,
@@ -3974,42 +4018,17 @@ linux_proc_xfer_partial (enum target_object object,
 			 const gdb_byte *writebuf,
 			 ULONGEST offset, LONGEST len, ULONGEST *xfered_len)
 {
-  LONGEST ret;
-  int fd;
-  char filename[64];
+  size_t ret;
 
   if (object != TARGET_OBJECT_MEMORY)
     return TARGET_XFER_EOF;
 
-  /* Don't bother for one word.  */
-  if (len < 3 * sizeof (long))
-    return TARGET_XFER_EOF;
-
-  /* We could keep this file open and cache it - possibly one per
-     thread.  That requires some juggling, but is even faster.  */
-  xsnprintf (filename, sizeof filename, "/proc/%ld/mem",
-	     inferior_ptid.lwp ());
-  fd = gdb_open_cloexec (filename, ((readbuf ? O_RDONLY : O_WRONLY)
-				    | O_LARGEFILE), 0);
-  if (fd == -1)
-    return TARGET_XFER_EOF;
-
-  /* Use pread64/pwrite64 if available, since they save a syscall and can
-     handle 64-bit offsets even on 32-bit platforms (for instance, SPARC
-     debugging a SPARC64 application).  */
-#ifdef HAVE_PREAD64
-  ret = (readbuf ? pread64 (fd, readbuf, len, offset)
-	 : pwrite64 (fd, writebuf, len, offset));
-#else
-  ret = lseek (fd, offset, SEEK_SET);
-  if (ret != -1)
-    ret = (readbuf ? read (fd, readbuf, len)
-	   : write (fd, writebuf, len));
-#endif
-
-  close (fd);
+  if (readbuf != NULL)
+    ret = linux_proc_read_memory (inferior_ptid, offset, readbuf, len);
+  else
+    ret = linux_proc_write_memory (inferior_ptid, offset, writebuf, len);
 
-  if (ret == -1 || ret == 0)
+  if (ret == 0)
     return TARGET_XFER_EOF;
   else
     {
@@ -1278,7 +1278,7 @@ When enabled GDB is profiled."),
 Set the number of worker threads GDB can use."), _("\
 Show the number of worker threads GDB can use."), _("\
 GDB may use multiple threads to speed up certain CPU-intensive operations,\n\
-such as demangling symbol names."),
+such as demangling symbol names and reading DWARF debugging information."),
 				       maintenance_set_worker_threads, NULL,
 				       &maintenance_set_cmdlist,
 				       &maintenance_show_cmdlist);
@@ -54,6 +54,10 @@
 #include <algorithm>
 #include "safe-ctype.h"
 #include "gdbsupport/parallel-for.h"
+#include "gdbsupport/version.h"
+#include "build-id.h"
+#include "dwarf2/index-cache.h"
+#include <unordered_map>
 
 #if CXX_STD_THREAD
 #include <mutex>
@@ -1460,6 +1464,353 @@ minimal_symbol_reader::install ()
     }
 }
 
+/* Minimal symbol tables in the index cache.
+
+   When "set index-cache minimal-symbols" is on, the minimal symbol
+   table of an ELF file is written to the index cache once it is
+   installed, and is loaded from there the next time the file is read,
+   instead of reading, sorting and demangling the symbols of the file
+   again.  The cache file holds a minsyms_cache_header, a
+   minsyms_cache_record for each minimal symbol in table order, and the
+   strings the records refer to.  The file is mapped in memory and the
+   names of the symbols point into it.
+
+   The file is only meant to be read by the GDB that wrote it, on the
+   same host: values are in host byte order, and the hash values are
+   those computed by this version of GDB.  */
+
+#define MINSYMS_CACHE_MAGIC "GDB-MINSYMS"
+#define MINSYMS_CACHE_VERSION 1
+
+/* The offset of a missing string.  */
+#define MINSYMS_CACHE_NO_STRING ((uint32_t) -1)
+
+/* Bits of minsyms_cache_record::flags.  */
+#define MINSYMS_CACHE_CREATED_BY_GDB	0x01
+#define MINSYMS_CACHE_TARGET_FLAG_1	0x02
+#define MINSYMS_CACHE_TARGET_FLAG_2	0x04
+#define MINSYMS_CACHE_HAS_SIZE		0x08
+#define MINSYMS_CACHE_MAYBE_COPIED	0x10
+
+struct minsyms_cache_header
+{
+  char magic[12];
+  uint32_t format_version;
+
+  /* The version of GDB which wrote the file.  */
+  char gdb_version[64];
+
+  /* The size of the file the symbols were read from.  Stripped and
+     unstripped copies of a file have the same build id.  */
+  uint64_t bfd_size;
+
+  uint32_t record_size;
+  uint32_t count;
+  uint64_t strings_size;
+};
+
+struct minsyms_cache_record
+{
+  uint64_t value;
+  uint64_t size;
+
+  /* Offsets in the string table, or MINSYMS_CACHE_NO_STRING.  */
+  uint32_t linkage_name;
+  uint32_t demangled_name;
+  uint32_t filename;
+
+  /* The hash values computed by minimal_symbol_reader::install.  */
+  uint32_t mangled_name_hash;
+  uint32_t minsym_hash;
+  uint32_t minsym_demangled_hash;
+
+  int16_t section;
+  uint8_t type;
+  uint8_t language;
+  uint8_t flags;
+  uint8_t padding[3];
+};
+
+/* Return true if the minimal symbols of OBJFILE may be stored in, or
+   loaded from, the index cache.  Return the build id of OBJFILE in
+   *BUILD_ID.  */
+
+static bool
+minsyms_cache_usable_p (struct objfile *objfile,
+			const bfd_build_id **build_id)
+{
+  if (!global_index_cache.minsyms_enabled ())
+    return false;
+
+  /* The cache file stores host integers.  */
+  if (sizeof (CORE_ADDR) > sizeof (uint64_t))
+    return false;
+
+  *build_id = build_id_bfd_get (objfile->obfd);
+  return *build_id != nullptr;
+}
+
+/* See minsyms.h.  */
+
+void
+store_minimal_symbols_in_index_cache (struct objfile *objfile)
+{
+  const bfd_build_id *build_id;
+  if (!minsyms_cache_usable_p (objfile, &build_id))
+    return;
+
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  int mcount = per_bfd->minimal_symbol_count;
+
+  /* Nothing to store, or the symbols were loaded from the cache.  */
+  if (mcount == 0 || per_bfd->minsyms_cache_resource != nullptr)
+    return;
+
+  std::vector<minsyms_cache_record> records (mcount);
+  std::string strings;
+
+  /* Many symbols share the same file name string.  */
+  std::unordered_map<const char *, uint32_t> filenames;
+
+  auto add_string = [&] (const char *str)
+    {
+      uint32_t offset = strings.size ();
+      strings.append (str, strlen (str) + 1);
+      return offset;
+    };
+
+  minimal_symbol *msymbols = per_bfd->msymbols.get ();
+  for (int i = 0; i < mcount; ++i)
+    {
+      minimal_symbol *msym = &msymbols[i];
+      minsyms_cache_record &rec = records[i];
+
+      rec.value = MSYMBOL_VALUE_RAW_ADDRESS (msym);
+      rec.size = msym->size;
+      rec.linkage_name = add_string (msym->linkage_name ());
+
+      /* The demangled name of an Ada symbol is not kept, see
+	 general_symbol_info::compute_and_set_names.  */
+      const char *demangled = (msym->language () == language_ada
+			       ? nullptr
+			       : msym->language_specific.demangled_name);
+      rec.demangled_name = (demangled != nullptr
+			    ? add_string (demangled)
+			    : MINSYMS_CACHE_NO_STRING);
+
+      rec.filename = MINSYMS_CACHE_NO_STRING;
+      if (msym->filename != nullptr)
+	{
+	  auto it = filenames.find (msym->filename);
+	  if (it != filenames.end ())
+	    rec.filename = it->second;
+	  else
+	    {
+	      rec.filename = add_string (msym->filename);
+	      filenames.emplace (msym->filename, rec.filename);
+	    }
+	}
+
+      rec.mangled_name_hash = fast_hash (msym->linkage_name (),
+					 strlen (msym->linkage_name ()));
+      rec.minsym_hash = msymbol_hash (msym->linkage_name ());
+      rec.minsym_demangled_hash
+	= (msym->search_name () != msym->linkage_name ()
+	   ? search_name_hash (msym->language (), msym->search_name ())
+	   : 0);
+
+      rec.section = msym->section;
+      rec.type = MSYMBOL_TYPE (msym);
+      rec.language = msym->language ();
+      rec.flags = ((msym->created_by_gdb ? MINSYMS_CACHE_CREATED_BY_GDB : 0)
+		   | (msym->target_flag_1 ? MINSYMS_CACHE_TARGET_FLAG_1 : 0)
+		   | (msym->target_flag_2 ? MINSYMS_CACHE_TARGET_FLAG_2 : 0)
+		   | (msym->has_size ? MINSYMS_CACHE_HAS_SIZE : 0)
+		   | (msym->maybe_copied ? MINSYMS_CACHE_MAYBE_COPIED : 0));
+
+      /* The offsets must fit, and must not be taken for a missing
+	 string.  */
+      if (strings.size () >= MINSYMS_CACHE_NO_STRING)
+	return;
+    }
+
+  minsyms_cache_header header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, MINSYMS_CACHE_MAGIC, sizeof (header.magic));
+  header.format_version = MINSYMS_CACHE_VERSION;
+  strncpy (header.gdb_version, version, sizeof (header.gdb_version) - 1);
+  header.bfd_size = bfd_get_size (objfile->obfd);
+  header.record_size = sizeof (minsyms_cache_record);
+  header.count = mcount;
+  header.strings_size = strings.size ();
+
+  std::vector<gdb_byte> contents;
+  size_t records_size = mcount * sizeof (minsyms_cache_record);
+  contents.resize (sizeof (header) + records_size + strings.size ());
+  memcpy (contents.data (), &header, sizeof (header));
+  memcpy (contents.data () + sizeof (header), records.data (), records_size);
+  memcpy (contents.data () + sizeof (header) + records_size,
+	  strings.data (), strings.size ());
+
+  global_index_cache.store_minsyms
+    (build_id, objfile->separate_debug_objfile_backlink != nullptr,
+     contents);
+}
+
+/* Return true if the cache file CONTENTS, mapped in memory, is a valid
+   minimal symbol table for OBJFILE.  */
+
+static bool
+minsyms_cache_valid_p (struct objfile *objfile,
+		       gdb::array_view<const gdb_byte> contents)
+{
+  minsyms_cache_header header;
+
+  if (contents.size () < sizeof (header))
+    return false;
+  memcpy (&header, contents.data (), sizeof (header));
+
+  if (memcmp (header.magic, MINSYMS_CACHE_MAGIC, sizeof (header.magic)) != 0
+      || header.format_version != MINSYMS_CACHE_VERSION
+      || strncmp (header.gdb_version, version,
+		  sizeof (header.gdb_version) - 1) != 0
+      || header.bfd_size != (uint64_t) bfd_get_size (objfile->obfd)
+      || header.record_size != sizeof (minsyms_cache_record)
+      || header.count == 0
+      || header.count > INT_MAX
+      || header.strings_size == 0)
+    return false;
+
+  size_t records_size = header.count * sizeof (minsyms_cache_record);
+  if (contents.size () != sizeof (header) + records_size + header.strings_size)
+    return false;
+
+  const char *strings
+    = (const char *) contents.data () + sizeof (header) + records_size;
+  if (strings[header.strings_size - 1] != '\0')
+    return false;
+
+  const minsyms_cache_record *records
+    = (const minsyms_cache_record *) (contents.data () + sizeof (header));
+  int n_sections = objfile->section_offsets.size ();
+  for (uint32_t i = 0; i < header.count; ++i)
+    {
+      const minsyms_cache_record &rec = records[i];
+
+      if (rec.linkage_name >= header.strings_size
+	  || (rec.demangled_name != MINSYMS_CACHE_NO_STRING
+	      && rec.demangled_name >= header.strings_size)
+	  || (rec.filename != MINSYMS_CACHE_NO_STRING
+	      && rec.filename >= header.strings_size)
+	  || rec.section < -1
+	  || rec.section >= n_sections
+	  || rec.type >= nr_minsym_types
+	  || rec.language >= nr_languages)
+	return false;
+    }
+
+  return true;
+}
+
+/* See minsyms.h.  */
+
+bool
+install_minimal_symbols_from_index_cache (struct objfile *objfile)
+{
+  const bfd_build_id *build_id;
+  if (!minsyms_cache_usable_p (objfile, &build_id))
+    return false;
+
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  if (per_bfd->minsyms_read || per_bfd->minimal_symbol_count != 0)
+    return false;
+
+  std::unique_ptr<index_cache_resource> resource;
+  gdb::array_view<const gdb_byte> contents
+    = global_index_cache.lookup_minsyms
+	(build_id, objfile->separate_debug_objfile_backlink != nullptr,
+	 &resource);
+  if (contents.empty ())
+    return false;
+
+  if (!minsyms_cache_valid_p (objfile, contents))
+    {
+      warning (_("Ignoring invalid minimal symbol table in the index "
+		 "cache for %s."), objfile_name (objfile));
+      return false;
+    }
+
+  minsyms_cache_header header;
+  memcpy (&header, contents.data (), sizeof (header));
+  int mcount = header.count;
+  const minsyms_cache_record *records
+    = (const minsyms_cache_record *) (contents.data () + sizeof (header));
+  const char *strings
+    = (const char *) (records + mcount);
+
+  if (symtab_create_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"Installing %d minimal symbols of objfile %s "
+			"from the index cache.\n",
+			mcount, objfile_name (objfile));
+
+  gdb::unique_xmalloc_ptr<minimal_symbol>
+    msym_holder (XCNEWVEC (minimal_symbol, mcount));
+  minimal_symbol *msymbols = msym_holder.get ();
+  std::vector<computed_hash_values> hash_values (mcount);
+
+  for (int i = 0; i < mcount; ++i)
+    {
+      const minsyms_cache_record &rec = records[i];
+      minimal_symbol *msym = &msymbols[i];
+
+      msym->set_language ((enum language) rec.language,
+			  &per_bfd->storage_obstack);
+      SET_MSYMBOL_VALUE_ADDRESS (msym, rec.value);
+      msym->size = rec.size;
+      msym->section = rec.section;
+      MSYMBOL_TYPE (msym) = (enum minimal_symbol_type) rec.type;
+      msym->created_by_gdb = (rec.flags & MINSYMS_CACHE_CREATED_BY_GDB) != 0;
+      msym->target_flag_1 = (rec.flags & MINSYMS_CACHE_TARGET_FLAG_1) != 0;
+      msym->target_flag_2 = (rec.flags & MINSYMS_CACHE_TARGET_FLAG_2) != 0;
+      msym->has_size = (rec.flags & MINSYMS_CACHE_HAS_SIZE) != 0;
+      msym->maybe_copied = (rec.flags & MINSYMS_CACHE_MAYBE_COPIED) != 0;
+      if (rec.filename != MINSYMS_CACHE_NO_STRING)
+	msym->filename = strings + rec.filename;
+
+      /* The names stay in the mapped file.  A demangled name is owned by
+	 the demangled names hash table, so it is copied.  */
+      msym->m_name = strings + rec.linkage_name;
+      if (rec.demangled_name != MINSYMS_CACHE_NO_STRING)
+	msym->set_demangled_name (xstrdup (strings + rec.demangled_name),
+				  &per_bfd->storage_obstack);
+      msym->name_set = 1;
+
+      hash_values[i].name_length = strlen (msym->m_name);
+      hash_values[i].mangled_name_hash = rec.mangled_name_hash;
+      hash_values[i].minsym_hash = rec.minsym_hash;
+      hash_values[i].minsym_demangled_hash = rec.minsym_demangled_hash;
+    }
+
+  per_bfd->minsyms_cache_resource = std::move (resource);
+  per_bfd->minimal_symbol_count = mcount;
+  per_bfd->msymbols = std::move (msym_holder);
+  per_bfd->n_minsyms += mcount;
+
+  /* Symbols with a demangled name are entered in the demangled names
+     hash table, which takes ownership of the demangled name.  The
+     others only need their linkage name, which is already set; this
+     avoids trying to demangle them again.  */
+  for (int i = 0; i < mcount; ++i)
+    if (records[i].demangled_name != MINSYMS_CACHE_NO_STRING)
+      msymbols[i].compute_and_set_names
+	(gdb::string_view (msymbols[i].m_name, hash_values[i].name_length),
+	 false, per_bfd, hash_values[i].mangled_name_hash);
+
+  build_minimal_symbol_hash_tables (objfile, hash_values);
+  return true;
+}
+
 /* Check if PC is in a shared library trampoline code stub.
    Return minimal symbol for the trampoline entry or NULL if PC is not
    in a trampoline code stub.  */
@@ -146,6 +146,18 @@ class minimal_symbol_reader
   int m_msym_count;
 };
 
+/* Install the minimal symbol table of OBJFILE from the index cache, if
+   "set index-cache minimal-symbols" is on and the cache holds a valid
+   table for it.  Return true if the table was installed, in which case
+   the symbols of OBJFILE need not be read.  */
+
+bool install_minimal_symbols_from_index_cache (struct objfile *objfile);
+
+/* Store the installed minimal symbol table of OBJFILE in the index
+   cache, if "set index-cache minimal-symbols" is on.  */
+
+void store_minimal_symbols_in_index_cache (struct objfile *objfile);
+
 
 
 /* Return whether MSYMBOL is a function/method.  If FUNC_ADDRESS_P is
@@ -0,0 +1,307 @@
+/* Linux memory access for GDB and gdbserver.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "gdbsupport/common-defs.h"
+#include "nat/linux-memory.h"
+#include "gdbsupport/filestuff.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unordered_map>
+#include <vector>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/* Whether process_vm_readv and process_vm_writev may work.  They are
+   missing before Linux 3.2.  */
+
+static bool process_vm_available = true;
+
+/* Handle systems without process_vm_readv and process_vm_writev.
+   Transfer COUNT blocks between LOCAL in this process and REMOTE in
+   thread PID, reading if WRITE is false.  Return the number of bytes
+   transferred, or -1.  */
+
+static ssize_t
+do_process_vm_xfer (pid_t pid, const struct iovec *local,
+		    const struct iovec *remote, size_t count, bool write)
+{
+#if defined __NR_process_vm_readv && defined __NR_process_vm_writev
+  if (process_vm_available)
+    {
+      ssize_t ret = syscall (write
+			     ? __NR_process_vm_writev
+			     : __NR_process_vm_readv,
+			     pid, local, count, remote, count, 0);
+
+      if (ret == -1 && errno == ENOSYS)
+	process_vm_available = false;
+      return ret;
+    }
+#endif
+  errno = ENOSYS;
+  return -1;
+}
+
+/* The /proc/LWP/mem file of a thread LWP of a process, kept open
+   between accesses to the memory of the process.  Opening it for each
+   access takes as many system calls as the access itself.  */
+
+struct proc_mem_file
+{
+  pid_t lwp;
+  int fd;
+};
+
+/* The files kept open, by process ID.  The file of any thread gives
+   access to the memory of the whole process, while the file of the
+   thread group leader stops working once the leader exits.  */
+
+static std::unordered_map<pid_t, proc_mem_file> proc_mem_files;
+
+/* See linux-memory.h.  */
+
+void
+linux_proc_mem_close (pid_t pid)
+{
+  auto it = proc_mem_files.find (pid);
+
+  if (it != proc_mem_files.end ())
+    {
+      close (it->second.fd);
+      proc_mem_files.erase (it);
+    }
+}
+
+/* See linux-memory.h.  */
+
+void
+linux_proc_mem_lwp_exited (ptid_t ptid)
+{
+  auto it = proc_mem_files.find (ptid.pid ());
+
+  if (it != proc_mem_files.end () && it->second.lwp == ptid.lwp ())
+    linux_proc_mem_close (ptid.pid ());
+}
+
+/* Return the /proc/LWP/mem file of the process of thread PTID, opening
+   it if it is not open yet or if REOPEN is true.  Return -1 if it
+   can't be opened.  */
+
+static int
+proc_mem_open (ptid_t ptid, bool reopen)
+{
+  auto it = proc_mem_files.find (ptid.pid ());
+
+  if (it != proc_mem_files.end ())
+    {
+      if (!reopen)
+	return it->second.fd;
+      linux_proc_mem_close (ptid.pid ());
+    }
+
+  char filename[64];
+  xsnprintf (filename, sizeof filename, "/proc/%ld/mem", ptid.lwp ());
+  int fd = gdb_open_cloexec (filename, O_RDWR | O_LARGEFILE, 0);
+  if (fd == -1)
+    fd = gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE, 0);
+  if (fd != -1)
+    proc_mem_files[ptid.pid ()] = { (pid_t) ptid.lwp (), fd };
+  return fd;
+}
+
+/* Transfer LEN bytes at MEMADDR of thread PTID with its /proc/LWP/mem
+   file, to READBUF if it is not NULL, or else from WRITEBUF.  Return
+   the number of bytes transferred, or -1.  */
+
+static ssize_t
+proc_mem_xfer (ptid_t ptid, CORE_ADDR memaddr, gdb_byte *readbuf,
+	       const gdb_byte *writebuf, size_t len)
+{
+  ssize_t ret = 0;
+
+  /* A file opened before the thread exec'd, or before its ID was
+     reused, reads and writes nothing; open it again then.  */
+  for (int attempt = 0; attempt < 2 && ret == 0; attempt++)
+    {
+      int fd = proc_mem_open (ptid, attempt > 0);
+
+      if (fd == -1)
+	return -1;
+
+      /* Use pread64/pwrite64 if available, since they save a syscall
+	 and can handle 64-bit offsets even on 32-bit platforms (for
+	 instance, SPARC debugging a SPARC64 application).  */
+#ifdef HAVE_PREAD64
+      ret = (readbuf != NULL
+	     ? pread64 (fd, readbuf, len, memaddr)
+	     : pwrite64 (fd, writebuf, len, memaddr));
+#else
+      ret = lseek (fd, memaddr, SEEK_SET);
+      if (ret != -1)
+	ret = (readbuf != NULL
+	       ? read (fd, readbuf, len)
+	       : write (fd, writebuf, len));
+#endif
+    }
+
+  return ret;
+}
+
+/* Transfer LEN bytes at MEMADDR of thread PTID, to READBUF if it is
+   not NULL, or else from WRITEBUF.  Return the number of bytes
+   transferred.  */
+
+static size_t
+linux_proc_xfer_memory (ptid_t ptid, CORE_ADDR memaddr, gdb_byte *readbuf,
+			const gdb_byte *writebuf, size_t len)
+{
+  size_t done = 0;
+
+  if ((CORE_ADDR) (uintptr_t) memaddr == memaddr)
+    {
+      struct iovec local, remote;
+      ssize_t ret;
+
+      local.iov_base = (readbuf != NULL
+			? (void *) readbuf : (void *) writebuf);
+      local.iov_len = len;
+      remote.iov_base = (void *) (uintptr_t) memaddr;
+      remote.iov_len = len;
+      ret = do_process_vm_xfer (ptid.lwp (), &local, &remote, 1,
+				readbuf == NULL);
+      if (ret > 0)
+	done = ret;
+    }
+
+  /* process_vm_readv and process_vm_writev only access memory the
+     thread itself could; /proc/PID/mem, like ptrace, can also write
+     to read-only code, for instance to insert breakpoints.  */
+  if (done < len)
+    {
+      ssize_t ret = proc_mem_xfer (ptid, memaddr + done,
+				   readbuf != NULL ? readbuf + done : NULL,
+				   writebuf != NULL ? writebuf + done : NULL,
+				   len - done);
+      if (ret > 0)
+	done += ret;
+    }
+
+  return done;
+}
+
+/* See linux-memory.h.  */
+
+size_t
+linux_proc_read_memory (ptid_t ptid, CORE_ADDR memaddr, gdb_byte *myaddr,
+			size_t len)
+{
+  return linux_proc_xfer_memory (ptid, memaddr, myaddr, NULL, len);
+}
+
+/* See linux-memory.h.  */
+
+size_t
+linux_proc_write_memory (ptid_t ptid, CORE_ADDR memaddr,
+			 const gdb_byte *myaddr, size_t len)
+{
+  return linux_proc_xfer_memory (ptid, memaddr, NULL, myaddr, len);
+}
+
+/* See linux-memory.h.  */
+
+void
+linux_proc_read_memory_multiple (ptid_t ptid, linux_memory_block *blocks,
+				 size_t count)
+{
+  std::vector<struct iovec> local, remote;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+    blocks[i].xfered_len = 0;
+
+  /* process_vm_readv reads the blocks in order, and stops at the first
+     one it can't read in full.  Go on from the one after.  */
+  i = 0;
+  while (i < count)
+    {
+      size_t n = std::min (count - i, (size_t) IOV_MAX);
+
+      local.resize (n);
+      remote.resize (n);
+      for (size_t j = 0; j < n; j++)
+	{
+	  const linux_memory_block &block = blocks[i + j];
+
+	  if ((CORE_ADDR) (uintptr_t) block.addr != block.addr)
+	    {
+	      n = j;
+	      break;
+	    }
+	  local[j].iov_base = block.buf;
+	  local[j].iov_len = block.len;
+	  remote[j].iov_base = (void *) (uintptr_t) block.addr;
+	  remote[j].iov_len = block.len;
+	}
+
+      ssize_t ret = 0;
+      if (n > 0)
+	{
+	  ret = do_process_vm_xfer (ptid.lwp (), local.data (),
+				    remote.data (), n, false);
+	  if (ret == -1)
+	    {
+	      /* Only a fault is specific to the first block.  */
+	      if (errno != EFAULT)
+		break;
+	      ret = 0;
+	    }
+	}
+
+      size_t left = ret;
+      size_t j = i;
+      for (; j < i + n && left >= blocks[j].len; j++)
+	{
+	  blocks[j].xfered_len = blocks[j].len;
+	  left -= blocks[j].len;
+	}
+      /* Skip the block that could not be read in full.  */
+      if (j < i + n || n == 0)
+	blocks[j++].xfered_len = left;
+      i = j;
+    }
+
+  /* Read what process_vm_readv could not with /proc/LWP/mem.  */
+  for (i = 0; i < count; i++)
+    {
+      linux_memory_block &block = blocks[i];
+
+      if (block.xfered_len < block.len)
+	{
+	  ssize_t ret = proc_mem_xfer (ptid, block.addr + block.xfered_len,
+				       block.buf + block.xfered_len, NULL,
+				       block.len - block.xfered_len);
+	  if (ret > 0)
+	    block.xfered_len += ret;
+	}
+    }
+}
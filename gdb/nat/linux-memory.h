@@ -0,0 +1,77 @@
+/* Linux memory access for GDB and gdbserver.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef NAT_LINUX_MEMORY_H
+#define NAT_LINUX_MEMORY_H
+
+#include <unistd.h>
+
+/* A block of memory to read with linux_proc_read_memory_multiple.  */
+
+struct linux_memory_block
+{
+  /* The address of the block in the inferior.  */
+  CORE_ADDR addr;
+
+  /* Where to store its contents.  */
+  gdb_byte *buf;
+
+  /* The length of the block.  */
+  size_t len;
+
+  /* The number of bytes read from ADDR.  */
+  size_t xfered_len;
+};
+
+/* Read LEN bytes of the memory of thread PTID starting at MEMADDR into
+   MYADDR, with process_vm_readv, or with /proc/LWP/mem for what it
+   can't read.  Return the number of bytes read, which is less than
+   LEN if the rest can't be read this way, and may be zero.  Callers
+   may then fall back to ptrace.  */
+
+extern size_t linux_proc_read_memory (ptid_t ptid, CORE_ADDR memaddr,
+				      gdb_byte *myaddr, size_t len);
+
+/* Like linux_proc_read_memory, but write LEN bytes from MYADDR, with
+   process_vm_writev, or with /proc/LWP/mem for what it can't write,
+   such as read-only code.  */
+
+extern size_t linux_proc_write_memory (ptid_t ptid, CORE_ADDR memaddr,
+				       const gdb_byte *myaddr, size_t len);
+
+/* Read the memory of the COUNT blocks at BLOCKS of thread PTID, with
+   as few system calls as possible.  Set the XFERED_LEN of each block to
+   the number of bytes read from its start.  */
+
+extern void linux_proc_read_memory_multiple (ptid_t ptid,
+					     linux_memory_block *blocks,
+					     size_t count);
+
+/* Close the /proc/LWP/mem file kept open between accesses to the
+   memory of process PID, if any.  Call this once the process is gone,
+   or when it execs.  */
+
+extern void linux_proc_mem_close (pid_t pid);
+
+/* Close the file kept open for the process of thread PTID if it is the
+   file of that thread.  Call this when the thread exits.  */
+
+extern void linux_proc_mem_lwp_exited (ptid_t ptid);
+
+#endif /* NAT_LINUX_MEMORY_H */
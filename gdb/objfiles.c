@@ -53,6 +53,7 @@
 #include "gdb_bfd.h"
 #include "btrace.h"
 #include "gdbsupport/pathstuff.h"
+#include "dwarf2/index-cache.h"
 
 #include <algorithm>
 #include <vector>
@@ -114,6 +115,11 @@ get_objfile_pspace_data (struct program_space *pspace)
 
 static const struct bfd_key<objfile_per_bfd_storage> objfiles_bfd_data;
 
+objfile_per_bfd_storage::objfile_per_bfd_storage ()
+  : minsyms_read (false)
+{
+}
+
 objfile_per_bfd_storage::~objfile_per_bfd_storage ()
 {
 }
@@ -39,6 +39,7 @@
 #include "jit.h"
 
 struct htab;
+struct index_cache_resource;
 struct objfile_data;
 struct partial_symbol;
 
@@ -266,12 +267,16 @@ struct minimal_symbol_iterator
 
 struct objfile_per_bfd_storage
 {
-  objfile_per_bfd_storage ()
-    : minsyms_read (false)
-  {}
+  objfile_per_bfd_storage ();
 
   ~objfile_per_bfd_storage ();
 
+  /* The file of the index cache the minimal symbols were loaded from,
+     if any.  Their names point into it, so it is declared first, to be
+     released last.  */
+
+  std::unique_ptr<index_cache_resource> minsyms_cache_resource;
+
   /* The storage has an obstack of its own.  */
 
   auto_obstack storage_obstack;
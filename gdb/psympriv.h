@@ -29,10 +29,11 @@
    contains their memory address, so we can find them from a PC value.
    Each partial_symbol sits in a partial_symtab, all of which are chained
    on a  partial symtab list and which points to the corresponding
-   normal symtab once the partial_symtab has been referenced.  */
+   normal symtab once the partial_symtab has been referenced.
 
-/* This structure is space critical.  See space comments at the top of
-   symtab.h.  */
+   Symbol readers fill in a partial_symbol and pass it to
+   add_psymbol_to_list, which stores it in the psymbol_pool of the
+   objfile.  psymbol_pool::get makes one back from the pool.  */
 
 struct partial_symbol
 {
@@ -65,9 +66,6 @@ struct partial_symbol
     ginfo.value.address = addr;
   }
 
-  /* Note that partial_symbol does not derive from general_symbol_info
-     due to the bcache.  See add_psymbol_to_bcache.  */
-
   struct general_symbol_info ginfo;
 
   /* Name space code.  */
@@ -270,7 +268,8 @@ struct partial_symtab
   /* Global symbol list.  This list will be sorted after readin to
      improve access.  Binary search will be the usual method of
      finding a symbol within it.  globals_offset is an integer offset
-     within global_psymbols[].  */
+     within global_psymbols[], whose entries are indices into the
+     psymbol_pool.  */
 
   int globals_offset = 0;
   int n_global_syms = 0;
@@ -34,32 +34,26 @@
 #include "language.h"
 #include "cp-support.h"
 #include "gdbcmd.h"
+#include "gdbsupport/selftest.h"
 #include <algorithm>
 #include <set>
 
-static struct partial_symbol *lookup_partial_symbol (struct objfile *,
-						     struct partial_symtab *,
-						     const lookup_name_info &,
-						     int,
-						     domain_enum);
+static gdb::optional<psymbol_index> lookup_partial_symbol
+  (struct objfile *, struct partial_symtab *, const lookup_name_info &, int,
+   domain_enum);
 
 static const char *psymtab_to_fullname (struct partial_symtab *ps);
 
-static struct partial_symbol *find_pc_sect_psymbol (struct objfile *,
-						    struct partial_symtab *,
-						    CORE_ADDR,
-						    struct obj_section *);
+static gdb::optional<psymbol_index> find_pc_sect_psymbol
+  (struct objfile *, struct partial_symtab *, CORE_ADDR,
+   struct obj_section *);
 
 static struct compunit_symtab *psymtab_to_symtab (struct objfile *objfile,
 						  struct partial_symtab *pst);
 
 
 
-static unsigned long psymbol_hash (const void *addr, int length);
-static int psymbol_compare (const void *addr1, const void *addr2, int length);
-
 psymtab_storage::psymtab_storage ()
-  : psymbol_cache (psymbol_hash, psymbol_compare)
 {
 }
 
@@ -242,24 +236,26 @@ find_pc_sect_psymtab_closer (struct objfile *objfile,
     {
       if (pc >= tpst->text_low (objfile) && pc < tpst->text_high (objfile))
 	{
-	  struct partial_symbol *p;
+	  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
 	  CORE_ADDR this_addr;
 
 	  /* NOTE: This assumes that every psymbol has a
 	     corresponding msymbol, which is not necessarily
 	     true; the debug info might be much richer than the
 	     object's symbol table.  */
-	  p = find_pc_sect_psymbol (objfile, tpst, pc, section);
-	  if (p != NULL
-	      && (p->address (objfile) == BMSYMBOL_VALUE_ADDRESS (msymbol)))
+	  gdb::optional<psymbol_index> p
+	    = find_pc_sect_psymbol (objfile, tpst, pc, section);
+	  if (p.has_value ()
+	      && (pool.address (*p, objfile)
+		  == BMSYMBOL_VALUE_ADDRESS (msymbol)))
 	    return tpst;
 
 	  /* Also accept the textlow value of a psymtab as a
 	     "symbol", to provide some support for partial
 	     symbol tables with line information but no debug
 	     symbols (e.g. those produced by an assembler).  */
-	  if (p != NULL)
-	    this_addr = p->address (objfile);
+	  if (p.has_value ())
+	    this_addr = pool.address (*p, objfile);
 	  else
 	    this_addr = tpst->text_low (objfile);
 
@@ -321,15 +317,14 @@ find_pc_sect_psymtab (struct objfile *objfile, CORE_ADDR pc,
 	     overlays and the addrmap returned the wrong section.  */
 	  if (overlay_debugging && msymbol.minsym != NULL && section != NULL)
 	    {
-	      struct partial_symbol *p;
-
 	      /* NOTE: This assumes that every psymbol has a
 		 corresponding msymbol, which is not necessarily
 		 true; the debug info might be much richer than the
 		 object's symbol table.  */
-	      p = find_pc_sect_psymbol (objfile, pst, pc, section);
-	      if (p == NULL
-		  || (p->address (objfile)
+	      gdb::optional<psymbol_index> p
+		= find_pc_sect_psymbol (objfile, pst, pc, section);
+	      if (!p.has_value ()
+		  || (objfile->partial_symtabs->psymbols.address (*p, objfile)
 		      != BMSYMBOL_VALUE_ADDRESS (msymbol)))
 		goto next;
 	    }
@@ -398,14 +393,15 @@ psym_find_pc_sect_compunit_symtab (struct objfile *objfile,
 }
 
 /* Find which partial symbol within a psymtab matches PC and SECTION.
-   Return NULL if none.  */
+   Return an empty optional if none.  */
 
-static struct partial_symbol *
+static gdb::optional<psymbol_index>
 find_pc_sect_psymbol (struct objfile *objfile,
 		      struct partial_symtab *psymtab, CORE_ADDR pc,
 		      struct obj_section *section)
 {
-  struct partial_symbol *best = NULL;
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+  gdb::optional<psymbol_index> best;
   CORE_ADDR best_pc;
   const CORE_ADDR textlow = psymtab->text_low (objfile);
 
@@ -414,56 +410,40 @@ find_pc_sect_psymbol (struct objfile *objfile,
   /* Cope with programs that start at address 0.  */
   best_pc = (textlow != 0) ? textlow - 1 : 0;
 
-  /* Search the global symbols as well as the static symbols, so that
-     find_pc_partial_function doesn't use a minimal symbol and thus
-     cache a bad endaddr.  */
-  for (int i = 0; i < psymtab->n_global_syms; i++)
+  auto search = [&] (const std::vector<psymbol_index> &list, int offset,
+		     int count)
     {
-      partial_symbol *p
-	= objfile->partial_symtabs->global_psymbols[psymtab->globals_offset
-						    + i];
-
-      if (p->domain == VAR_DOMAIN
-	  && p->aclass == LOC_BLOCK
-	  && pc >= p->address (objfile)
-	  && (p->address (objfile) > best_pc
-	      || (psymtab->text_low (objfile) == 0
-		  && best_pc == 0 && p->address (objfile) == 0)))
+      for (int i = 0; i < count; i++)
 	{
-	  if (section != NULL)  /* Match on a specific section.  */
-	    {
-	      if (!matching_obj_sections (p->obj_section (objfile),
-					  section))
-		continue;
-	    }
-	  best_pc = p->address (objfile);
-	  best = p;
-	}
-    }
+	  psymbol_index p = list[offset + i];
 
-  for (int i = 0; i < psymtab->n_static_syms; i++)
-    {
-      partial_symbol *p
-	= objfile->partial_symtabs->static_psymbols[psymtab->statics_offset
-						    + i];
-
-      if (p->domain == VAR_DOMAIN
-	  && p->aclass == LOC_BLOCK
-	  && pc >= p->address (objfile)
-	  && (p->address (objfile) > best_pc
-	      || (psymtab->text_low (objfile) == 0
-		  && best_pc == 0 && p->address (objfile) == 0)))
-	{
-	  if (section != NULL)  /* Match on a specific section.  */
+	  if (pool.domain (p) != VAR_DOMAIN || pool.aclass (p) != LOC_BLOCK)
+	    continue;
+
+	  CORE_ADDR addr = pool.address (p, objfile);
+	  if (pc >= addr
+	      && (addr > best_pc
+		  || (textlow == 0 && best_pc == 0 && addr == 0)))
 	    {
-	      if (!matching_obj_sections (p->obj_section (objfile),
-					  section))
-		continue;
+	      if (section != NULL)  /* Match on a specific section.  */
+		{
+		  if (!matching_obj_sections (pool.obj_section (p, objfile),
+					      section))
+		    continue;
+		}
+	      best_pc = addr;
+	      best = p;
 	    }
-	  best_pc = p->address (objfile);
-	  best = p;
 	}
-    }
+    };
+
+  /* Search the global symbols as well as the static symbols, so that
+     find_pc_partial_function doesn't use a minimal symbol and thus
+     cache a bad endaddr.  */
+  search (objfile->partial_symtabs->global_psymbols,
+	  psymtab->globals_offset, psymtab->n_global_syms);
+  search (objfile->partial_symtabs->static_psymbols,
+	  psymtab->statics_offset, psymtab->n_static_syms);
 
   return best;
 }
@@ -487,7 +467,7 @@ psym_lookup_symbol (struct objfile *objfile,
     {
       if (!ps->readin_p (objfile)
 	  && lookup_partial_symbol (objfile, ps, psym_lookup_name,
-				    psymtab_index, domain))
+				    psymtab_index, domain).has_value ())
 	{
 	  struct symbol *sym, *with_opaque = NULL;
 	  struct compunit_symtab *stab = psymtab_to_symtab (objfile, ps);
@@ -534,31 +514,31 @@ psym_lookup_global_symbol_language (struct objfile *objfile, const char *name,
 
   for (partial_symtab *ps : require_partial_symbols (objfile, true))
     {
-      struct partial_symbol *psym;
       if (ps->readin_p (objfile))
 	continue;
 
-      psym = lookup_partial_symbol (objfile, ps, lookup_name, 1, domain);
-      if (psym)
+      gdb::optional<psymbol_index> psym
+	= lookup_partial_symbol (objfile, ps, lookup_name, 1, domain);
+      if (psym.has_value ())
 	{
 	  *symbol_found_p = true;
-	  return psym->ginfo.language ();
+	  return objfile->partial_symtabs->psymbols.language (*psym);
 	}
     }
 
   return language_unknown;
 }
 
-/* Returns true if PSYM matches LOOKUP_NAME.  */
+/* Returns true if symbol PSYM of POOL matches LOOKUP_NAME.  */
 
 static bool
-psymbol_name_matches (partial_symbol *psym,
+psymbol_name_matches (const psymbol_pool &pool, psymbol_index psym,
 		      const lookup_name_info &lookup_name)
 {
-  const language_defn *lang = language_def (psym->ginfo.language ());
+  const language_defn *lang = language_def (pool.language (psym));
   symbol_name_matcher_ftype *name_match
     = lang->get_symbol_name_matcher (lookup_name);
-  return name_match (psym->ginfo.search_name (), lookup_name, NULL);
+  return name_match (pool.search_name (psym), lookup_name, NULL);
 }
 
 /* Look in PST for a symbol in DOMAIN whose name matches NAME.  Search
@@ -569,19 +549,20 @@ psymbol_name_matches (partial_symbol *psym,
    according to it (allowing binary search).  It must be compatible
    with MATCH.  Returns the symbol, if found, and otherwise NULL.  */
 
-static struct partial_symbol *
+static gdb::optional<psymbol_index>
 match_partial_symbol (struct objfile *objfile,
 		      struct partial_symtab *pst, int global,
 		      const lookup_name_info &name, domain_enum domain,
 		      symbol_compare_ftype *ordered_compare)
 {
-  struct partial_symbol **start, **psym;
-  struct partial_symbol **top, **real_top, **bottom, **center;
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+  const psymbol_index *start, *psym;
+  const psymbol_index *top, *real_top, *bottom, *center;
   int length = (global ? pst->n_global_syms : pst->n_static_syms);
   int do_linear_search = 1;
 
   if (length == 0)
-    return NULL;
+    return {};
 
   start = (global ?
 	   &objfile->partial_symtabs->global_psymbols[pst->globals_offset] :
@@ -605,11 +586,10 @@ match_partial_symbol (struct objfile *objfile,
 	  center = bottom + (top - bottom) / 2;
 	  gdb_assert (center < top);
 
-	  enum language lang = (*center)->ginfo.language ();
+	  enum language lang = pool.language (*center);
 	  const char *lang_ln = name.language_lookup_name (lang);
 
-	  if (ordered_compare ((*center)->ginfo.search_name (),
-			       lang_ln) >= 0)
+	  if (ordered_compare (pool.search_name (*center), lang_ln) >= 0)
 	    top = center;
 	  else
 	    bottom = center + 1;
@@ -617,10 +597,10 @@ match_partial_symbol (struct objfile *objfile,
       gdb_assert (top == bottom);
 
       while (top <= real_top
-	     && psymbol_name_matches (*top, name))
+	     && psymbol_name_matches (pool, *top, name))
 	{
-	  if (symbol_matches_domain ((*top)->ginfo.language (),
-				     (*top)->domain, domain))
+	  if (symbol_matches_domain (pool.language (*top),
+				     pool.domain (*top), domain))
 	    return *top;
 	  top++;
 	}
@@ -633,33 +613,34 @@ match_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain ((*psym)->ginfo.language (),
-				     (*psym)->domain, domain)
-	      && psymbol_name_matches (*psym, name))
+	  if (symbol_matches_domain (pool.language (*psym),
+				     pool.domain (*psym), domain)
+	      && psymbol_name_matches (pool, *psym, name))
 	    return *psym;
 	}
     }
 
-  return NULL;
+  return {};
 }
 
 /* Look, in partial_symtab PST, for symbol whose natural name is
    LOOKUP_NAME.  Check the global symbols if GLOBAL, the static
    symbols if not.  */
 
-static struct partial_symbol *
+static gdb::optional<psymbol_index>
 lookup_partial_symbol (struct objfile *objfile,
 		       struct partial_symtab *pst,
 		       const lookup_name_info &lookup_name,
 		       int global, domain_enum domain)
 {
-  struct partial_symbol **start, **psym;
-  struct partial_symbol **top, **real_top, **bottom, **center;
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+  const psymbol_index *start, *psym;
+  const psymbol_index *top, *real_top, *bottom, *center;
   int length = (global ? pst->n_global_syms : pst->n_static_syms);
   int do_linear_search = 1;
 
   if (length == 0)
-    return NULL;
+    return {};
 
   start = (global ?
 	   &objfile->partial_symtabs->global_psymbols[pst->globals_offset] :
@@ -684,7 +665,7 @@ lookup_partial_symbol (struct objfile *objfile,
 
 	  gdb_assert (center < top);
 
-	  if (strcmp_iw_ordered ((*center)->ginfo.search_name (),
+	  if (strcmp_iw_ordered (pool.search_name (*center),
 				 lookup_name.c_str ()) >= 0)
 	    {
 	      top = center;
@@ -699,18 +680,17 @@ lookup_partial_symbol (struct objfile *objfile,
 
       /* For `case_sensitivity == case_sensitive_off' strcmp_iw_ordered will
 	 search more exactly than what matches SYMBOL_MATCHES_SEARCH_NAME.  */
-      while (top >= start && symbol_matches_search_name (&(*top)->ginfo,
-							 lookup_name))
+      while (top >= start && psymbol_name_matches (pool, *top, lookup_name))
 	top--;
 
       /* Fixup to have a symbol which matches SYMBOL_MATCHES_SEARCH_NAME.  */
       top++;
 
-      while (top <= real_top && symbol_matches_search_name (&(*top)->ginfo,
-							    lookup_name))
+      while (top <= real_top && psymbol_name_matches (pool, *top,
+						       lookup_name))
 	{
-	  if (symbol_matches_domain ((*top)->ginfo.language (),
-				     (*top)->domain, domain))
+	  if (symbol_matches_domain (pool.language (*top),
+				     pool.domain (*top), domain))
 	    return *top;
 	  top++;
 	}
@@ -723,14 +703,14 @@ lookup_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain ((*psym)->ginfo.language (),
-				     (*psym)->domain, domain)
-	      && symbol_matches_search_name (&(*psym)->ginfo, lookup_name))
+	  if (symbol_matches_domain (pool.language (*psym),
+				     pool.domain (*psym), domain)
+	      && psymbol_name_matches (pool, *psym, lookup_name))
 	    return *psym;
 	}
     }
 
-  return NULL;
+  return {};
 }
 
 /* Get the symbol table that corresponds to a partial_symtab.
@@ -825,21 +805,25 @@ psym_forget_cached_source_info (struct objfile *objfile)
 
 static void
 print_partial_symbols (struct gdbarch *gdbarch, struct objfile *objfile,
-		       struct partial_symbol **p, int count, const char *what,
+		       const psymbol_index *p, int count, const char *what,
 		       struct ui_file *outfile)
 {
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+
   fprintf_filtered (outfile, "  %s partial symbols:\n", what);
   while (count-- > 0)
     {
       QUIT;
-      fprintf_filtered (outfile, "    `%s'", (*p)->ginfo.linkage_name ());
-      if ((*p)->ginfo.demangled_name () != NULL)
+      partial_symbol psym = pool.get (*p);
+
+      fprintf_filtered (outfile, "    `%s'", psym.ginfo.linkage_name ());
+      if (psym.ginfo.demangled_name () != NULL)
 	{
 	  fprintf_filtered (outfile, "  `%s'",
-			    (*p)->ginfo.demangled_name ());
+			    psym.ginfo.demangled_name ());
 	}
       fputs_filtered (", ", outfile);
-      switch ((*p)->domain)
+      switch (psym.domain)
 	{
 	case UNDEF_DOMAIN:
 	  fputs_filtered ("undefined domain, ", outfile);
@@ -863,7 +847,7 @@ print_partial_symbols (struct gdbarch *gdbarch, struct objfile *objfile,
 	  fputs_filtered ("<invalid domain>, ", outfile);
 	  break;
 	}
-      switch ((*p)->aclass)
+      switch (psym.aclass)
 	{
 	case LOC_UNDEF:
 	  fputs_filtered ("undefined", outfile);
@@ -915,7 +899,7 @@ print_partial_symbols (struct gdbarch *gdbarch, struct objfile *objfile,
 	  break;
 	}
       fputs_filtered (", ", outfile);
-      fputs_filtered (paddress (gdbarch, (*p)->unrelocated_address ()), outfile);
+      fputs_filtered (paddress (gdbarch, psym.unrelocated_address ()), outfile);
       fprintf_filtered (outfile, "\n");
       p++;
     }
@@ -1008,6 +992,16 @@ psym_print_stats (struct objfile *objfile)
 	i++;
     }
   printf_filtered (_("  Number of psym tables (not yet expanded): %d\n"), i);
+
+  /* The partial symbols themselves are stored in the psymbol pool,
+     whose size is printed by print_objfile_statistics; the psymtabs
+     refer to them through these lists.  */
+  psymtab_storage *storage = objfile->partial_symtabs.get ();
+  size_t list_size = ((storage->global_psymbols.capacity ()
+		       + storage->static_psymbols.capacity ())
+		      * sizeof (psymbol_index));
+  printf_filtered (_("  Total memory used for psymbol lists: %s\n"),
+		   pulongest (list_size));
 }
 
 /* Psymtab version of dump.  See its definition in
@@ -1050,10 +1044,10 @@ psym_expand_symtabs_for_function (struct objfile *objfile,
       if (ps->readin_p (objfile))
 	continue;
 
-      if ((lookup_partial_symbol (objfile, ps, lookup_name, 1, VAR_DOMAIN)
-	   != NULL)
-	  || (lookup_partial_symbol (objfile, ps, lookup_name, 0, VAR_DOMAIN)
-	      != NULL))
+      if (lookup_partial_symbol (objfile, ps, lookup_name, 1,
+				 VAR_DOMAIN).has_value ()
+	  || lookup_partial_symbol (objfile, ps, lookup_name, 0,
+				    VAR_DOMAIN).has_value ())
 	psymtab_to_symtab (objfile, ps);
     }
 }
@@ -1184,7 +1178,7 @@ psym_map_matching_symbols
       QUIT;
       if (ps->readin_p (objfile)
 	  || match_partial_symbol (objfile, ps, global, name, domain,
-				   ordered_compare))
+				   ordered_compare).has_value ())
 	{
 	  struct compunit_symtab *cust = psymtab_to_symtab (objfile, ps);
 	  const struct block *block;
@@ -1239,18 +1233,20 @@ recursively_search_psymtabs
 	}
     }
 
-  partial_symbol **gbound
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+  const psymbol_index *gbound
     = (objfile->partial_symtabs->global_psymbols.data ()
        + ps->globals_offset + ps->n_global_syms);
-  partial_symbol **sbound
+  const psymbol_index *sbound
     = (objfile->partial_symtabs->static_psymbols.data ()
        + ps->statics_offset + ps->n_static_syms);
-  partial_symbol **bound = gbound;
+  const psymbol_index *bound = gbound;
 
   /* Go through all of the symbols stored in a partial
      symtab in one loop.  */
-  partial_symbol **psym = (objfile->partial_symtabs->global_psymbols.data ()
-			   + ps->globals_offset);
+  const psymbol_index *psym
+    = (objfile->partial_symtabs->global_psymbols.data ()
+       + ps->globals_offset);
   while (keep_going)
     {
       if (psym >= bound)
@@ -1271,17 +1267,17 @@ recursively_search_psymtabs
 
 	  if ((domain == ALL_DOMAIN
 	       || (domain == MODULES_DOMAIN
-		   && (*psym)->domain == MODULE_DOMAIN)
+		   && pool.domain (*psym) == MODULE_DOMAIN)
 	       || (domain == VARIABLES_DOMAIN
-		   && (*psym)->aclass != LOC_TYPEDEF
-		   && (*psym)->aclass != LOC_BLOCK)
+		   && pool.aclass (*psym) != LOC_TYPEDEF
+		   && pool.aclass (*psym) != LOC_BLOCK)
 	       || (domain == FUNCTIONS_DOMAIN
-		   && (*psym)->aclass == LOC_BLOCK)
+		   && pool.aclass (*psym) == LOC_BLOCK)
 	       || (domain == TYPES_DOMAIN
-		   && (*psym)->aclass == LOC_TYPEDEF))
-	      && psymbol_name_matches (*psym, lookup_name)
+		   && pool.aclass (*psym) == LOC_TYPEDEF))
+	      && psymbol_name_matches (pool, *psym, lookup_name)
 	      && (sym_matcher == NULL
-		  || sym_matcher ((*psym)->ginfo.search_name ())))
+		  || sym_matcher (pool.search_name (*psym))))
 	    {
 	      /* Found a match, so notify our caller.  */
 	      result = PST_SEARCHED_AND_FOUND;
@@ -1373,17 +1369,19 @@ static void
 psym_fill_psymbol_map (struct objfile *objfile,
 		       struct partial_symtab *psymtab,
 		       std::set<CORE_ADDR> *seen_addrs,
-		       const std::vector<partial_symbol *> &symbols,
+		       const std::vector<psymbol_index> &symbols,
 		       int start,
 		       int length)
 {
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+
   for (int i = 0; i < length; ++i)
     {
-      struct partial_symbol *psym = symbols[start + i];
+      psymbol_index psym = symbols[start + i];
 
-      if (psym->aclass == LOC_STATIC)
+      if (pool.aclass (psym) == LOC_STATIC)
 	{
-	  CORE_ADDR addr = psym->address (objfile);
+	  CORE_ADDR addr = pool.address (psym, objfile);
 	  if (seen_addrs->find (addr) == seen_addrs->end ())
 	    {
 	      seen_addrs->insert (addr);
@@ -1475,10 +1473,11 @@ sort_pst_symbols (struct objfile *objfile, struct partial_symtab *pst)
      vector.  */
   auto end = objfile->partial_symtabs->global_psymbols.end ();
 
-  std::sort (begin, end, [] (partial_symbol *s1, partial_symbol *s2)
+  const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+  std::sort (begin, end, [&] (psymbol_index s1, psymbol_index s2)
     {
-      return strcmp_iw_ordered (s1->ginfo.search_name (),
-				s2->ginfo.search_name ()) < 0;
+      return strcmp_iw_ordered (pool.search_name (s1),
+				pool.search_name (s2)) < 0;
     });
 }
 
@@ -1493,16 +1492,16 @@ partial_symtab::partial_symtab (const char *filename,
   set_text_low (textlow);
   set_text_high (raw_text_low ()); /* default */
 
-  auto *v1 = new std::vector<partial_symbol *>;
+  auto *v1 = new std::vector<psymbol_index>;
   objfile->partial_symtabs->current_global_psymbols.push_back (v1);
-  auto *v2 = new std::vector<partial_symbol *>;
+  auto *v2 = new std::vector<psymbol_index>;
   objfile->partial_symtabs->current_static_psymbols.push_back (v2);
 }
 
 /* Concat vectors V1 and V2.  */
 
 static void
-concat (std::vector<partial_symbol *> *v1, std::vector<partial_symbol *> *v2)
+concat (std::vector<psymbol_index> *v1, std::vector<psymbol_index> *v2)
 {
   v1->insert (v1->end (), v2->begin (), v2->end ());
   v2->clear ();
@@ -1537,74 +1536,200 @@ end_psymtab_common (struct objfile *objfile, struct partial_symtab *pst)
   sort_pst_symbols (objfile, pst);
 }
 
-/* Calculate a hash code for the given partial symbol.  The hash is
-   calculated using the symbol's value, language, domain, class
-   and name.  These are the values which are set by
-   add_psymbol_to_bcache.  */
+/* See psymtab.h.  */
 
-static unsigned long
-psymbol_hash (const void *addr, int length)
+unsigned int
+psymbol_pool::hash (CORE_ADDR value, unsigned int flags,
+		    const char *linkage_name)
 {
-  unsigned long h = 0;
-  struct partial_symbol *psymbol = (struct partial_symbol *) addr;
-  unsigned int lang = psymbol->ginfo.language ();
-  unsigned int domain = psymbol->domain;
-  unsigned int theclass = psymbol->aclass;
-
-  h = fast_hash (&psymbol->ginfo.value, sizeof (psymbol->ginfo.value), h);
-  h = fast_hash (&lang, sizeof (unsigned int), h);
-  h = fast_hash (&domain, sizeof (unsigned int), h);
-  h = fast_hash (&theclass, sizeof (unsigned int), h);
+  unsigned int h = fast_hash (&value, sizeof (value));
+  h = fast_hash (&flags, sizeof (flags), h);
   /* Note that psymbol names are interned via compute_and_set_names, so
      there's no need to hash the contents of the name here.  */
-  h = fast_hash (&psymbol->ginfo.m_name, sizeof (psymbol->ginfo.m_name), h);
+  return fast_hash (&linkage_name, sizeof (linkage_name), h);
+}
 
-  return h;
+/* See psymtab.h.  */
+
+unsigned int
+psymbol_pool::hash (psymbol_index i) const
+{
+  return hash (unrelocated_address (i),
+	       m_flags[i] & ((1 << VALUE_KIND_SHIFT) - 1),
+	       m_linkage_names[i]);
 }
 
-/* Returns true if the symbol at addr1 equals the symbol at addr2.
-   For the comparison this function uses a symbols value,
-   language, domain, class and name.  */
+/* See psymtab.h.  */
 
-static int
-psymbol_compare (const void *addr1, const void *addr2, int length)
+void
+psymbol_pool::grow_slots ()
 {
-  struct partial_symbol *sym1 = (struct partial_symbol *) addr1;
-  struct partial_symbol *sym2 = (struct partial_symbol *) addr2;
-
-  return (memcmp (&sym1->ginfo.value, &sym2->ginfo.value,
-                  sizeof (sym1->ginfo.value)) == 0
-	  && sym1->ginfo.language () == sym2->ginfo.language ()
-          && sym1->domain == sym2->domain
-          && sym1->aclass == sym2->aclass
-	  /* Note that psymbol names are interned via
-	     compute_and_set_names, so there's no need to compare the
-	     contents of the name here.  */
-          && sym1->ginfo.linkage_name () == sym2->ginfo.linkage_name ());
+  m_slots.assign (std::max<size_t> (m_slots.size () * 2, 256), 0);
+
+  size_t mask = m_slots.size () - 1;
+  for (psymbol_index i = 0; i < size (); ++i)
+    {
+      size_t slot = hash (i) & mask;
+      while (m_slots[slot] != 0)
+	slot = (slot + 1) & mask;
+      m_slots[slot] = i + 1;
+    }
 }
 
-/* Helper function, initialises partial symbol structure and stashes
-   it into objfile's bcache.  Note that our caching mechanism will
-   use all fields of struct partial_symbol to determine hash value of the
-   structure.  In other words, having two symbols with the same name but
-   different domain (or address) is possible and correct.  */
+/* See psymtab.h.  */
 
-static struct partial_symbol *
-add_psymbol_to_bcache (const partial_symbol &psymbol,
-		       struct objfile *objfile,
-		       int *added)
+psymbol_index
+psymbol_pool::add (const partial_symbol &psymbol, bool *added)
 {
-  /* Stash the partial symbol away in the cache.  */
-  return ((struct partial_symbol *)
-	  objfile->partial_symtabs->psymbol_cache.insert
-	  (&psymbol, sizeof (struct partial_symbol), added));
+  gdb_static_assert (VALUE_KIND_SHIFT + 2 <= 16);
+
+  CORE_ADDR value = psymbol.unrelocated_address ();
+  const char *linkage_name = psymbol.ginfo.linkage_name ();
+  unsigned int flags = ((psymbol.domain << DOMAIN_SHIFT)
+			| (psymbol.aclass << ACLASS_SHIFT)
+			| (psymbol.ginfo.language () << LANGUAGE_SHIFT));
+
+  ++m_n_added;
+
+  /* Keep the table at most three quarters full.  */
+  if ((size () + 1) * 4 > m_slots.size () * 3)
+    grow_slots ();
+
+  size_t mask = m_slots.size () - 1;
+  size_t slot = hash (value, flags, linkage_name) & mask;
+  for (; m_slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+      psymbol_index i = m_slots[slot] - 1;
+
+      if (m_linkage_names[i] == linkage_name
+	  && (m_flags[i] & ((1 << VALUE_KIND_SHIFT) - 1)) == flags
+	  && unrelocated_address (i) == value)
+	{
+	  *added = false;
+	  return i;
+	}
+    }
+
+  psymbol_index i = size ();
+  m_slots[slot] = i + 1;
+
+  if (value == 0)
+    {
+      flags |= VALUE_ZERO << VALUE_KIND_SHIFT;
+      m_values.push_back (0);
+    }
+  else
+    {
+      if (!m_value_base_p)
+	{
+	  m_value_base = value & ~(CORE_ADDR) 0xffffffff;
+	  m_value_base_p = true;
+	}
+
+      if (value >= m_value_base && value - m_value_base <= 0xffffffff)
+	{
+	  flags |= VALUE_OFFSET << VALUE_KIND_SHIFT;
+	  m_values.push_back (value - m_value_base);
+	}
+      else
+	{
+	  flags |= VALUE_WIDE << VALUE_KIND_SHIFT;
+	  m_values.push_back (0);
+	  m_wide_values[i] = value;
+	}
+    }
+
+  m_linkage_names.push_back (linkage_name);
+  /* The search name of an Ada symbol is its linkage name, and its
+     demangled name is computed on demand; see get.  */
+  m_demangled_names.push_back (psymbol.ginfo.language () == language_ada
+			       ? nullptr
+			       : psymbol.ginfo.demangled_name ());
+  m_flags.push_back (flags);
+  m_sections.push_back (psymbol.ginfo.section);
+
+  *added = true;
+  return i;
+}
+
+/* See psymtab.h.  */
+
+size_t
+psymbol_pool::memory_used () const
+{
+  return (m_linkage_names.capacity () * sizeof (const char *)
+	  + m_demangled_names.capacity () * sizeof (const char *)
+	  + m_flags.capacity () * sizeof (uint16_t)
+	  + m_sections.capacity () * sizeof (short)
+	  + m_values.capacity () * sizeof (uint32_t)
+	  + m_slots.capacity () * sizeof (psymbol_index)
+	  + m_wide_values.size () * (sizeof (psymbol_index)
+				     + sizeof (CORE_ADDR)
+				     + 2 * sizeof (void *)));
+}
+
+/* See psymtab.h.  */
+
+void
+psymbol_pool::print_statistics (const char *type) const
+{
+  printf_filtered (_("  Pooled '%s' statistics:\n"), type);
+  printf_filtered (_("    Total object count:  %s\n"), pulongest (m_n_added));
+  printf_filtered (_("    Unique object count: %s\n"), pulongest (size ()));
+  printf_filtered (_("    Wide value count:    %s\n"),
+		   pulongest (m_wide_values.size ()));
+  printf_filtered (_("    Hash table size:     %s\n"),
+		   pulongest (m_slots.size ()));
+  printf_filtered (_("    Total memory used by pool: %s\n"),
+		   pulongest (memory_used ()));
+}
+
+/* See psymtab.h.  */
+
+CORE_ADDR
+psymbol_pool::address (psymbol_index i, const struct objfile *objfile) const
+{
+  return (unrelocated_address (i)
+	  + objfile->section_offsets[m_sections[i]]);
+}
+
+/* See psymtab.h.  */
+
+struct obj_section *
+psymbol_pool::obj_section (psymbol_index i, struct objfile *objfile) const
+{
+  if (m_sections[i] >= 0)
+    return &objfile->sections[m_sections[i]];
+  return nullptr;
+}
+
+/* See psymtab.h.  */
+
+partial_symbol
+psymbol_pool::get (psymbol_index i) const
+{
+  partial_symbol psymbol;
+  memset (&psymbol, 0, sizeof (psymbol));
+
+  psymbol.set_unrelocated_address (unrelocated_address (i));
+  psymbol.ginfo.section = m_sections[i];
+  psymbol.domain = domain (i);
+  psymbol.aclass = aclass (i);
+  /* Without an obstack, the decoded name of an Ada symbol is kept in
+     a table shared by all the symbols; see ada_decode_symbol.  */
+  psymbol.ginfo.set_language (language (i), nullptr);
+  psymbol.ginfo.set_linkage_name (m_linkage_names[i]);
+  if (m_demangled_names[i] != nullptr)
+    psymbol.ginfo.set_demangled_name (m_demangled_names[i], nullptr);
+
+  return psymbol;
 }
 
 /* Helper function, adds partial symbol to the given partial symbol list.  */
 
 static void
-append_psymbol_to_list (std::vector<partial_symbol *> *list,
-			struct partial_symbol *psym,
+append_psymbol_to_list (std::vector<psymbol_index> *list,
+			psymbol_index psym,
 			struct objfile *objfile)
 {
   list->push_back (psym);
@@ -1618,19 +1743,18 @@ add_psymbol_to_list (const partial_symbol &psymbol,
 		     psymbol_placement where,
 		     struct objfile *objfile)
 {
-  struct partial_symbol *psym;
-
-  int added;
+  bool added;
 
-  /* Stash the partial symbol away in the cache.  */
-  psym = add_psymbol_to_bcache (psymbol, objfile, &added);
+  /* Stash the partial symbol away in the pool.  */
+  psymbol_index psym
+    = objfile->partial_symtabs->psymbols.add (psymbol, &added);
 
   /* Do not duplicate global partial symbols.  */
   if (where == psymbol_placement::GLOBAL && !added)
     return;
 
-  /* Save pointer to partial symbol in psymtab, growing symtab if needed.  */
-  std::vector<partial_symbol *> *list
+  /* Save the partial symbol in psymtab, growing symtab if needed.  */
+  std::vector<psymbol_index> *list
     = (where == psymbol_placement::STATIC
        ? objfile->partial_symtabs->current_static_psymbols.back ()
        : objfile->partial_symtabs->current_global_psymbols.back ());
@@ -2051,7 +2175,7 @@ maintenance_info_psymtabs (const char *regexp, int from_tty)
 			       ->global_psymbols[psymtab->globals_offset]);
 
 		    printf_filtered
-		      ("(* (struct partial_symbol **) %s @ %d)\n",
+		      ("(* (psymbol_index *) %s @ %d)\n",
 		       host_address_to_string (p),
 		       psymtab->n_global_syms);
 		  }
@@ -2064,7 +2188,7 @@ maintenance_info_psymtabs (const char *regexp, int from_tty)
 			       ->static_psymbols[psymtab->statics_offset]);
 
 		    printf_filtered
-		      ("(* (struct partial_symbol **) %s @ %d)\n",
+		      ("(* (psymbol_index *) %s @ %d)\n",
 		       host_address_to_string (p),
 		       psymtab->n_static_syms);
 		  }
@@ -2146,23 +2270,24 @@ maintenance_check_psymtabs (const char *ignore, int from_tty)
 	  continue;
 	bv = COMPUNIT_BLOCKVECTOR (cust);
 	b = BLOCKVECTOR_BLOCK (bv, STATIC_BLOCK);
-	partial_symbol **psym
+	const psymbol_pool &pool = objfile->partial_symtabs->psymbols;
+	const psymbol_index *psym
 	  = &objfile->partial_symtabs->static_psymbols[ps->statics_offset];
 	for (i = 0; i < ps->n_static_syms; psym++, i++)
 	  {
 	    /* Skip symbols for inlined functions without address.  These may
 	       or may not have a match in the full symtab.  */
-	    if ((*psym)->aclass == LOC_BLOCK
-		&& (*psym)->ginfo.value.address == 0)
+	    if (pool.aclass (*psym) == LOC_BLOCK
+		&& pool.unrelocated_address (*psym) == 0)
 	      continue;
 
-	    sym = block_lookup_symbol (b, (*psym)->ginfo.search_name (),
+	    sym = block_lookup_symbol (b, pool.search_name (*psym),
 				       symbol_name_match_type::SEARCH_NAME,
-				       (*psym)->domain);
+				       pool.domain (*psym));
 	    if (!sym)
 	      {
 		printf_filtered ("Static symbol `");
-		puts_filtered ((*psym)->ginfo.linkage_name ());
+		puts_filtered (pool.linkage_name (*psym));
 		printf_filtered ("' only found in ");
 		puts_filtered (ps->filename);
 		printf_filtered (" psymtab\n");
@@ -2172,13 +2297,13 @@ maintenance_check_psymtabs (const char *ignore, int from_tty)
 	psym = &objfile->partial_symtabs->global_psymbols[ps->globals_offset];
 	for (i = 0; i < ps->n_global_syms; psym++, i++)
 	  {
-	    sym = block_lookup_symbol (b, (*psym)->ginfo.search_name (),
+	    sym = block_lookup_symbol (b, pool.search_name (*psym),
 				       symbol_name_match_type::SEARCH_NAME,
-				       (*psym)->domain);
+				       pool.domain (*psym));
 	    if (!sym)
 	      {
 		printf_filtered ("Global symbol `");
-		puts_filtered ((*psym)->ginfo.linkage_name ());
+		puts_filtered (pool.linkage_name (*psym));
 		printf_filtered ("' only found in ");
 		puts_filtered (ps->filename);
 		printf_filtered (" psymtab\n");
@@ -2205,6 +2330,135 @@ maintenance_check_psymtabs (const char *ignore, int from_tty)
       }
 }
 
+#if GDB_SELF_TEST
+
+namespace selftests {
+namespace psymbol_pool_tests {
+
+/* Return a partial symbol named NAME, with value VALUE.  */
+
+static partial_symbol
+make_psymbol (const char *name, CORE_ADDR value, enum language lang,
+	      address_class aclass)
+{
+  partial_symbol psymbol;
+  memset (&psymbol, 0, sizeof (psymbol));
+  psymbol.set_unrelocated_address (value);
+  psymbol.ginfo.section = value == 0 ? -1 : 0;
+  psymbol.domain = VAR_DOMAIN;
+  psymbol.aclass = aclass;
+  psymbol.ginfo.set_language (lang, nullptr);
+  psymbol.ginfo.set_linkage_name (name);
+  return psymbol;
+}
+
+static void
+run_test ()
+{
+  static const char foo[] = "foo";
+  static const char bar[] = "bar";
+  static const char foo_mangled[] = "_Z3foov";
+  static const char foo_demangled[] = "foo()";
+
+  psymbol_pool pool;
+  bool added;
+
+  /* A type, whose value is zero, and a function.  */
+  psymbol_index type
+    = pool.add (make_psymbol (foo, 0, language_c, LOC_TYPEDEF), &added);
+  SELF_CHECK (added);
+  psymbol_index func
+    = pool.add (make_psymbol (foo, 0x401000, language_c, LOC_BLOCK),
+		&added);
+  SELF_CHECK (added);
+  SELF_CHECK (type != func);
+
+  /* Adding an equal symbol returns the existing one.  */
+  SELF_CHECK (pool.add (make_psymbol (foo, 0x401000, language_c, LOC_BLOCK),
+			&added) == func);
+  SELF_CHECK (!added);
+
+  /* Symbols that differ only in value, class or language are
+     distinct.  */
+  psymbol_index func2
+    = pool.add (make_psymbol (foo, 0x402000, language_c, LOC_BLOCK),
+		&added);
+  SELF_CHECK (added && func2 != func);
+  psymbol_index cplus
+    = pool.add (make_psymbol (foo, 0x401000, language_cplus, LOC_BLOCK),
+		&added);
+  SELF_CHECK (added && cplus != func);
+
+  /* The base is that of the first nonzero value.  Values more than
+     4GB above it are kept aside; the others are stored as offsets.  */
+  psymbol_index low
+    = pool.add (make_psymbol (bar, 0x1000, language_c, LOC_STATIC), &added);
+  psymbol_index high
+    = pool.add (make_psymbol (bar, (CORE_ADDR) 0x7fff00000000, language_c,
+			      LOC_STATIC), &added);
+  psymbol_index top
+    = pool.add (make_psymbol (bar, 0xffffffff, language_c, LOC_STATIC),
+		&added);
+
+  SELF_CHECK (pool.unrelocated_address (type) == 0);
+  SELF_CHECK (pool.unrelocated_address (func) == 0x401000);
+  SELF_CHECK (pool.unrelocated_address (func2) == 0x402000);
+  SELF_CHECK (pool.unrelocated_address (low) == 0x1000);
+  SELF_CHECK (pool.unrelocated_address (high) == 0x7fff00000000);
+  SELF_CHECK (pool.unrelocated_address (top) == 0xffffffff);
+  SELF_CHECK (pool.add (make_psymbol (bar, 0x7fff00000000, language_c,
+				      LOC_STATIC), &added) == high);
+  SELF_CHECK (!added);
+
+  SELF_CHECK (pool.section (type) == -1);
+  SELF_CHECK (pool.section (func) == 0);
+  SELF_CHECK (pool.aclass (func) == LOC_BLOCK);
+  SELF_CHECK (pool.domain (func) == VAR_DOMAIN);
+  SELF_CHECK (pool.language (cplus) == language_cplus);
+  SELF_CHECK (pool.linkage_name (low) == bar);
+
+  /* The search name is the demangled name, when there is one.  */
+  partial_symbol mangled
+    = make_psymbol (foo_mangled, 0x403000, language_cplus, LOC_BLOCK);
+  mangled.ginfo.set_demangled_name (foo_demangled, nullptr);
+  psymbol_index m = pool.add (mangled, &added);
+  SELF_CHECK (pool.search_name (m) == foo_demangled);
+  SELF_CHECK (pool.search_name (func) == foo);
+
+  partial_symbol copy = pool.get (m);
+  SELF_CHECK (copy.ginfo.linkage_name () == foo_mangled);
+  SELF_CHECK (copy.ginfo.demangled_name () == foo_demangled);
+  SELF_CHECK (copy.unrelocated_address () == 0x403000);
+  SELF_CHECK (copy.aclass == LOC_BLOCK);
+
+  SELF_CHECK (pool.size () == 8);
+  SELF_CHECK (pool.n_added () == 10);
+
+  /* Growing the hash table keeps every symbol findable.  */
+  std::vector<std::string> names;
+  for (int i = 0; i < 1000; ++i)
+    names.push_back (string_printf ("sym%d", i));
+  for (int i = 0; i < 1000; ++i)
+    pool.add (make_psymbol (names[i].c_str (), 0x500000 + i, language_c,
+			    LOC_STATIC), &added);
+  SELF_CHECK (pool.size () == 1008);
+  for (int i = 0; i < 1000; ++i)
+    {
+      psymbol_index s
+	= pool.add (make_psymbol (names[i].c_str (), 0x500000 + i,
+				  language_c, LOC_STATIC), &added);
+      SELF_CHECK (!added);
+      SELF_CHECK (pool.linkage_name (s) == names[i].c_str ());
+      SELF_CHECK (pool.unrelocated_address (s) == 0x500000 + i);
+    }
+  SELF_CHECK (pool.size () == 1008);
+}
+
+} /* namespace psymbol_pool_tests */
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
 void _initialize_psymtab ();
 void
 _initialize_psymtab ()
@@ -2230,4 +2484,9 @@ just the symbol table structures themselves."),
 	   _("\
 Check consistency of currently expanded psymtabs versus symtabs."),
 	   &maintenancelist);
+
+#if GDB_SELF_TEST
+  selftests::register_test ("psymbol_pool",
+			    selftests::psymbol_pool_tests::run_test);
+#endif
 }
@@ -23,10 +23,208 @@
 #include "gdb_obstack.h"
 #include "symfile.h"
 #include "gdbsupport/next-iterator.h"
-#include "bcache.h"
+#include <unordered_map>
 
 struct partial_symbol;
 
+/* An index into a psymbol_pool.  */
+
+typedef unsigned int psymbol_index;
+
+/* The partial symbols of a psymtab_storage.
+
+   Each distinct partial symbol is stored once, as a row of parallel
+   arrays, and psymtabs refer to it by its index.  This avoids the
+   padding of a partial_symbol object and the overhead of the bcache
+   that used to hold them, and lets the psymtab lists hold indices
+   rather than pointers.  Searches by name only touch the arrays of
+   names and flags.
+
+   The names are not copied into the pool: like the names of full
+   symbols, they are interned in the per-BFD string cache or point
+   into the debug information.  The values are stored as 32-bit
+   offsets from a base shared by the pool; the few that don't fit are
+   kept aside.  */
+
+class psymbol_pool
+{
+public:
+
+  psymbol_pool () = default;
+
+  DISABLE_COPY_AND_ASSIGN (psymbol_pool);
+
+  /* Add PSYMBOL to the pool, unless an equal symbol is already there,
+     and return the index of the symbol.  Set *ADDED to true if
+     PSYMBOL was added.  Two symbols are equal if they have the same
+     value, language, domain, class and linkage name; the name of
+     PSYMBOL must have been interned, see
+     general_symbol_info::compute_and_set_names.  */
+
+  psymbol_index add (const partial_symbol &psymbol, bool *added);
+
+  /* Return the number of symbols in the pool.  */
+
+  size_t size () const
+  {
+    return m_linkage_names.size ();
+  }
+
+  /* Return the number of symbols that were passed to add.  */
+
+  size_t n_added () const
+  {
+    return m_n_added;
+  }
+
+  /* Return the memory used by the pool, in bytes.  */
+
+  size_t memory_used () const;
+
+  /* Print statistics about the pool, calling it TYPE.  */
+
+  void print_statistics (const char *type) const;
+
+  /* Return the linkage name of symbol I.  */
+
+  const char *linkage_name (psymbol_index i) const
+  {
+    return m_linkage_names[i];
+  }
+
+  /* Return the name of symbol I, as used when searching; see
+     general_symbol_info::search_name.  */
+
+  const char *search_name (psymbol_index i) const
+  {
+    if (m_demangled_names[i] != nullptr)
+      return m_demangled_names[i];
+    return m_linkage_names[i];
+  }
+
+  enum language language (psymbol_index i) const
+  {
+    return (enum language) ((m_flags[i] >> LANGUAGE_SHIFT)
+			    & ((1 << LANGUAGE_BITS) - 1));
+  }
+
+  domain_enum domain (psymbol_index i) const
+  {
+    return (domain_enum) ((m_flags[i] >> DOMAIN_SHIFT)
+			  & ((1 << SYMBOL_DOMAIN_BITS) - 1));
+  }
+
+  enum address_class aclass (psymbol_index i) const
+  {
+    return (enum address_class) ((m_flags[i] >> ACLASS_SHIFT)
+				 & ((1 << SYMBOL_ACLASS_BITS) - 1));
+  }
+
+  /* Return the section index of symbol I, or -1 if it has none.  */
+
+  short section (psymbol_index i) const
+  {
+    return m_sections[i];
+  }
+
+  /* Return the unrelocated address of symbol I.  */
+
+  CORE_ADDR unrelocated_address (psymbol_index i) const
+  {
+    switch (m_flags[i] >> VALUE_KIND_SHIFT)
+      {
+      case VALUE_OFFSET:
+	return m_value_base + m_values[i];
+      case VALUE_ZERO:
+	return 0;
+      default:
+	return m_wide_values.at (i);
+      }
+  }
+
+  /* Return the address of symbol I, relocated according to the
+     offsets provided in OBJFILE.  */
+
+  CORE_ADDR address (psymbol_index i, const struct objfile *objfile) const;
+
+  /* Return the section of symbol I, or nullptr if it has none.  */
+
+  struct obj_section *obj_section (psymbol_index i,
+				   struct objfile *objfile) const;
+
+  /* Return symbol I as a partial_symbol object.  This is for users
+     that need the whole general_symbol_info interface, like the
+     demangled name of an Ada symbol.  */
+
+  partial_symbol get (psymbol_index i) const;
+
+private:
+
+  /* The layout of the M_FLAGS entries.  */
+
+  enum
+    {
+      DOMAIN_SHIFT = 0,
+      ACLASS_SHIFT = DOMAIN_SHIFT + SYMBOL_DOMAIN_BITS,
+      LANGUAGE_SHIFT = ACLASS_SHIFT + SYMBOL_ACLASS_BITS,
+      VALUE_KIND_SHIFT = LANGUAGE_SHIFT + LANGUAGE_BITS
+    };
+
+  /* How the value of a symbol is stored.  */
+
+  enum
+    {
+      /* As an offset from M_VALUE_BASE, in M_VALUES.  */
+      VALUE_OFFSET,
+      /* The value is zero, as it is for most types.  */
+      VALUE_ZERO,
+      /* In M_WIDE_VALUES.  */
+      VALUE_WIDE
+    };
+
+  /* Return the hash of a symbol with these properties.  FLAGS does not
+     include the value kind.  */
+
+  static unsigned int hash (CORE_ADDR value, unsigned int flags,
+			      const char *linkage_name);
+
+  /* Return the hash of symbol I.  */
+
+  unsigned int hash (psymbol_index i) const;
+
+  /* Double the size of M_SLOTS, and rehash the symbols.  */
+
+  void grow_slots ();
+
+  /* The columns of the pool, indexed by psymbol_index.  */
+
+  std::vector<const char *> m_linkage_names;
+  std::vector<const char *> m_demangled_names;
+  std::vector<uint16_t> m_flags;
+  std::vector<short> m_sections;
+  std::vector<uint32_t> m_values;
+
+  /* The base of the M_VALUES offsets.  It is set by the first symbol
+     with a nonzero value.  */
+
+  CORE_ADDR m_value_base = 0;
+  bool m_value_base_p = false;
+
+  /* The values that are not within 4GB above M_VALUE_BASE.  */
+
+  std::unordered_map<psymbol_index, CORE_ADDR> m_wide_values;
+
+  /* An open-addressing hash table of the symbols, used to find equal
+     symbols in add.  Each slot is zero if empty, or the index of a
+     symbol plus one.  */
+
+  std::vector<psymbol_index> m_slots;
+
+  /* The number of calls to add.  */
+
+  size_t m_n_added = 0;
+};
+
 /* An instance of this class manages the partial symbol tables and
    partial symbols for a given objfile.
 
@@ -118,22 +316,21 @@ class psymtab_storage
 
   struct addrmap *psymtabs_addrmap = nullptr;
 
-  /* A byte cache where we can stash arbitrary "chunks" of bytes that
-     will not change.  */
+  /* The partial symbols read in from file.  */
 
-  gdb::bcache psymbol_cache;
+  psymbol_pool psymbols;
 
-  /* Vectors of all partial symbols read in from file.  The actual data
-     is stored in the objfile_obstack.  */
+  /* Vectors of the partial symbols of each psymtab, see
+     partial_symtab::globals_offset.  */
 
-  std::vector<partial_symbol *> global_psymbols;
-  std::vector<partial_symbol *> static_psymbols;
+  std::vector<psymbol_index> global_psymbols;
+  std::vector<psymbol_index> static_psymbols;
 
   /* Stack of vectors of partial symbols, using during psymtab
      initialization.  */
 
-  std::vector<std::vector<partial_symbol *>*> current_global_psymbols;
-  std::vector<std::vector<partial_symbol *>*> current_static_psymbols;
+  std::vector<std::vector<psymbol_index>*> current_global_psymbols;
+  std::vector<std::vector<psymbol_index>*> current_static_psymbols;
 
 private:
 
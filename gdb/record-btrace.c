@@ -102,6 +102,9 @@ class record_btrace_target final : public target_ops
 					ULONGEST offset, ULONGEST len,
 					ULONGEST *xfered_len) override;
 
+  bool read_memory_multiple (gdb::array_view<memory_read_request> requests)
+    override;
+
   int insert_breakpoint (struct gdbarch *,
 			 struct bp_target_info *) override;
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
@@ -1474,6 +1477,21 @@ record_btrace_target::xfer_partial (enum target_object object,
 					 offset, len, xfered_len);
 }
 
+/* The read_memory_multiple method of target record-btrace.  */
+
+bool
+record_btrace_target::read_memory_multiple
+  (gdb::array_view<memory_read_request> requests)
+{
+  /* Leave reads during replay to xfer_partial, which filters them.  */
+  if (replay_memory_access == replay_memory_access_read_only
+      && !record_btrace_generating_corefile
+      && record_is_replaying (inferior_ptid))
+    return false;
+
+  return this->beneath ()->read_memory_multiple (requests);
+}
+
 /* The insert_breakpoint method of target record-btrace.  */
 
 int
@@ -78,6 +78,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include "async-event.h"
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -266,6 +267,52 @@ class remote_state
      reliable.  */
   bool noack_mode = false;
 
+  /* The number of vPipelined requests the stub accepts to have
+     outstanding at once, as reported by the "PipelinedRequests"
+     qSupported feature.  Zero if the stub did not report it.  */
+  int pipeline_window = 0;
+
+  /* The tag of the last vPipelined request sent.  */
+  unsigned int pipeline_tag = 0;
+
+  /* The most memory the stub reads for a vReadCompressed request, as
+     reported by the "ReadCompressed" qSupported feature.  Zero if the
+     stub did not report it.  */
+  ULONGEST read_compressed_max = 0;
+
+  /* A register GDB had to fetch while handling a stop, which it asked
+     the stub to include in stop replies with a QExpediteRegisters
+     packet.  */
+  struct expedited_register
+  {
+    /* The remote and GDB numbers of the register.  */
+    LONGEST pnum;
+    long regnum;
+
+    /* Whether GDB used the value from the last stop reply while
+       handling that stop.  */
+    bool used;
+
+    /* The number of stops since GDB last used the register.  */
+    int idle_stops;
+  };
+
+  /* The registers GDB asked the stub to include in stop replies, and
+     the architecture they are registers of.  */
+  std::vector<expedited_register> expedited_regs;
+  struct gdbarch *expedited_arch = NULL;
+
+  /* True if EXPEDITED_REGS changed since the stub was last told.  */
+  bool expedited_regs_changed = false;
+
+  /* The values of EXPEDITED_REGS in the last stop reply, for thread
+     EXPEDITED_PTID, indexed like EXPEDITED_REGS.  They are only
+     supplied to the thread's register cache when GDB needs them, so
+     that GDB knows which ones it uses.  Empty entries were not in the
+     reply, or were supplied already.  */
+  ptid_t expedited_ptid = null_ptid;
+  std::vector<gdb::byte_vector> expedited_values;
+
   /* True if we're connected in extended remote mode.  */
   bool extended = false;
 
@@ -510,6 +557,9 @@ class remote_target : public process_stratum_target
 
   ULONGEST get_memory_xfer_limit () override;
 
+  bool read_memory_multiple (gdb::array_view<memory_read_request> requests)
+    override;
+
   void rcmd (const char *command, struct ui_file *output) override;
 
   char *pid_to_exec_file (int pid) override;
@@ -824,6 +874,12 @@ class remote_target : public process_stratum_target
   void remote_packet_size (const protocol_feature *feature,
 			   packet_support support, const char *value);
 
+  void remote_pipelined_requests (const protocol_feature *feature,
+				  packet_support support, const char *value);
+
+  void remote_read_compressed (const protocol_feature *feature,
+			       packet_support support, const char *value);
+
   void remote_serial_quit_handler ();
 
   void remote_detach_pid (int pid);
@@ -841,8 +897,15 @@ class remote_target : public process_stratum_target
   int fetch_register_using_p (struct regcache *regcache,
 			      packet_reg *reg);
   int send_g_packet ();
+  void forget_register_baselines ();
   void process_g_packet (struct regcache *regcache);
   void fetch_registers_using_g (struct regcache *regcache);
+  void record_register_baseline (struct regcache *regcache);
+  bool fetch_registers_using_delta (struct regcache *regcache);
+  void expedite_register (struct regcache *regcache, packet_reg *reg);
+  bool send_expedited_registers ();
+  void age_expedited_registers ();
+  bool supply_expedited_register (struct regcache *regcache, int regnum);
   int store_register_using_P (const struct regcache *regcache,
 			      packet_reg *reg);
   void store_registers_using_G (const struct regcache *regcache);
@@ -868,6 +931,22 @@ class remote_target : public process_stratum_target
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						  gdb_byte *myaddr,
+						  ULONGEST len_units,
+						  int unit_size,
+						  ULONGEST *xfered_len_units);
+
+  target_xfer_status remote_read_bytes_compressed (CORE_ADDR memaddr,
+						   gdb_byte *myaddr,
+						   ULONGEST len_units,
+						   int unit_size,
+						   ULONGEST *xfered_len_units);
+
+  int remote_pipeline_window ();
+  unsigned int putpkt_pipelined (const char *inner);
+  const char *getpkt_pipelined (unsigned int *tag, int *len);
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -933,6 +1012,13 @@ class remote_target : public process_stratum_target
 					ULONGEST *xfered_len,
 					struct packet_config *packet);
 
+  target_xfer_status remote_read_qxfer_pipelined (const char *object_name,
+						  const char *annex,
+						  gdb_byte *readbuf,
+						  ULONGEST offset,
+						  LONGEST len,
+						  ULONGEST *xfered_len);
+
   void push_stop_reply (struct stop_reply *new_event);
 
   bool vcont_r_supported ();
@@ -1084,6 +1170,12 @@ struct remote_thread_info : public private_thread_info
   /* Whether this thread was already vCont-resumed on the remote
      side.  */
   int vcont_resumed = 0;
+
+  /* The registers of the 'g' packet as the stub last sent them, in
+     reply to a 'g' or vRegDelta packet.  A vRegDelta reply only holds
+     the registers that changed since, so the others are taken from
+     here.  NULL if there is no such copy.  */
+  std::unique_ptr<detached_regcache> reg_baseline;
 };
 
 remote_state::remote_state ()
@@ -1543,6 +1635,10 @@ struct memory_packet_config
    can write at least one byte.  */
 #define MIN_MEMORY_PACKET_SIZE 20
 
+/* The room to leave in a packet for the tag of a vPipelined reply:
+   the tag in hex, and the ';' following it.  */
+#define PIPELINED_TAG_ROOM (2 * (int) sizeof (unsigned int) + 1)
+
 /* Get the memory packet size, assuming it is fixed.  */
 
 static long
@@ -1694,6 +1790,27 @@ show_hardware_watchpoint_limit (struct ui_file *file, int from_tty,
 			    "watchpoints is %s.\n"), value);
 }
 
+/* The maximum number of registers GDB asks the stub to add to stop
+   replies with the QExpediteRegisters packet, or -1 for no limit.  */
+
+static int remote_expedite_registers_limit = 8;
+
+/* GDB stops asking the stub to add a register to stop replies when it
+   did not use it while handling this many stops in a row.  */
+
+#define EXPEDITE_IDLE_STOPS 16
+
+/* Show the maximum number of registers added to stop replies.  */
+
+static void
+show_expedite_registers_limit (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c,
+			       const char *value)
+{
+  fprintf_filtered (file, _("The maximum number of registers added to "
+			    "stop replies is %s.\n"), value);
+}
+
 /* Show the length limit (in bytes) for hardware watchpoints.  */
 
 static void
@@ -2093,6 +2210,24 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for the vPipelined packet.  */
+  PACKET_vPipelined,
+
+  /* Support for the binary memory read packet.  */
+  PACKET_x,
+
+  /* Support for the vReadCompressed packet.  */
+  PACKET_vReadCompressed,
+
+  /* Support for the vReadMultiple packet.  */
+  PACKET_vReadMultiple,
+
+  /* Support for the QExpediteRegisters packet.  */
+  PACKET_QExpediteRegisters,
+
+  /* Support for the vRegDelta packet.  */
+  PACKET_vRegDelta,
+
   PACKET_MAX
 };
 
@@ -5132,6 +5267,88 @@ remote_packet_size (remote_target *remote, const protocol_feature *feature,
   remote->remote_packet_size (feature, support, value);
 }
 
+void
+remote_target::remote_pipelined_requests (const protocol_feature *feature,
+					  enum packet_support support,
+					  const char *value)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  int window;
+  char *value_end;
+
+  remote_protocol_packets[PACKET_vPipelined].support = support;
+  if (support != PACKET_ENABLE)
+    return;
+
+  if (value == NULL || *value == '\0')
+    {
+      warning (_("Remote target reported \"%s\" without a window."),
+	       feature->name);
+      return;
+    }
+
+  errno = 0;
+  window = strtol (value, &value_end, 16);
+  if (errno != 0 || *value_end != '\0' || window < 0)
+    {
+      warning (_("Remote target reported \"%s\" with a bad window: \"%s\"."),
+	       feature->name, value);
+      return;
+    }
+
+  rs->pipeline_window = window;
+}
+
+static void
+remote_pipelined_requests (remote_target *remote,
+			   const protocol_feature *feature,
+			   enum packet_support support, const char *value)
+{
+  remote->remote_pipelined_requests (feature, support, value);
+}
+
+void
+remote_target::remote_read_compressed (const protocol_feature *feature,
+				       enum packet_support support,
+				       const char *value)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  long max_size;
+  char *value_end;
+
+  remote_protocol_packets[PACKET_vReadCompressed].support = support;
+  if (support != PACKET_ENABLE)
+    return;
+
+  if (value == NULL || *value == '\0')
+    {
+      warning (_("Remote target reported \"%s\" without a size."),
+	       feature->name);
+      return;
+    }
+
+  errno = 0;
+  max_size = strtol (value, &value_end, 16);
+  if (errno != 0 || *value_end != '\0' || max_size < 0)
+    {
+      warning (_("Remote target reported \"%s\" with a bad size: \"%s\"."),
+	       feature->name, value);
+      return;
+    }
+
+  rs->read_compressed_max = max_size;
+}
+
+static void
+remote_read_compressed (remote_target *remote,
+			const protocol_feature *feature,
+			enum packet_support support, const char *value)
+{
+  remote->remote_read_compressed (feature, support, value);
+}
+
 static const struct protocol_feature remote_protocol_features[] = {
   { "PacketSize", PACKET_DISABLE, remote_packet_size, -1 },
   { "qXfer:auxv:read", PACKET_DISABLE, remote_supported_packet,
@@ -5235,6 +5452,17 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "PipelinedRequests", PACKET_DISABLE, remote_pipelined_requests,
+    PACKET_vPipelined },
+  { "ReadCompressed", PACKET_DISABLE, remote_read_compressed,
+    PACKET_vReadCompressed },
+  { "binary-upload", PACKET_DISABLE, remote_supported_packet, PACKET_x },
+  { "ReadMultiple", PACKET_DISABLE, remote_supported_packet,
+    PACKET_vReadMultiple },
+  { "QExpediteRegisters", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QExpediteRegisters },
+  { "RegisterDelta", PACKET_DISABLE, remote_supported_packet,
+    PACKET_vRegDelta },
 };
 
 static char *remote_support_xml;
@@ -5613,6 +5841,8 @@ remote_target::open_1 (const char *name, int from_tty, int extended_p)
   reset_all_packet_configs_support ();
   rs->cached_wait_status = 0;
   rs->explicit_packet_size = 0;
+  rs->pipeline_window = 0;
+  rs->read_compressed_max = 0;
   rs->noack_mode = 0;
   rs->extended = extended_p;
   rs->waiting_for_stop_reply = 0;
@@ -6300,6 +6530,19 @@ remote_target::resume (ptid_t ptid, int step, enum gdb_signal siggnal)
 {
   struct remote_state *rs = get_remote_state ();
 
+  /* The values kept from the last stop reply are stale once its thread
+     runs again.  */
+  if (rs->expedited_ptid.matches (ptid))
+    {
+      rs->expedited_ptid = null_ptid;
+      rs->expedited_values.clear ();
+    }
+
+  /* Tell the stub about the registers to stop adding to stop
+     replies.  */
+  if (rs->expedited_regs_changed)
+    send_expedited_registers ();
+
   /* When connected in non-stop mode, the core resumes threads
      individually.  Resuming remote threads directly in target_resume
      would thus result in sending one packet per thread.  Instead, to
@@ -7741,6 +7984,21 @@ remote_target::process_stop_reply (struct stop_reply *stop_reply,
       && status->kind != TARGET_WAITKIND_SIGNALLED
       && status->kind != TARGET_WAITKIND_NO_RESUMED)
     {
+      struct remote_state *rs = get_remote_state ();
+      bool learned = (stop_reply->arch == rs->expedited_arch
+		      && !ptid.is_pid ());
+
+      /* A new stop: see which of the registers added to stop replies
+	 GDB used while handling the last ones, and keep this stop's
+	 values of them aside until they are used.  */
+      if (learned)
+	{
+	  age_expedited_registers ();
+	  rs->expedited_ptid = ptid;
+	  rs->expedited_values.clear ();
+	  rs->expedited_values.resize (rs->expedited_regs.size ());
+	}
+
       /* Expedited registers.  */
       if (!stop_reply->regcache.empty ())
 	{
@@ -7749,7 +8007,21 @@ remote_target::process_stop_reply (struct stop_reply *stop_reply,
 
 	  for (cached_reg_t &reg : stop_reply->regcache)
 	    {
-	      regcache->raw_supply (reg.num, reg.data);
+	      size_t i = 0;
+
+	      if (learned)
+		while (i < rs->expedited_regs.size ()
+		       && rs->expedited_regs[i].regnum != reg.num)
+		  i++;
+
+	      if (learned && i < rs->expedited_regs.size ())
+		{
+		  int size = register_size (stop_reply->arch, reg.num);
+
+		  rs->expedited_values[i].assign (reg.data, reg.data + size);
+		}
+	      else
+		regcache->raw_supply (reg.num, reg.data);
 	      xfree (reg.data);
 	    }
 
@@ -8076,6 +8348,29 @@ remote_target::fetch_register_using_p (struct regcache *regcache,
   return 1;
 }
 
+/* Forget the copy of the registers kept for vRegDelta packets of the
+   thread the next 'g' or vRegDelta packet applies to, or of all
+   threads if that is not a single known thread.  */
+
+void
+remote_target::forget_register_baselines ()
+{
+  struct remote_state *rs = get_remote_state ();
+  thread_info *thread = NULL;
+
+  if (rs->general_thread != any_thread_ptid
+      && rs->general_thread != magic_null_ptid
+      && rs->general_thread != minus_one_ptid
+      && rs->general_thread != null_ptid)
+    thread = find_thread_ptid (this, rs->general_thread);
+
+  if (thread != NULL)
+    get_remote_thread_info (thread)->reg_baseline.reset ();
+  else
+    for (thread_info *tp : all_non_exited_threads (this))
+      get_remote_thread_info (tp)->reg_baseline.reset ();
+}
+
 /* Fetch the registers included in the target's 'g' packet.  */
 
 int
@@ -8084,6 +8379,12 @@ remote_target::send_g_packet ()
   struct remote_state *rs = get_remote_state ();
   int buf_len;
 
+  /* The stub takes its reply as the new baseline for vRegDelta
+     packets.  Only fetch_registers_using_g records it on our side, so
+     forget the old one until then, in case this reply is not
+     recorded.  */
+  forget_register_baselines ();
+
   xsnprintf (rs->buf.data (), get_remote_packet_size (), "g");
   putpkt (rs->buf);
   getpkt (&rs->buf, 0);
@@ -8225,6 +8526,265 @@ remote_target::fetch_registers_using_g (struct regcache *regcache)
 {
   send_g_packet ();
   process_g_packet (regcache);
+  record_register_baseline (regcache);
+}
+
+/* Keep a copy of the registers of REGCACHE the stub just sent in
+   reply to a 'g' packet, for fetch_registers_using_delta.  */
+
+void
+remote_target::record_register_baseline (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = regcache->arch ();
+  struct remote_state *rs = get_remote_state ();
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+
+  /* The registers of a traceframe are not the ones of the thread.  */
+  if (packet_support (PACKET_vRegDelta) == PACKET_DISABLE
+      || get_traceframe_number () != -1)
+    return;
+
+  thread_info *thread = find_thread_ptid (this, regcache->ptid ());
+  if (thread == NULL)
+    return;
+
+  remote_thread_info *priv = get_remote_thread_info (thread);
+  priv->reg_baseline.reset (new detached_regcache (gdbarch, false));
+
+  for (int i = 0; i < gdbarch_num_regs (gdbarch); i++)
+    if (rsa->regs[i].in_g_packet)
+      {
+	if (regcache->get_register_status (i) == REG_VALID)
+	  priv->reg_baseline->raw_supply (i, *regcache);
+	else
+	  priv->reg_baseline->raw_supply (i, NULL);
+      }
+}
+
+/* Fetch the registers included in the target's 'g' packet with a
+   vRegDelta packet, which only transfers the registers that changed
+   since the stub last sent them, and take the others from the copy
+   of them kept then.  Return false if there is no such copy, or if
+   the stub does not support the packet.  */
+
+bool
+remote_target::fetch_registers_using_delta (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = regcache->arch ();
+  struct remote_state *rs = get_remote_state ();
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+
+  if (packet_support (PACKET_vRegDelta) == PACKET_DISABLE
+      || get_traceframe_number () != -1)
+    return false;
+
+  thread_info *thread = find_thread_ptid (this, regcache->ptid ());
+  if (thread == NULL)
+    return false;
+
+  /* Take the copy until the reply is fully processed: if anything
+     goes wrong on the way, including losing the connection, the stub
+     and GDB may not agree anymore on what it holds, so it must be
+     dropped, and all the registers fetched again with 'g'.  */
+  remote_thread_info *priv = get_remote_thread_info (thread);
+  std::unique_ptr<detached_regcache> baseline
+    = std::move (priv->reg_baseline);
+  if (baseline == NULL || baseline->arch () != gdbarch)
+    return false;
+
+  strcpy (rs->buf.data (), "vRegDelta");
+  putpkt (rs->buf);
+  getpkt (&rs->buf, 0);
+
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_vRegDelta])
+      != PACKET_OK)
+    return false;
+
+  /* The reply is either "OK", if no register changed, or the new
+     value of each register that did, in hex, as "N:VALUE;" entries.
+     The value of an unavailable register is all 'x's.  */
+  const char *p = rs->buf.data ();
+  if (strcmp (p, "OK") != 0)
+    while (*p != '\0')
+      {
+	ULONGEST pnum;
+	const char *p1 = unpack_varlen_hex (p, &pnum);
+	packet_reg *reg = (p1 != p && *p1 == ':'
+			   ? packet_reg_from_pnum (gdbarch, rsa, pnum)
+			   : NULL);
+	const char *end = p1 + 1;
+	long reg_size = 0;
+
+	if (reg != NULL)
+	  {
+	    reg_size = register_size (gdbarch, reg->regnum);
+	    end = strchr (p1 + 1, ';');
+	  }
+	if (reg == NULL || end == NULL || end - (p1 + 1) != 2 * reg_size)
+	  error (_("Malformed reply to a vRegDelta packet: %s"),
+		 rs->buf.data ());
+
+	p = p1 + 1;
+	if (*p == 'x')
+	  baseline->raw_supply (reg->regnum, NULL);
+	else
+	  {
+	    gdb::byte_vector value (reg_size);
+
+	    hex2bin (p, value.data (), reg_size);
+	    baseline->raw_supply (reg->regnum, value.data ());
+	  }
+	p = end + 1;
+      }
+
+  for (int i = 0; i < gdbarch_num_regs (gdbarch); i++)
+    if (rsa->regs[i].in_g_packet)
+      {
+	if (baseline->get_register_status (i) == REG_VALID)
+	  regcache->raw_supply (i, *baseline);
+	else
+	  regcache->raw_supply (i, NULL);
+      }
+
+  priv->reg_baseline = std::move (baseline);
+  return true;
+}
+
+/* Ask the stub to include register REG of REGCACHE in stop replies
+   from now on, with a QExpediteRegisters packet, since GDB had to
+   fetch it while handling a stop.  Registers fetched at other times,
+   for instance by the user, are not worth adding.  */
+
+void
+remote_target::expedite_register (struct regcache *regcache,
+				  packet_reg *reg)
+{
+  struct remote_state *rs = get_remote_state ();
+  std::vector<remote_state::expedited_register> &regs = rs->expedited_regs;
+
+  if (packet_support (PACKET_QExpediteRegisters) == PACKET_DISABLE
+      || get_traceframe_number () != -1
+      || reg->pnum == -1)
+    return;
+
+  /* The core only marks threads stopped once it is done handling
+     their stop.  */
+  thread_info *thread = find_thread_ptid (this, regcache->ptid ());
+  if (thread == NULL || thread->state != THREAD_RUNNING)
+    return;
+
+  /* The registers numbers of another architecture mean nothing for
+     this one.  */
+  if (rs->expedited_arch != regcache->arch ())
+    {
+      rs->expedited_regs_changed |= !regs.empty ();
+      regs.clear ();
+      rs->expedited_values.clear ();
+      rs->expedited_arch = regcache->arch ();
+    }
+
+  if ((remote_expedite_registers_limit >= 0
+       && regs.size () >= remote_expedite_registers_limit)
+      || std::any_of (regs.begin (), regs.end (),
+		      [&] (const remote_state::expedited_register &r)
+		      {
+			return r.pnum == reg->pnum;
+		      }))
+    return;
+
+  regs.push_back ({ reg->pnum, reg->regnum, true, 0 });
+  if (!send_expedited_registers ())
+    regs.pop_back ();
+}
+
+/* Tell the stub which registers to include in stop replies, with a
+   QExpediteRegisters packet.  Return true if it accepted them.  */
+
+bool
+remote_target::send_expedited_registers ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (packet_support (PACKET_QExpediteRegisters) == PACKET_DISABLE)
+    return false;
+
+  std::string packet = "QExpediteRegisters:";
+  for (const remote_state::expedited_register &reg : rs->expedited_regs)
+    {
+      if (&reg != &rs->expedited_regs.front ())
+	packet += ';';
+      packet += phex_nz (reg.pnum, 0);
+    }
+  if (packet.size () >= get_remote_packet_size ())
+    return false;
+
+  putpkt (packet.c_str ());
+  getpkt (&rs->buf, 0);
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_QExpediteRegisters])
+      != PACKET_OK)
+    return false;
+
+  rs->expedited_regs_changed = false;
+  return true;
+}
+
+/* Called for each stop of a thread of the architecture of the
+   registers added to stop replies.  Stop adding those that GDB did not
+   use while handling the last EXPEDITE_IDLE_STOPS stops; the stub is
+   told before the target resumes.  */
+
+void
+remote_target::age_expedited_registers ()
+{
+  struct remote_state *rs = get_remote_state ();
+  std::vector<remote_state::expedited_register> &regs = rs->expedited_regs;
+
+  for (remote_state::expedited_register &reg : regs)
+    {
+      reg.idle_stops = reg.used ? 0 : reg.idle_stops + 1;
+      reg.used = false;
+    }
+
+  auto it = std::remove_if (regs.begin (), regs.end (),
+			    [] (const remote_state::expedited_register &r)
+			    {
+			      return r.idle_stops >= EXPEDITE_IDLE_STOPS;
+			    });
+  if (it != regs.end ())
+    {
+      regs.erase (it, regs.end ());
+      rs->expedited_regs_changed = true;
+    }
+}
+
+/* If the last stop reply included register REGNUM of REGCACHE, as GDB
+   asked, supply it now and return true.  */
+
+bool
+remote_target::supply_expedited_register (struct regcache *regcache,
+					  int regnum)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (regcache->ptid () != rs->expedited_ptid
+      || regcache->arch () != rs->expedited_arch
+      || get_traceframe_number () != -1)
+    return false;
+
+  for (size_t i = 0; i < rs->expedited_values.size (); i++)
+    if (rs->expedited_regs[i].regnum == regnum
+	&& !rs->expedited_values[i].empty ())
+      {
+	regcache->raw_supply (regnum, rs->expedited_values[i].data ());
+	rs->expedited_values[i].clear ();
+
+	thread_info *thread = find_thread_ptid (this, regcache->ptid ());
+	if (thread != NULL && thread->state == THREAD_RUNNING)
+	  rs->expedited_regs[i].used = true;
+	return true;
+      }
+
+  return false;
 }
 
 /* Make the remote selected traceframe match GDB's selected
@@ -8267,12 +8827,20 @@ remote_target::fetch_registers (struct regcache *regcache, int regnum)
 
       gdb_assert (reg != NULL);
 
+      if (supply_expedited_register (regcache, regnum))
+	return;
+
+      expedite_register (regcache, reg);
+
       /* If this register might be in the 'g' packet, try that first -
 	 we are likely to read more than one register.  If this is the
 	 first 'g' packet, we might be overly optimistic about its
 	 contents, so fall back to 'p'.  */
       if (reg->in_g_packet)
 	{
+	  if (fetch_registers_using_delta (regcache))
+	    return;
+
 	  fetch_registers_using_g (regcache);
 	  if (reg->in_g_packet)
 	    return;
@@ -8287,7 +8855,8 @@ remote_target::fetch_registers (struct regcache *regcache, int regnum)
       return;
     }
 
-  fetch_registers_using_g (regcache);
+  if (!fetch_registers_using_delta (regcache))
+    fetch_registers_using_g (regcache);
 
   for (i = 0; i < gdbarch_num_regs (gdbarch); i++)
     if (!rsa->regs[i].in_g_packet)
@@ -8418,6 +8987,11 @@ remote_target::store_registers (struct regcache *regcache, int regnum)
   set_remote_traceframe ();
   set_general_thread (regcache->ptid ());
 
+  /* Don't supply stale values of the registers kept from the last stop
+     reply later.  */
+  if (regcache->ptid () == rs->expedited_ptid)
+    rs->expedited_values.clear ();
+
   if (regnum >= 0)
     {
       packet_reg *reg = packet_reg_from_regnum (gdbarch, rsa, regnum);
@@ -8848,8 +9422,81 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
-  /* Construct "m"<memaddr>","<len>".  */
+  if (len_units > todo_units)
+    {
+      /* If this read takes more than one packet, and the stub accepts
+	 several requests at once, don't wait for each reply before
+	 sending the next request.  */
+      if (remote_pipeline_window () > 1
+	  && buf_size_bytes >= PIPELINED_TAG_ROOM + 1 + 2 * unit_size)
+	return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					    unit_size, xfered_len_units);
+
+      /* Otherwise, if the stub can compress its replies, read as much
+	 as it allows at once.  If that fails, some of the memory may
+	 still be readable, so fall back to reading one packet's
+	 worth.  */
+      if (packet_support (PACKET_vReadCompressed) == PACKET_ENABLE
+	  && rs->read_compressed_max > 0)
+	{
+	  target_xfer_status status
+	    = remote_read_bytes_compressed (memaddr, myaddr, len_units,
+					    unit_size, xfered_len_units);
+	  if (status != TARGET_XFER_E_IO)
+	    return status;
+	}
+    }
+
   memaddr = remote_address_masked (memaddr);
+
+  /* Only use 'x' if the stub reported it supports it: a stub that
+     does not know it may reply with an error rather than with an
+     empty packet.  */
+  if (packet_support (PACKET_x) == PACKET_ENABLE)
+    {
+      int todo_x_units, packet_len;
+
+      /* Each byte takes at least one byte in the reply; the stub
+	 sends fewer than requested if they don't fit.  */
+      todo_x_units = std::min (len_units,
+			       (ULONGEST) ((buf_size_bytes - 1) / unit_size));
+
+      /* Construct "x"<memaddr>","<len>".  */
+      p = rs->buf.data ();
+      *p++ = 'x';
+      p += hexnumstr (p, (ULONGEST) memaddr);
+      *p++ = ',';
+      p += hexnumstr (p, (ULONGEST) todo_x_units);
+      *p = '\0';
+      putpkt (rs->buf);
+      packet_len = getpkt_sane (&rs->buf, 0);
+      if (packet_len < 0)
+	return TARGET_XFER_E_IO;
+
+      switch (packet_ok (rs->buf, &remote_protocol_packets[PACKET_x]))
+	{
+	case PACKET_ERROR:
+	  return TARGET_XFER_E_IO;
+	case PACKET_OK:
+	  /* Reply is 'b' followed by the escaped binary data.  */
+	  if (rs->buf[0] != 'b')
+	    error (_("Unexpected reply to an 'x' packet: %s"),
+		   rs->buf.data ());
+	  decoded_bytes
+	    = remote_unescape_input ((const gdb_byte *) rs->buf.data () + 1,
+				     packet_len - 1, myaddr,
+				     todo_x_units * unit_size);
+	  /* Return what we have.  Let higher layers handle partial
+	     reads.  */
+	  *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
+	  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+	case PACKET_UNKNOWN:
+	  /* Use 'm' instead.  */
+	  break;
+	}
+    }
+
+  /* Construct "m"<memaddr>","<len>".  */
   p = rs->buf.data ();
   *p++ = 'm';
   p += hexnumstr (p, (ULONGEST) memaddr);
@@ -8871,6 +9518,292 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Decode REPLY, of length REPLY_LEN, the reply to a vReadCompressed
+   packet for LEN bytes, into MYADDR.  Return the number of bytes
+   decoded, or -1 if the reply is malformed.  */
+
+static int
+decode_compressed_reply (const char *reply, int reply_len,
+			 gdb_byte *myaddr, ULONGEST len)
+{
+  if (reply[0] == 'b')
+    {
+      /* The data did not compress; the reply is like an 'x' reply.  */
+      return remote_unescape_input ((const gdb_byte *) reply + 1,
+				    reply_len - 1, myaddr, len);
+    }
+  else if (reply[0] == 'z')
+    {
+      ULONGEST read_len;
+      const char *data = unpack_varlen_hex (reply + 1, &read_len);
+
+      if (*data != ';' || read_len > len)
+	return -1;
+      data++;
+
+      /* The compressed data, escaped.  */
+      int data_len = reply_len - (data - reply);
+      gdb::byte_vector zdata (data_len);
+      int zlen = remote_unescape_input ((const gdb_byte *) data, data_len,
+					zdata.data (), data_len);
+
+      uLongf out_len = read_len;
+      if (uncompress (myaddr, &out_len, zdata.data (), zlen) != Z_OK
+	  || out_len != read_len)
+	return -1;
+      return out_len;
+    }
+
+  return -1;
+}
+
+/* Like remote_read_bytes_1, but read up to as much memory as the
+   stub allows with a vReadCompressed packet, whose reply may be
+   compressed with zlib.  This may read much more than fits in a
+   packet.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_compressed (CORE_ADDR memaddr,
+					     gdb_byte *myaddr,
+					     ULONGEST len_units,
+					     int unit_size,
+					     ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST todo_units = std::min (len_units, rs->read_compressed_max);
+  int packet_len, decoded_bytes;
+  char *p;
+
+  /* Construct "vReadCompressed:"<memaddr>","<len>".  */
+  p = rs->buf.data ();
+  strcpy (p, "vReadCompressed:");
+  p += strlen (p);
+  p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr));
+  *p++ = ',';
+  p += hexnumstr (p, todo_units);
+  *p = '\0';
+  putpkt (rs->buf);
+  packet_len = getpkt_sane (&rs->buf, 0);
+  if (packet_len < 0)
+    return TARGET_XFER_E_IO;
+
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_vReadCompressed])
+      != PACKET_OK)
+    return TARGET_XFER_E_IO;
+
+  decoded_bytes = decode_compressed_reply (rs->buf.data (), packet_len,
+					   myaddr, todo_units * unit_size);
+  if (decoded_bytes < 0)
+    error (_("Malformed reply to a vReadCompressed packet."));
+
+  /* Return what we have.  Let higher layers handle partial reads.  */
+  *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
+  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+}
+
+/* Return the number of vPipelined requests that may be outstanding
+   at once, or zero if requests must not be pipelined.  Requests are
+   only pipelined in no-ack mode, since otherwise each packet has to
+   be acknowledged before the next one is sent anyway.  */
+
+int
+remote_target::remote_pipeline_window ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (!rs->noack_mode || packet_support (PACKET_vPipelined) != PACKET_ENABLE)
+    return 0;
+
+  return rs->pipeline_window;
+}
+
+/* Send the request INNER wrapped in a vPipelined packet, without
+   waiting for its reply.  Return the tag identifying the request.  */
+
+unsigned int
+remote_target::putpkt_pipelined (const char *inner)
+{
+  struct remote_state *rs = get_remote_state ();
+  unsigned int tag = ++rs->pipeline_tag;
+
+  putpkt (string_printf ("vPipelined;%x;%s", tag, inner).c_str ());
+  return tag;
+}
+
+/* Read the reply to a vPipelined request.  Store the tag of the
+   request it answers in *TAG, and the length of the reply to the
+   wrapped request in *LEN.  Return a pointer to the reply to the
+   wrapped request, which is in the remote packet buffer, or NULL if
+   the reply is malformed.  */
+
+const char *
+remote_target::getpkt_pipelined (unsigned int *tag, int *len)
+{
+  struct remote_state *rs = get_remote_state ();
+  int packet_len;
+  const char *p;
+  ULONGEST value;
+
+  packet_len = getpkt_sane (&rs->buf, 0);
+  if (packet_len < 0)
+    error (_("Timed out waiting for the reply to a pipelined request."));
+
+  if (!isxdigit (rs->buf[0]))
+    return NULL;
+  p = unpack_varlen_hex (rs->buf.data (), &value);
+  if (*p != ';')
+    return NULL;
+  p++;
+
+  *tag = value;
+  *len = packet_len - (p - rs->buf.data ());
+  return p;
+}
+
+/* Like remote_read_bytes_1, but read as many packets' worth of memory
+   as the stub accepts requests at once.  The vReadCompressed, 'x' or
+   'm' requests for consecutive chunks of memory are all sent, wrapped
+   in vPipelined packets, before reading any reply, so their round
+   trips overlap.  Save the number of units read contiguously from
+   MEMADDR in *XFERED_LEN_UNITS.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units,
+					    int unit_size,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  int buf_size_bytes = get_memory_read_packet_size ();
+  ULONGEST chunk_units, nchunks, i, total;
+  bool malformed = false;
+  bool compressed = (packet_support (PACKET_vReadCompressed) == PACKET_ENABLE
+		     && rs->read_compressed_max > 0);
+  bool binary = packet_support (PACKET_x) == PACKET_ENABLE;
+
+  /* Leave room in each reply for the tag.  Ask for no more than fits
+     even if each byte of a binary reply needs escaping, so that the
+     stub does not send less than requested.  Compressed replies fall
+     back to binary ones when the data does not compress, so they
+     need the same room.  */
+  chunk_units = (buf_size_bytes - PIPELINED_TAG_ROOM - 1) / unit_size / 2;
+  if (compressed)
+    chunk_units = std::min (chunk_units, rs->read_compressed_max);
+  nchunks = std::min<ULONGEST> (remote_pipeline_window (),
+				(len_units + chunk_units - 1) / chunk_units);
+
+  auto chunk_len = [&] (ULONGEST chunk)
+    {
+      return std::min (chunk_units, len_units - chunk * chunk_units);
+    };
+
+  /* The tag of the request for each chunk, and the number of units
+     its reply provided, or -1 if the request failed.  */
+  std::vector<unsigned int> tags (nchunks);
+  std::vector<LONGEST> units_read (nchunks, -1);
+
+  for (i = 0; i < nchunks; i++)
+    {
+      char *p = rs->buf.data ();
+
+      /* Construct "vReadCompressed:"<memaddr>","<len>",
+	 "x"<memaddr>","<len>" or "m"<memaddr>","<len>".  */
+      if (compressed)
+	{
+	  strcpy (p, "vReadCompressed:");
+	  p += strlen (p);
+	}
+      else
+	*p++ = binary ? 'x' : 'm';
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr
+							   + i * chunk_units));
+      *p++ = ',';
+      p += hexnumstr (p, chunk_len (i));
+      *p = '\0';
+      tags[i] = putpkt_pipelined (rs->buf.data ());
+    }
+
+  /* Read all the replies, even if one of them is bad, so that none is
+     left for a later request to see.  The stub may reply in any
+     order.  */
+  for (ULONGEST n = 0; n < nchunks; n++)
+    {
+      unsigned int tag;
+      int reply_len;
+      const char *reply = getpkt_pipelined (&tag, &reply_len);
+
+      if (reply == NULL)
+	{
+	  malformed = true;
+	  continue;
+	}
+
+      auto it = std::find (tags.begin (), tags.end (), tag);
+      if (it == tags.end ())
+	{
+	  malformed = true;
+	  continue;
+	}
+
+      i = it - tags.begin ();
+      if (packet_check_result (reply) != PACKET_OK)
+	continue;
+
+      gdb_byte *chunk_addr = myaddr + i * chunk_units * unit_size;
+      if (compressed)
+	{
+	  units_read[i] = decode_compressed_reply (reply, reply_len,
+						   chunk_addr,
+						   chunk_len (i) * unit_size);
+	  if (units_read[i] < 0)
+	    {
+	      malformed = true;
+	      continue;
+	    }
+	}
+      else if (binary)
+	{
+	  /* Reply is 'b' followed by the escaped binary data.  */
+	  if (reply[0] != 'b')
+	    {
+	      malformed = true;
+	      continue;
+	    }
+	  units_read[i] = remote_unescape_input ((const gdb_byte *) reply + 1,
+						 reply_len - 1, chunk_addr,
+						 chunk_len (i) * unit_size);
+	}
+      else
+	{
+	  /* Reply describes memory byte by byte, each byte encoded as
+	     two hex characters.  */
+	  units_read[i] = hex2bin (reply, chunk_addr,
+				   chunk_len (i) * unit_size);
+	}
+      units_read[i] /= unit_size;
+    }
+
+  if (malformed)
+    error (_("Malformed reply to a pipelined remote request."));
+
+  /* Return what was read up to the first failed or short chunk.  Let
+     higher layers handle partial reads.  */
+  total = 0;
+  for (i = 0; i < nchunks && units_read[i] >= 0; i++)
+    {
+      total += units_read[i];
+      if ((ULONGEST) units_read[i] < chunk_len (i))
+	break;
+    }
+
+  if (units_read[0] < 0)
+    return TARGET_XFER_E_IO;
+
+  *xfered_len_units = total;
+  return (total != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -8988,6 +9921,116 @@ remote_target::remote_read_bytes (CORE_ADDR memaddr,
 }
 
 
+/* Implement the "read_memory_multiple" target_ops method, with
+   vReadMultiple packets.  */
+
+bool
+remote_target::read_memory_multiple
+  (gdb::array_view<memory_read_request> requests)
+{
+  struct remote_state *rs = get_remote_state ();
+  int unit_size = gdbarch_addressable_memory_unit_size (target_gdbarch ());
+
+  /* Reading from a traceframe needs care that remote_read_bytes
+     takes, so leave it to it.  */
+  if (packet_support (PACKET_vReadMultiple) == PACKET_DISABLE
+      || unit_size != 1
+      || !target_has_execution
+      || get_traceframe_number () != -1)
+    return false;
+
+  set_remote_traceframe ();
+  set_general_thread (inferior_ptid);
+
+  int buf_size = get_memory_read_packet_size ();
+
+  size_t i = 0;
+  while (i < requests.size ())
+    {
+      size_t first = i;
+      int reply_size = 0;
+      char *p;
+
+      /* Construct "vReadMultiple:"<addr>","<len>[";"<addr>","<len>]...,
+	 with as many blocks as fit both in the packet and in the reply,
+	 where each block takes two hex characters per byte and a
+	 ';'.  */
+      p = rs->buf.data ();
+      strcpy (p, "vReadMultiple:");
+      p += strlen (p);
+      for (; i < requests.size (); i++)
+	{
+	  const memory_read_request &req = requests[i];
+	  char block[2 * sizeof (ULONGEST) * 2 + 3];
+	  int block_len = 0;
+
+	  if (i > first)
+	    block[block_len++] = ';';
+	  block_len += hexnumstr (block + block_len,
+				  (ULONGEST) remote_address_masked (req.addr));
+	  block[block_len++] = ',';
+	  block_len += hexnumstr (block + block_len, req.len);
+
+	  if (p - rs->buf.data () + block_len >= buf_size
+	      || req.len > (buf_size - reply_size - 1) / 2)
+	    break;
+
+	  memcpy (p, block, block_len);
+	  p += block_len;
+	  reply_size += 2 * req.len + 1;
+	}
+      *p = '\0';
+
+      /* A block too large for any packet is read on its own by the
+	 caller.  */
+      if (i == first)
+	{
+	  i++;
+	  continue;
+	}
+
+      putpkt (rs->buf);
+      getpkt (&rs->buf, 0);
+
+      switch (packet_ok (rs->buf,
+			 &remote_protocol_packets[PACKET_vReadMultiple]))
+	{
+	case PACKET_UNKNOWN:
+	  return false;
+	case PACKET_ERROR:
+	  /* Let the caller read these blocks on their own.  */
+	  continue;
+	case PACKET_OK:
+	  break;
+	}
+
+      /* The reply holds the contents of each block in hex, each
+	 followed by a ';'.  A block may be cut short, or be empty, if
+	 the stub could not read all of it.  */
+      const char *q = rs->buf.data ();
+      for (size_t j = first; j < i; j++)
+	{
+	  memory_read_request &req = requests[j];
+	  const char *end = strchr (q, ';');
+
+	  if (end == NULL
+	      || (end - q) % 2 != 0
+	      || (ULONGEST) (end - q) / 2 > req.len)
+	    {
+	      /* Don't trust any of the reply; let the caller read these
+		 blocks on their own.  */
+	      for (size_t k = first; k < i; k++)
+		requests[k].xfered_len = 0;
+	      break;
+	    }
+
+	  req.xfered_len = hex2bin (q, req.buf, (end - q) / 2);
+	  q = end + 1;
+	}
+    }
+
+  return true;
+}
 
 /* Sends a packet with content determined by the printf format string
    FORMAT and the remaining arguments, then gets the reply.  Returns
@@ -10908,6 +11951,17 @@ remote_target::remote_read_qxfer (const char *object_name,
      the target is free to respond with slightly less data.  We subtract
      five to account for the response type and the protocol frame.  */
   n = std::min<LONGEST> (get_remote_packet_size () - 5, len);
+
+  /* If this read takes more than one packet, and the stub accepts
+     several requests at once, don't wait for each reply before
+     sending the next request.  */
+  if (len > n
+      && packet_config_support (packet) == PACKET_ENABLE
+      && remote_pipeline_window () > 1
+      && get_remote_packet_size () > 5 + PIPELINED_TAG_ROOM)
+    return remote_read_qxfer_pipelined (object_name, annex, readbuf,
+					offset, len, xfered_len);
+
   snprintf (rs->buf.data (), get_remote_packet_size () - 4,
 	    "qXfer:%s:read:%s:%s,%s",
 	    object_name, annex ? annex : "",
@@ -10954,6 +12008,133 @@ remote_target::remote_read_qxfer (const char *object_name,
     }
 }
 
+/* Like remote_read_qxfer, but read as many packets' worth of the
+   object as the stub accepts requests at once, wrapping the qXfer
+   requests for consecutive chunks in vPipelined packets.  The object
+   must already be known to be supported.  */
+
+target_xfer_status
+remote_target::remote_read_qxfer_pipelined (const char *object_name,
+					    const char *annex,
+					    gdb_byte *readbuf,
+					    ULONGEST offset, LONGEST len,
+					    ULONGEST *xfered_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  LONGEST chunk_size, nchunks, i, total;
+  bool malformed = false;
+
+  /* As in remote_read_qxfer, but also leave room for the tag.  */
+  chunk_size = get_remote_packet_size () - 5 - PIPELINED_TAG_ROOM;
+  nchunks = std::min<LONGEST> (remote_pipeline_window (),
+			       (len + chunk_size - 1) / chunk_size);
+
+  auto chunk_len = [&] (LONGEST chunk)
+    {
+      return std::min (chunk_size, len - chunk * chunk_size);
+    };
+
+  /* The tag of the request for each chunk, the number of bytes its
+     reply provided, or -1 if the request failed, and whether the
+     reply marked the end of the object.  */
+  std::vector<unsigned int> tags (nchunks);
+  std::vector<LONGEST> bytes_read (nchunks, -1);
+  std::vector<bool> last (nchunks, false);
+
+  for (i = 0; i < nchunks; i++)
+    {
+      ULONGEST chunk_offset = offset + i * chunk_size;
+      LONGEST todo = chunk_len (i);
+      std::string request
+	= string_printf ("qXfer:%s:read:%s:%s,%s",
+			 object_name, annex ? annex : "",
+			 phex_nz (chunk_offset, sizeof chunk_offset),
+			 phex_nz (todo, sizeof todo));
+
+      tags[i] = putpkt_pipelined (request.c_str ());
+    }
+
+  /* Read all the replies, even if one of them is bad, so that none is
+     left for a later request to see.  The stub may reply in any
+     order.  */
+  for (LONGEST n = 0; n < nchunks; n++)
+    {
+      unsigned int tag;
+      int reply_len;
+      const char *reply = getpkt_pipelined (&tag, &reply_len);
+
+      if (reply == NULL)
+	{
+	  malformed = true;
+	  continue;
+	}
+
+      auto it = std::find (tags.begin (), tags.end (), tag);
+      if (it == tags.end ())
+	{
+	  malformed = true;
+	  continue;
+	}
+
+      i = it - tags.begin ();
+      if (packet_check_result (reply) != PACKET_OK)
+	continue;
+
+      /* 'm' means there is (or at least might be) more data after
+	 this batch, which needs at least one byte of data in it.  */
+      if ((reply[0] != 'l' && reply[0] != 'm')
+	  || (reply[0] == 'm' && reply_len == 1))
+	{
+	  malformed = true;
+	  continue;
+	}
+
+      bytes_read[i] = remote_unescape_input ((const gdb_byte *) reply + 1,
+					     reply_len - 1,
+					     readbuf + i * chunk_size,
+					     chunk_len (i));
+      last[i] = reply[0] == 'l';
+    }
+
+  if (malformed)
+    error (_("Malformed reply to a pipelined remote request."));
+
+  /* Return what was read up to the first failed or short chunk, or
+     up to the end of the object.  The stub may send less data than
+     requested without it being the end of the object; the data of any
+     later chunk does not follow on from it.  */
+  total = 0;
+  for (i = 0; i < nchunks && bytes_read[i] >= 0; i++)
+    {
+      total += bytes_read[i];
+
+      /* As in remote_read_qxfer, record that we have the final block
+	 of a non-empty object.  */
+      if (last[i])
+	{
+	  if (offset + total > 0)
+	    {
+	      rs->finished_object = xstrdup (object_name);
+	      rs->finished_annex = xstrdup (annex ? annex : "");
+	      rs->finished_offset = offset + total;
+	    }
+	  break;
+	}
+
+      if (bytes_read[i] < chunk_len (i))
+	break;
+    }
+
+  if (bytes_read[0] < 0)
+    return TARGET_XFER_E_IO;
+
+  if (total == 0)
+    return TARGET_XFER_EOF;
+
+  *xfered_len = total;
+  return TARGET_XFER_OK;
+}
+
 enum target_xfer_status
 remote_target::xfer_partial (enum target_object object,
 			     const char *annex, gdb_byte *readbuf,
@@ -14516,6 +15697,15 @@ Show the maximum number of target hardware breakpoints."), _("\
 Specify \"unlimited\" for unlimited hardware breakpoints."),
 			    NULL, show_hardware_breakpoint_limit,
 			    &remote_set_cmdlist, &remote_show_cmdlist);
+  add_setshow_zuinteger_unlimited_cmd ("expedite-registers-limit", no_class,
+			    &remote_expedite_registers_limit, _("\
+Set the maximum number of registers added to stop replies."), _("\
+Show the maximum number of registers added to stop replies."), _("\
+When GDB has to fetch a register while handling a stop, it asks the\n\
+stub to include that register in the following stop replies, until this\n\
+many registers were added.  Specify \"unlimited\" for no limit."),
+			    NULL, show_expedite_registers_limit,
+			    &remote_set_cmdlist, &remote_show_cmdlist);
 
   add_setshow_zuinteger_cmd ("remoteaddresssize", class_obscure,
 			     &remote_address_size, _("\
@@ -14777,6 +15967,24 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vPipelined],
+			 "vPipelined", "pipelined-requests", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_x],
+			 "x", "binary-upload", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vReadCompressed],
+			 "vReadCompressed", "compressed-memory-read", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vReadMultiple],
+			 "vReadMultiple", "read-multiple", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QExpediteRegisters],
+			 "QExpediteRegisters", "expedite-registers", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vRegDelta],
+			 "vRegDelta", "register-delta", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
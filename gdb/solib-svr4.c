@@ -45,6 +45,11 @@
 #include "auxv.h"
 #include "gdb_bfd.h"
 #include "probe.h"
+#include "cli/cli-cmds.h"
+#include "gdbcmd.h"
+
+#include <unordered_map>
+#include <unordered_set>
 
 static struct link_map_offsets *svr4_fetch_link_map_offsets (void);
 static int svr4_have_link_map_offsets (void);
@@ -109,6 +114,11 @@ enum probe_action
      the update fails or is not possible, fall back to reloading
      the list in full.  */
   UPDATE_OR_RELOAD,
+
+  /* Attempt to remove the unloaded objects from the shared object
+     list.  If that fails or is not possible, fall back to reloading
+     the list in full.  */
+  REMOVE_OR_RELOAD,
 };
 
 /* A probe's name and its associated action.  */
@@ -134,7 +144,7 @@ static const struct probe_info probe_info[] =
   { "map_failed", DO_NOTHING },
   { "reloc_complete", UPDATE_OR_RELOAD },
   { "unmap_start", DO_NOTHING },
-  { "unmap_complete", FULL_RELOAD },
+  { "unmap_complete", REMOVE_OR_RELOAD },
 };
 
 #define NUM_PROBES ARRAY_SIZE (probe_info)
@@ -177,36 +187,105 @@ svr4_same (struct so_list *gdb, struct so_list *inferior)
   return (svr4_same_1 (gdb->so_original_name, inferior->so_original_name));
 }
 
+/* Statistics about how the shared object lists were kept up to date.
+   See "maint print svr4-solib-statistics".  */
+
+struct svr4_solib_stats
+{
+  /* The number of times the probes-based interface added objects to a
+     list without reading it all again.  */
+  unsigned long incremental_additions = 0;
+
+  /* The number of times the probes-based interface removed objects
+     from a list without reading it all again.  */
+  unsigned long incremental_removals = 0;
+
+  /* The number of times the probes-based interface read a list in
+     full.  */
+  unsigned long full_reloads = 0;
+
+  /* The number of link map entries read from the inferior on their
+     own, and together with others.  */
+  unsigned long lm_entries_read = 0;
+  unsigned long lm_entries_read_in_bulk = 0;
+
+  /* The number of shared object names read from the inferior, and
+     found unchanged since the list was last read.  */
+  unsigned long names_read = 0;
+  unsigned long names_reused = 0;
+};
+
+static struct svr4_solib_stats svr4_solib_statistics;
+
+/* Return the link map entry at LM_ADDR, whose contents were read
+   into LM.  */
+
+static std::unique_ptr<lm_info_svr4>
+lm_info_extract (CORE_ADDR lm_addr, const gdb_byte *lm)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  struct type *ptr_type = builtin_type (target_gdbarch ())->builtin_data_ptr;
+  std::unique_ptr<lm_info_svr4> lm_info (new lm_info_svr4);
+
+  lm_info->lm_addr = lm_addr;
+
+  lm_info->l_addr_inferior = extract_typed_address (&lm[lmo->l_addr_offset],
+						    ptr_type);
+  lm_info->l_ld = extract_typed_address (&lm[lmo->l_ld_offset], ptr_type);
+  lm_info->l_next = extract_typed_address (&lm[lmo->l_next_offset],
+					   ptr_type);
+  lm_info->l_prev = extract_typed_address (&lm[lmo->l_prev_offset],
+					   ptr_type);
+  lm_info->l_name = extract_typed_address (&lm[lmo->l_name_offset],
+					   ptr_type);
+
+  return lm_info;
+}
+
 static std::unique_ptr<lm_info_svr4>
 lm_info_read (CORE_ADDR lm_addr)
 {
   struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
-  std::unique_ptr<lm_info_svr4> lm_info;
 
   gdb::byte_vector lm (lmo->link_map_size);
 
+  svr4_solib_statistics.lm_entries_read++;
   if (target_read_memory (lm_addr, lm.data (), lmo->link_map_size) != 0)
-    warning (_("Error reading shared library list entry at %s"),
-	     paddress (target_gdbarch (), lm_addr));
-  else
     {
-      struct type *ptr_type = builtin_type (target_gdbarch ())->builtin_data_ptr;
-
-      lm_info.reset (new lm_info_svr4);
-      lm_info->lm_addr = lm_addr;
-
-      lm_info->l_addr_inferior = extract_typed_address (&lm[lmo->l_addr_offset],
-							ptr_type);
-      lm_info->l_ld = extract_typed_address (&lm[lmo->l_ld_offset], ptr_type);
-      lm_info->l_next = extract_typed_address (&lm[lmo->l_next_offset],
-					       ptr_type);
-      lm_info->l_prev = extract_typed_address (&lm[lmo->l_prev_offset],
-					       ptr_type);
-      lm_info->l_name = extract_typed_address (&lm[lmo->l_name_offset],
-					       ptr_type);
+      warning (_("Error reading shared library list entry at %s"),
+	       paddress (target_gdbarch (), lm_addr));
+      return NULL;
     }
 
-  return lm_info;
+  return lm_info_extract (lm_addr, lm.data ());
+}
+
+/* Read the link map entries at each of ADDRS, with as few requests as
+   possible.  Return the entries that could be read, indexed by their
+   address.  */
+
+static std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>>
+lm_info_read_multiple (gdb::array_view<const CORE_ADDR> addrs)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>> entries;
+  std::vector<memory_read_request> requests;
+  gdb::byte_vector buf (addrs.size () * lmo->link_map_size);
+
+  for (size_t i = 0; i < addrs.size (); i++)
+    requests.emplace_back (addrs[i], &buf[i * lmo->link_map_size],
+			   lmo->link_map_size);
+
+  target_read_raw_memory_multiple (current_top_target (), requests);
+
+  for (const memory_read_request &req : requests)
+    if (req.xfered_len == req.len)
+      {
+	svr4_solib_statistics.lm_entries_read_in_bulk++;
+	entries[req.addr] = lm_info_extract (req.addr, req.buf);
+      }
+
+  return entries;
 }
 
 static int
@@ -322,6 +401,24 @@ lm_addr_check (const struct so_list *so, bfd *abfd)
   return li->l_addr;
 }
 
+/* A link map entry as last read by svr4_read_so_list, used to read
+   it again along with the others, and to avoid reading its name
+   again.  */
+
+struct svr4_cached_lm
+{
+  /* The value of the entry's l_name field.  */
+  CORE_ADDR l_name;
+
+  /* True if NAME holds the string L_NAME pointed to.  */
+  bool name_p;
+  std::string name;
+};
+
+/* The link map entries of a chain, indexed by their address.  */
+
+typedef std::unordered_map<CORE_ADDR, svr4_cached_lm> svr4_lm_cache;
+
 /* Per pspace SVR4 specific data.  */
 
 struct svr4_info
@@ -362,6 +459,15 @@ struct svr4_info
   /* List of objects loaded into the inferior, used by the probes-
      based interface.  */
   struct so_list *solib_list = nullptr;
+
+  /* Incremented each time the probes-based interface changes
+     SOLIB_LIST.  */
+  unsigned int solib_list_generation = 0;
+
+  /* The entries of the main link map chain, as last read by
+     svr4_current_sos_direct.  The next read fetches them all at once,
+     and reuses the names of those still on the chain.  */
+  svr4_lm_cache lm_cache;
 };
 
 /* Per-program-space data key.  */
@@ -1278,29 +1384,217 @@ svr4_default_sos (svr4_info *info)
   return newobj;
 }
 
+/* A lower bound of the page size of the targets we support.  Names
+   are read in chunks that don't cross such a page boundary, so as not
+   to read past the end of mapped memory.  */
+
+static const CORE_ADDR svr4_name_chunk_size = 4096;
+
+/* Return the length of the first chunk of a shared object's name
+   read from ADDR.  */
+
+static size_t
+svr4_so_name_chunk_len (CORE_ADDR addr)
+{
+  size_t len = svr4_name_chunk_size - (addr & (svr4_name_chunk_size - 1));
+
+  return std::min (len, (size_t) SO_NAME_MAX_PATH_SIZE - 1);
+}
+
+/* Read the pathname of a shared object from the inferior at ADDR.
+   target_read_string reads strings a few bytes at a time, which costs
+   many round trips with remote targets.  Read the name in as few
+   requests as possible instead, one per page it spans.  Return NULL
+   if the name can't be read.  */
+
+static gdb::unique_xmalloc_ptr<char>
+svr4_read_so_name (CORE_ADDR addr)
+{
+  const size_t max_len = SO_NAME_MAX_PATH_SIZE - 1;
+  std::string name;
+
+  svr4_solib_statistics.names_read++;
+  while (name.size () < max_len)
+    {
+      CORE_ADDR chunk_addr = addr + name.size ();
+      size_t chunk_len = std::min (svr4_so_name_chunk_len (chunk_addr),
+				   max_len - name.size ());
+
+      gdb::byte_vector chunk (chunk_len);
+      if (target_read_memory (chunk_addr, chunk.data (), chunk_len) != 0)
+	{
+	  /* Something in the chunk is not readable.  Let
+	     target_read_string find out how much of it is.  */
+	  return target_read_string (addr, max_len);
+	}
+
+      auto nul = std::find (chunk.begin (), chunk.end (), 0);
+      name.append ((const char *) chunk.data (), nul - chunk.begin ());
+      if (nul != chunk.end ())
+	break;
+    }
+
+  return make_unique_xstrdup (name.c_str ());
+}
+
+/* Like svr4_read_so_name, but read the names at each of ADDRS at
+   once.  Only the names that don't fit in their first chunk need more
+   requests.  */
+
+static std::vector<gdb::unique_xmalloc_ptr<char>>
+svr4_read_so_names (gdb::array_view<const CORE_ADDR> addrs)
+{
+  std::vector<gdb::unique_xmalloc_ptr<char>> names (addrs.size ());
+  std::vector<gdb::byte_vector> chunks;
+  std::vector<memory_read_request> requests;
+
+  if (addrs.size () < 2)
+    {
+      if (!addrs.empty ())
+	names[0] = svr4_read_so_name (addrs[0]);
+      return names;
+    }
+
+  chunks.reserve (addrs.size ());
+  for (CORE_ADDR addr : addrs)
+    {
+      chunks.emplace_back (svr4_so_name_chunk_len (addr));
+      requests.emplace_back (addr, chunks.back ().data (),
+			     chunks.back ().size ());
+    }
+
+  target_read_raw_memory_multiple (current_top_target (), requests);
+
+  for (size_t i = 0; i < addrs.size (); i++)
+    {
+      const gdb_byte *chunk = chunks[i].data ();
+      const gdb_byte *end = chunk + requests[i].xfered_len;
+      const gdb_byte *nul = std::find (chunk, end, 0);
+
+      if (nul != end)
+	{
+	  svr4_solib_statistics.names_read++;
+	  names[i] = make_unique_xstrdup ((const char *) chunk);
+	}
+      else
+	names[i] = svr4_read_so_name (addrs[i]);
+    }
+
+  return names;
+}
+
+/* Read the link map entries of CACHE, and the names they pointed to,
+   with as few requests as possible.  Return the entries that could be
+   read, indexed by their address.  Add to NAMES_UNCHANGED the address
+   of the entries whose l_name still points to the name in CACHE.  */
+
+static std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>>
+svr4_prefetch_lm_cache (const svr4_lm_cache &cache,
+			std::unordered_set<CORE_ADDR> *names_unchanged)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>> entries;
+  std::vector<memory_read_request> requests;
+  size_t size = 0;
+
+  for (const auto &entry : cache)
+    {
+      size += lmo->link_map_size;
+      if (entry.second.name_p)
+	size += entry.second.name.size () + 1;
+    }
+
+  gdb::byte_vector buf (size);
+  gdb_byte *p = buf.data ();
+  for (const auto &entry : cache)
+    {
+      requests.emplace_back (entry.first, p, lmo->link_map_size);
+      p += lmo->link_map_size;
+      if (entry.second.name_p)
+	{
+	  requests.emplace_back (entry.second.l_name, p,
+				 entry.second.name.size () + 1);
+	  p += entry.second.name.size () + 1;
+	}
+    }
+
+  target_read_raw_memory_multiple (current_top_target (), requests);
+
+  /* The requests are in the order of CACHE.  */
+  const memory_read_request *req = requests.data ();
+  for (const auto &entry : cache)
+    {
+      const memory_read_request &lm_req = *req++;
+      if (lm_req.xfered_len == lm_req.len)
+	{
+	  std::unique_ptr<lm_info_svr4> li
+	    = lm_info_extract (entry.first, lm_req.buf);
+
+	  if (entry.second.name_p)
+	    {
+	      const memory_read_request &name_req = *req++;
+	      if (li->l_name == entry.second.l_name
+		  && name_req.xfered_len == name_req.len
+		  && memcmp (name_req.buf, entry.second.name.c_str (),
+			     name_req.len) == 0)
+		names_unchanged->insert (entry.first);
+	    }
+
+	  svr4_solib_statistics.lm_entries_read_in_bulk++;
+	  entries[entry.first] = std::move (li);
+	}
+      else if (entry.second.name_p)
+	req++;
+    }
+
+  return entries;
+}
+
 /* Read the whole inferior libraries chain starting at address LM.
    Expect the first entry in the chain's previous entry to be PREV_LM.
    Add the entries to the tail referenced by LINK_PTR_PTR.  Ignore the
    first entry if IGNORE_FIRST and set global MAIN_LM_ADDR according
    to it.  Returns nonzero upon success.  If zero is returned the
    entries stored to LINK_PTR_PTR are still valid although they may
-   represent only part of the inferior library list.  */
+   represent only part of the inferior library list.
+
+   If CACHE is not NULL, it holds the entries of the chain as read by a
+   previous call.  They are read again all at once, as most of them
+   are usually still on the chain, and the names of those whose name
+   is unchanged are not read again.  The other entries are read one at
+   a time, following the chain, and their names at once at the end.
+   CACHE is then updated with the chain read.  */
 
 static int
 svr4_read_so_list (svr4_info *info, CORE_ADDR lm, CORE_ADDR prev_lm,
-		   struct so_list ***link_ptr_ptr, int ignore_first)
+		   struct so_list ***link_ptr_ptr, int ignore_first,
+		   svr4_lm_cache *cache = NULL)
 {
   CORE_ADDR first_l_name = 0;
   CORE_ADDR next_lm;
+  int result = 1;
+
+  std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>> prefetched;
+  std::unordered_set<CORE_ADDR> names_unchanged;
+  if (cache != NULL && !cache->empty ())
+    prefetched = svr4_prefetch_lm_cache (*cache, &names_unchanged);
 
+  /* Walk the chain first.  */
+  std::vector<std::unique_ptr<lm_info_svr4>> entries;
   for (; lm != 0; prev_lm = lm, lm = next_lm)
     {
-      so_list_up newobj (XCNEW (struct so_list));
+      std::unique_ptr<lm_info_svr4> li;
 
-      lm_info_svr4 *li = lm_info_read (lm).release ();
-      newobj->lm_info = li;
+      auto it = prefetched.find (lm);
+      if (it != prefetched.end () && it->second != NULL)
+	li = std::move (it->second);
+      else
+	li = lm_info_read (lm);
       if (li == NULL)
-	return 0;
+	{
+	  result = 0;
+	  break;
+	}
 
       next_lm = li->l_next;
 
@@ -1309,15 +1603,50 @@ svr4_read_so_list (svr4_info *info, CORE_ADDR lm, CORE_ADDR prev_lm,
 	  warning (_("Corrupted shared library list: %s != %s"),
 		   paddress (target_gdbarch (), prev_lm),
 		   paddress (target_gdbarch (), li->l_prev));
-	  return 0;
+	  result = 0;
+	  break;
 	}
 
-      /* For SVR4 versions, the first entry in the link map is for the
-         inferior executable, so we must ignore it.  For some versions of
-         SVR4, it has no name.  For others (Solaris 2.3 for example), it
-         does have a name, so we can no longer use a missing name to
-         decide when to ignore it.  */
-      if (ignore_first && li->l_prev == 0)
+      entries.push_back (std::move (li));
+    }
+
+  /* For SVR4 versions, the first entry in the link map is for the
+     inferior executable, so we must ignore it.  For some versions of
+     SVR4, it has no name.  For others (Solaris 2.3 for example), it
+     does have a name, so we can no longer use a missing name to
+     decide when to ignore it.  */
+  auto is_first = [ignore_first] (const lm_info_svr4 *li)
+    {
+      return ignore_first && li->l_prev == 0;
+    };
+
+  /* Then read the names that are not known yet.  */
+  std::vector<CORE_ADDR> name_addrs;
+  for (const auto &li : entries)
+    if (!is_first (li.get ())
+	&& names_unchanged.find (li->lm_addr) == names_unchanged.end ())
+      name_addrs.push_back (li->l_name);
+  std::vector<gdb::unique_xmalloc_ptr<char>> names
+    = svr4_read_so_names (name_addrs);
+
+  svr4_lm_cache new_cache;
+  auto next_name = names.begin ();
+  for (auto &entry : entries)
+    {
+      lm_info_svr4 *li = entry.get ();
+      so_list_up newobj (XCNEW (struct so_list));
+
+      newobj->lm_info = entry.release ();
+
+      svr4_cached_lm *cached = NULL;
+      if (cache != NULL)
+	{
+	  cached = &new_cache[li->lm_addr];
+	  cached->l_name = li->l_name;
+	  cached->name_p = false;
+	}
+
+      if (is_first (li))
 	{
 	  first_l_name = li->l_name;
 	  info->main_lm_addr = li->lm_addr;
@@ -1325,8 +1654,14 @@ svr4_read_so_list (svr4_info *info, CORE_ADDR lm, CORE_ADDR prev_lm,
 	}
 
       /* Extract this shared object's name.  */
-      gdb::unique_xmalloc_ptr<char> buffer
-	= target_read_string (li->l_name, SO_NAME_MAX_PATH_SIZE - 1);
+      gdb::unique_xmalloc_ptr<char> buffer;
+      if (names_unchanged.find (li->lm_addr) != names_unchanged.end ())
+	{
+	  svr4_solib_statistics.names_reused++;
+	  buffer = make_unique_xstrdup (cache->at (li->lm_addr).name.c_str ());
+	}
+      else
+	buffer = std::move (*next_name++);
       if (buffer == nullptr)
 	{
 	  /* If this entry's l_name address matches that of the
@@ -1338,6 +1673,12 @@ svr4_read_so_list (svr4_info *info, CORE_ADDR lm, CORE_ADDR prev_lm,
 	  continue;
 	}
 
+      if (cached != NULL)
+	{
+	  cached->name_p = true;
+	  cached->name = buffer.get ();
+	}
+
       strncpy (newobj->so_name, buffer.get (), SO_NAME_MAX_PATH_SIZE - 1);
       newobj->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
       strcpy (newobj->so_original_name, newobj->so_name);
@@ -1353,7 +1694,10 @@ svr4_read_so_list (svr4_info *info, CORE_ADDR lm, CORE_ADDR prev_lm,
       *link_ptr_ptr = &(**link_ptr_ptr)->next;
     }
 
-  return 1;
+  if (cache != NULL)
+    *cache = std::move (new_cache);
+
+  return result;
 }
 
 /* Read the full list of currently loaded shared objects directly
@@ -1413,7 +1757,8 @@ svr4_current_sos_direct (struct svr4_info *info)
      `struct so_list' nodes.  */
   lm = solib_svr4_r_map (info);
   if (lm)
-    svr4_read_so_list (info, lm, 0, &link_ptr, ignore_first);
+    svr4_read_so_list (info, lm, 0, &link_ptr, ignore_first,
+		       &info->lm_cache);
 
   /* On Solaris, the dynamic linker is not in the normal list of
      shared objects, so make sure we pick it up too.  Having
@@ -1744,13 +2089,15 @@ solib_event_probe_action (struct probe_and_action *pa)
   if (action == DO_NOTHING || action == PROBES_INTERFACE_FAILED)
     return action;
 
-  gdb_assert (action == FULL_RELOAD || action == UPDATE_OR_RELOAD);
+  gdb_assert (action == FULL_RELOAD || action == UPDATE_OR_RELOAD
+	      || action == REMOVE_OR_RELOAD);
 
   /* Check that an appropriate number of arguments has been supplied.
      We expect:
        arg0: Lmid_t lmid (mandatory)
        arg1: struct r_debug *debug_base (mandatory)
-       arg2: struct link_map *new (optional, for incremental updates)  */
+       arg2: struct link_map *new (optional, for incremental updates
+	     of UPDATE_OR_RELOAD)  */
   try
     {
       probe_argc = pa->prob->get_argument_count (get_frame_arch (frame));
@@ -1767,7 +2114,7 @@ solib_event_probe_action (struct probe_and_action *pa)
      Both cases happen because of different things, but they are
      treated equally here: action will be set to
      PROBES_INTERFACE_FAILED.  */
-  if (probe_argc == 2)
+  if (probe_argc == 2 && action == UPDATE_OR_RELOAD)
     action = FULL_RELOAD;
   else if (probe_argc < 2)
     action = PROBES_INTERFACE_FAILED;
@@ -1784,6 +2131,8 @@ solist_update_full (struct svr4_info *info)
 {
   free_solib_list (info);
   info->solib_list = svr4_current_sos_direct (info);
+  info->solib_list_generation++;
+  svr4_solib_statistics.full_reloads++;
 
   return 1;
 }
@@ -1844,6 +2193,118 @@ solist_update_incremental (struct svr4_info *info, CORE_ADDR lm)
 	return 0;
     }
 
+  info->solib_list_generation++;
+  svr4_solib_statistics.incremental_additions++;
+  return 1;
+}
+
+/* Remove the objects the linker has unloaded from the shared object
+   list.  Rather than reading the whole list again, read the link map
+   entries of the objects in the list all at once, and walk the chain
+   through them.  Keep the objects whose entry is still on the chain,
+   without reading their names again.  Returns nonzero if the list was
+   successfully updated, or zero to indicate failure.  */
+
+static int
+solist_update_removed (struct svr4_info *info)
+{
+  /* As in solist_update_incremental, defer to solist_update_full for
+     the special cases relating to the first elements of the list.
+     Remote targets reporting the list with qXfer:libraries-svr4:read
+     always send it whole anyway.  */
+  if (info->solib_list == NULL || info->using_xfer)
+    return 0;
+
+  /* svr4_current_sos_direct also reads this second chain; don't try to
+     keep track of it.  */
+  if (solib_svr4_r_ldsomap (info) != 0)
+    return 0;
+
+  std::unordered_map<CORE_ADDR, struct so_list *> known;
+  std::vector<CORE_ADDR> addrs;
+  for (struct so_list *so = info->solib_list; so != NULL; so = so->next)
+    {
+      CORE_ADDR lm_addr = ((lm_info_svr4 *) so->lm_info)->lm_addr;
+
+      known[lm_addr] = so;
+      addrs.push_back (lm_addr);
+    }
+  /* Also read the entries of the main program and of the objects
+     without a name, such as the vDSO, which are not in the list.  The
+     last full read of the list left them in the link map cache.  */
+  for (const auto &entry : info->lm_cache)
+    if (known.find (entry.first) == known.end ())
+      addrs.push_back (entry.first);
+  if (info->main_lm_addr != 0
+      && info->lm_cache.find (info->main_lm_addr) == info->lm_cache.end ())
+    addrs.push_back (info->main_lm_addr);
+
+  std::unordered_map<CORE_ADDR, std::unique_ptr<lm_info_svr4>> entries
+    = lm_info_read_multiple (addrs);
+
+  std::vector<struct so_list *> kept;
+  CORE_ADDR prev_lm = 0, next_lm;
+  for (CORE_ADDR lm = solib_svr4_r_map (info); lm != 0;
+       prev_lm = lm, lm = next_lm)
+    {
+      /* Only the entries of new objects, or of objects without a
+	 name loaded since the last full read, are read on their own.  */
+      std::unique_ptr<lm_info_svr4> li;
+      auto entry = entries.find (lm);
+      if (entry != entries.end () && entry->second != NULL)
+	li = std::move (entry->second);
+      else
+	li = lm_info_read (lm);
+      if (li == NULL || li->l_prev != prev_lm)
+	return 0;
+      next_lm = li->l_next;
+
+      auto it = known.find (lm);
+      if (it != known.end ())
+	{
+	  /* If the entry now describes another object, its memory was
+	     reused.  Read the list again to be safe.  */
+	  lm_info_svr4 *old_li = (lm_info_svr4 *) it->second->lm_info;
+	  if (old_li->l_name != li->l_name
+	      || old_li->l_addr_inferior != li->l_addr_inferior
+	      || old_li->l_ld != li->l_ld)
+	    return 0;
+
+	  kept.push_back (it->second);
+	  known.erase (it);
+	  continue;
+	}
+
+      /* An entry svr4_read_so_list skipped: the main program, or an
+	 entry without a name.  Anything else is a new object, which
+	 should not happen after objects were unloaded.  */
+      if (lm == info->main_lm_addr)
+	continue;
+      gdb::unique_xmalloc_ptr<char> name = svr4_read_so_name (li->l_name);
+      if (name == nullptr || name.get ()[0] == '\0'
+	  || match_main (name.get ()))
+	continue;
+      return 0;
+    }
+
+  if (known.empty ())
+    return 1;
+
+  /* Relink the objects still loaded, in the link map order, and free
+     the others.  */
+  struct so_list *head = NULL, **link = &head;
+  for (struct so_list *so : kept)
+    {
+      *link = so;
+      link = &so->next;
+    }
+  *link = NULL;
+  for (const auto &entry : known)
+    free_so (entry.second);
+  info->solib_list = head;
+
+  info->solib_list_generation++;
+  svr4_solib_statistics.incremental_removals++;
   return 1;
 }
 
@@ -1992,6 +2453,11 @@ svr4_handle_solib_event (void)
       if (!solist_update_incremental (info, lm))
 	action = FULL_RELOAD;
     }
+  else if (action == REMOVE_OR_RELOAD)
+    {
+      if (!solist_update_removed (info))
+	action = FULL_RELOAD;
+    }
 
   if (action == FULL_RELOAD)
     {
@@ -2143,6 +2609,11 @@ svr4_find_and_create_probe_breakpoints (svr4_info *info,
   return true;
 }
 
+/* Whether to use the probes-based interface to the dynamic linker when
+   it is available.  See "maint set svr4-solib-probes".  */
+
+static bool svr4_use_probes = true;
+
 /* Both the SunOS and the SVR4 dynamic linkers call a marker function
    before and after mapping and unmapping shared libraries.  The sole
    purpose of this method is to allow debuggers to set a breakpoint so
@@ -2162,6 +2633,7 @@ svr4_create_solib_event_breakpoints (svr4_info *info, struct gdbarch *gdbarch,
   struct obj_section *os = find_pc_section (address);
 
   if (os == nullptr
+      || !svr4_use_probes
       || (!svr4_find_and_create_probe_breakpoints (info, gdbarch, os, false)
 	  && !svr4_find_and_create_probe_breakpoints (info, gdbarch, os, true)))
     create_solib_event_breakpoint (gdbarch, address);
@@ -3035,6 +3507,7 @@ svr4_clear_solib (void)
   info->debug_loader_offset = 0;
   xfree (info->debug_loader_name);
   info->debug_loader_name = NULL;
+  info->lm_cache.clear ();
 }
 
 /* Clear any bits of ADDR that wouldn't fit in a target-format
@@ -3250,6 +3723,29 @@ svr4_iterate_over_objfiles_in_search_order
     }
 }
 
+/* The "maint print svr4-solib-statistics" command.  */
+
+static void
+maintenance_print_svr4_solib_statistics (const char *args, int from_tty)
+{
+  const struct svr4_solib_stats &stats = svr4_solib_statistics;
+  struct svr4_info *info = get_svr4_info (current_program_space);
+
+  printf_filtered (_("Incremental additions: %lu\n"),
+		   stats.incremental_additions);
+  printf_filtered (_("Incremental removals: %lu\n"),
+		   stats.incremental_removals);
+  printf_filtered (_("Full reloads: %lu\n"), stats.full_reloads);
+  printf_filtered (_("Shared library list generation: %u\n"),
+		   info->solib_list_generation);
+  printf_filtered (_("Link map entries read: %lu\n"),
+		   stats.lm_entries_read);
+  printf_filtered (_("Link map entries read in bulk: %lu\n"),
+		   stats.lm_entries_read_in_bulk);
+  printf_filtered (_("Library names read: %lu\n"), stats.names_read);
+  printf_filtered (_("Library names reused: %lu\n"), stats.names_reused);
+}
+
 void _initialize_svr4_solib ();
 void
 _initialize_svr4_solib ()
@@ -3271,4 +3767,24 @@ _initialize_svr4_solib ()
   svr4_so_ops.handle_event = svr4_handle_solib_event;
 
   gdb::observers::free_objfile.attach (svr4_free_objfile_observer);
+
+  add_cmd ("svr4-solib-statistics", class_maintenance,
+	   maintenance_print_svr4_solib_statistics, _("\
+Print statistics about how the shared library list was kept up to date.\n\
+This shows how often the probes-based interface to the dynamic linker\n\
+could add or remove libraries without reading the whole list again, and\n\
+how many link map entries and library names were read from the inferior."),
+	   &maintenanceprintlist);
+
+  add_setshow_boolean_cmd ("svr4-solib-probes", class_maintenance,
+			   &svr4_use_probes, _("\
+Set whether to use the probes-based interface to the dynamic linker."), _("\
+Show whether to use the probes-based interface to the dynamic linker."), _("\
+When on, GDB stops at the probes of the dynamic linker, when it has them,\n\
+to update its list of shared libraries incrementally.  When off, GDB stops\n\
+at the dynamic linker's debugger interface function and reads the whole\n\
+list each time.  This takes effect the next time the program is started."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
 }
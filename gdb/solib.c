@@ -963,6 +963,8 @@ solib_add (const char *pattern, int from_tty, int readsyms)
   {
     bool any_matches = false;
     bool loaded_any_symbols = false;
+    bool failed_any_symbols = false;
+    std::vector<struct objfile *> new_objfiles;
     symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
 
     if (from_tty)
@@ -991,12 +993,26 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 				       gdb->so_name);
 		}
 	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+		{
+		  loaded_any_symbols = true;
+
+		  /* Only the breakpoints these objfiles may affect
+		     need to be re-set.  If reading the symbols failed,
+		     re-set all the breakpoints.  */
+		  if (gdb->objfile == NULL)
+		    failed_any_symbols = true;
+		  else
+		    for (objfile *objfile
+			   : gdb->objfile->separate_debug_objfiles ())
+		      new_objfiles.push_back (objfile);
+		}
 	    }
 	}
 
-    if (loaded_any_symbols)
+    if (failed_any_symbols)
       breakpoint_re_set ();
+    else if (loaded_any_symbols)
+      breakpoint_re_set_objfiles (new_objfiles);
 
     if (from_tty && pattern && ! any_matches)
       printf_unfiltered
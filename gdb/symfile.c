@@ -1015,7 +1015,13 @@ finish_new_objfile (struct objfile *objfile, symfile_add_flags add_flags)
     }
   else if ((add_flags & SYMFILE_DEFER_BP_RESET) == 0)
     {
-      breakpoint_re_set ();
+      /* OBJFILE's separate debug objfiles were read along with it,
+	 and hold the symbols the breakpoints may now match.  */
+      std::vector<struct objfile *> new_objfiles;
+      for (struct objfile *iter : objfile->separate_debug_objfiles ())
+	new_objfiles.push_back (iter);
+
+      breakpoint_re_set_objfiles (new_objfiles);
     }
 
   /* We're done reading the symbol file; finish off complaints.  */
@@ -67,8 +67,8 @@ print_symbol_bcache_statistics (void)
 	QUIT;
 	printf_filtered (_("Byte cache statistics for '%s':\n"),
 			 objfile_name (objfile));
-	objfile->partial_symtabs->psymbol_cache.print_statistics
-	  ("partial symbol cache");
+	objfile->partial_symtabs->psymbols.print_statistics
+	  ("partial symbol pool");
 	objfile->per_bfd->string_cache.print_statistics ("string cache");
       }
 }
@@ -128,10 +128,14 @@ print_objfile_statistics (void)
 			 pulongest (obstack_memory_used (&objfile->per_bfd
 							 ->storage_obstack)));
 	printf_filtered
-	  (_("  Total memory used for psymbol cache: %d\n"),
-	   objfile->partial_symtabs->psymbol_cache.memory_used ());
+	  (_("  Total memory used for psymbol pool: %s\n"),
+	   pulongest (objfile->partial_symtabs->psymbols.memory_used ()));
 	printf_filtered (_("  Total memory used for string cache: %d\n"),
 			 objfile->per_bfd->string_cache.memory_used ());
+	if (msymbol_trigram_index_memory_used (objfile) > 0)
+	  printf_filtered
+	    (_("  Total memory used for minimal symbol trigram index: %s\n"),
+	     pulongest (msymbol_trigram_index_memory_used (objfile)));
       }
 }
 
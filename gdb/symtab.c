@@ -66,12 +66,17 @@
 #include "progspace-and-thread.h"
 #include "gdbsupport/gdb_optional.h"
 #include "filename-seen-cache.h"
+#include "trigram-index.h"
 #include "arch-utils.h"
 #include <algorithm>
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
 
+#if GDB_SELF_TEST
+#include "gdbsupport/selftest.h"
+#endif
+
 /* Forward declarations for local functions.  */
 
 static void rbreak_command (const char *, int);
@@ -134,6 +139,12 @@ static const program_space_key<main_info> main_progspace_key;
    there's no point in allowing a user typo to make gdb consume all memory.  */
 #define MAX_SYMBOL_CACHE_SIZE (1024*1024)
 
+/* The number of slots the symbol cache of a program space grows by for
+   each of its objfiles, on top of the size set with "maint set
+   symbol-cache-size".  The number of objfiles is rounded up to a power
+   of two first, see symbol_cache_size_for_objfiles.  */
+#define SYMBOL_CACHE_SLOTS_PER_OBJFILE 64
+
 /* symbol_cache_lookup returns this if a previous lookup failed to find the
    symbol in any objfile.  */
 #define SYMBOL_LOOKUP_FAILED \
@@ -193,36 +204,34 @@ symbol_cache_clear_slot (struct symbol_cache_slot *slot)
   slot->state = SYMBOL_SLOT_UNUSED;
 }
 
-/* Symbols don't specify global vs static block.
-   So keep them in separate caches.  */
+/* The cache of the symbols of the global or static blocks.  Symbols
+   don't specify global vs static block, so they are kept in separate
+   caches.  */
 
 struct block_symbol_cache
 {
-  unsigned int hits;
-  unsigned int misses;
-  unsigned int collisions;
+  explicit block_symbol_cache (unsigned int size)
+    : symbols (size)
+  {
+  }
 
-  /* SYMBOLS is a variable length array of this size.
-     One can imagine that in general one cache (global/static) should be a
-     fraction of the size of the other, but there's no data at the moment
-     on which to decide.  */
-  unsigned int size;
+  ~block_symbol_cache ()
+  {
+    for (struct symbol_cache_slot &slot : symbols)
+      symbol_cache_clear_slot (&slot);
+  }
 
-  struct symbol_cache_slot symbols[1];
-};
+  DISABLE_COPY_AND_ASSIGN (block_symbol_cache);
 
-/* Clear all slots of BSC and free BSC.  */
+  unsigned int hits = 0;
+  unsigned int misses = 0;
+  unsigned int collisions = 0;
 
-static void
-destroy_block_symbol_cache (struct block_symbol_cache *bsc)
-{
-  if (bsc != nullptr)
-    {
-      for (unsigned int i = 0; i < bsc->size; i++)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
-      xfree (bsc);
-    }
-}
+  /* One can imagine that in general one cache (global/static) should be a
+     fraction of the size of the other, but there's no data at the moment
+     on which to decide.  */
+  std::vector<struct symbol_cache_slot> symbols;
+};
 
 /* The symbol cache.
 
@@ -232,20 +241,21 @@ destroy_block_symbol_cache (struct block_symbol_cache *bsc)
    overall gdb performance.
 
    Symbols are hashed on the name, its domain, and block.
-   They are also hashed on their objfile for objfile-specific lookups.  */
+   They are also hashed on their objfile for objfile-specific lookups.
+
+   Symbols are only looked up from the main thread, so the cache is not
+   locked.  */
 
 struct symbol_cache
 {
-  symbol_cache () = default;
+  /* The number of slots of each of the global and static caches, or
+     zero if the cache is disabled.  */
+  unsigned int size = 0;
 
-  ~symbol_cache ()
-  {
-    destroy_block_symbol_cache (global_symbols);
-    destroy_block_symbol_cache (static_symbols);
-  }
-
-  struct block_symbol_cache *global_symbols = nullptr;
-  struct block_symbol_cache *static_symbols = nullptr;
+  /* The global and static caches.  Both are NULL if the cache is
+     disabled.  */
+  std::unique_ptr<block_symbol_cache> global_symbols;
+  std::unique_ptr<block_symbol_cache> static_symbols;
 };
 
 /* Program space key for finding its symbol cache.  */
@@ -261,7 +271,8 @@ unsigned int symbol_lookup_debug = 0;
 /* The size of the cache is staged here.  */
 static unsigned int new_symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
 
-/* The current value of the symbol cache size.
+/* The current value of the symbol cache size.  The caches grow from
+   this size as objfiles are added, see symbol_cache_wanted_size.
    This is saved so that if the user enters a value too big we can restore
    the original value from here.  */
 static unsigned int symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
@@ -563,6 +574,31 @@ iterate_over_symtabs (const char *name,
     }
 }
 
+/* See symtab.h.  */
+
+void
+iterate_over_objfile_symtabs (struct objfile *objfile, const char *name,
+			      gdb::function_view<bool (symtab *)> callback)
+{
+  gdb::unique_xmalloc_ptr<char> real_path;
+
+  if (IS_ABSOLUTE_PATH (name))
+    {
+      real_path = gdb_realpath (name);
+      gdb_assert (IS_ABSOLUTE_PATH (real_path.get ()));
+    }
+
+  if (iterate_over_some_symtabs (name, real_path.get (),
+				 objfile->compunit_symtabs, NULL,
+				 callback))
+    return;
+
+  if (objfile->sf)
+    objfile->sf->qf->map_symtabs_matching_filename (objfile, name,
+						    real_path.get (),
+						    callback);
+}
+
 /* A wrapper for iterate_over_symtabs that returns the first matching
    symtab, or NULL.  */
 
@@ -1209,48 +1245,58 @@ eq_symbol_entry (const struct symbol_cache_slot *slot,
   return 1;
 }
 
-/* Given a cache of size SIZE, return the size of the struct (with variable
-   length array) in bytes.  */
+/* Return the number of slots the global and static symbol caches of a
+   program space with N_OBJFILES objfiles should have.
 
-static size_t
-symbol_cache_byte_size (unsigned int size)
+   Resizing the cache empties it, and the cache is flushed each time an
+   objfile is added.  So that loading many objfiles doesn't reallocate
+   the cache each time, N_OBJFILES is rounded up to a power of two: the
+   size only changes when the number of objfiles crosses one.  */
+
+static unsigned int
+symbol_cache_size_for_objfiles (size_t n_objfiles)
+{
+  if (symbol_cache_size == 0)
+    return 0;
+
+  size_t rounded = 1;
+  while (rounded < n_objfiles)
+    rounded *= 2;
+
+  return std::min<size_t> (symbol_cache_size
+			   + rounded * SYMBOL_CACHE_SLOTS_PER_OBJFILE,
+			   MAX_SYMBOL_CACHE_SIZE);
+}
+
+/* Return the number of slots the global and static symbol caches of
+   PSPACE should have, given its number of objfiles.  */
+
+static unsigned int
+symbol_cache_wanted_size (struct program_space *pspace)
 {
-  return (sizeof (struct block_symbol_cache)
-	  + ((size - 1) * sizeof (struct symbol_cache_slot)));
+  return symbol_cache_size_for_objfiles (pspace->objfiles_list.size ());
 }
 
-/* Resize CACHE.  */
+/* Resize CACHE to NEW_SIZE slots, as returned by
+   symbol_cache_size_for_objfiles.  This discards its contents.  */
 
 static void
 resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 {
-  /* If there's no change in size, don't do anything.
-     All caches have the same size, so we can just compare with the size
-     of the global symbols cache.  */
-  if ((cache->global_symbols != NULL
-       && cache->global_symbols->size == new_size)
-      || (cache->global_symbols == NULL
-	  && new_size == 0))
+  /* If there's no change in size, don't do anything.  */
+  if (cache->size == new_size)
     return;
 
-  destroy_block_symbol_cache (cache->global_symbols);
-  destroy_block_symbol_cache (cache->static_symbols);
-
+  cache->size = new_size;
   if (new_size == 0)
     {
-      cache->global_symbols = NULL;
-      cache->static_symbols = NULL;
+      cache->global_symbols.reset ();
+      cache->static_symbols.reset ();
     }
   else
     {
-      size_t total_size = symbol_cache_byte_size (new_size);
-
-      cache->global_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->static_symbols
-	= (struct block_symbol_cache *) xcalloc (1, total_size);
-      cache->global_symbols->size = new_size;
-      cache->static_symbols->size = new_size;
+      cache->global_symbols.reset (new block_symbol_cache (new_size));
+      cache->static_symbols.reset (new block_symbol_cache (new_size));
     }
 }
 
@@ -1265,16 +1311,17 @@ get_symbol_cache (struct program_space *pspace)
   if (cache == NULL)
     {
       cache = symbol_cache_key.emplace (pspace);
-      resize_symbol_cache (cache, symbol_cache_size);
+      resize_symbol_cache (cache, symbol_cache_wanted_size (pspace));
     }
 
   return cache;
 }
 
-/* Set the size of the symbol cache in all program spaces.  */
+/* Resize the symbol cache of all program spaces after the symbol cache
+   size was changed.  */
 
 static void
-set_symbol_cache_size (unsigned int new_size)
+set_symbol_cache_size ()
 {
   for (struct program_space *pspace : program_spaces)
     {
@@ -1282,7 +1329,7 @@ set_symbol_cache_size (unsigned int new_size)
 
       /* The pspace could have been created but not have a cache yet.  */
       if (cache != NULL)
-	resize_symbol_cache (cache, new_size);
+	resize_symbol_cache (cache, symbol_cache_wanted_size (pspace));
     }
 }
 
@@ -1303,10 +1350,10 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
     }
   symbol_cache_size = new_symbol_cache_size;
 
-  set_symbol_cache_size (symbol_cache_size);
+  set_symbol_cache_size ();
 }
 
-/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache of PSPACE.
+/* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache CACHE.
    OBJFILE_CONTEXT is the current objfile, which may be NULL.
    The result is the symbol if found, SYMBOL_LOOKUP_FAILED if a previous lookup
    failed (and thus this one will too), or NULL if the symbol is not present
@@ -1321,14 +1368,11 @@ symbol_cache_lookup (struct symbol_cache *cache,
 		     struct block_symbol_cache **bsc_ptr,
 		     struct symbol_cache_slot **slot_ptr)
 {
-  struct block_symbol_cache *bsc;
-  unsigned int hash;
-  struct symbol_cache_slot *slot;
+  struct block_symbol_cache *bsc
+    = (block == GLOBAL_BLOCK
+       ? cache->global_symbols.get ()
+       : cache->static_symbols.get ());
 
-  if (block == GLOBAL_BLOCK)
-    bsc = cache->global_symbols;
-  else
-    bsc = cache->static_symbols;
   if (bsc == NULL)
     {
       *bsc_ptr = NULL;
@@ -1336,8 +1380,8 @@ symbol_cache_lookup (struct symbol_cache *cache,
       return {};
     }
 
-  hash = hash_symbol_entry (objfile_context, name, domain);
-  slot = bsc->symbols + hash % bsc->size;
+  unsigned int hash = hash_symbol_entry (objfile_context, name, domain);
+  struct symbol_cache_slot *slot = &bsc->symbols[hash % bsc->symbols.size ()];
 
   *bsc_ptr = bsc;
   *slot_ptr = slot;
@@ -1370,7 +1414,7 @@ symbol_cache_lookup (struct symbol_cache *cache,
   return {};
 }
 
-/* Mark SYMBOL as found in SLOT.
+/* Mark SYMBOL as found in SLOT of BSC, as set by symbol_cache_lookup.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  It is *not*
    necessarily the objfile the symbol was found in.  */
@@ -1395,7 +1439,8 @@ symbol_cache_mark_found (struct block_symbol_cache *bsc,
   slot->value.found.block = block;
 }
 
-/* Mark symbol NAME, DOMAIN as not found in SLOT.
+/* Mark symbol NAME, DOMAIN as not found in SLOT of BSC, as set by
+   symbol_cache_lookup.
    OBJFILE_CONTEXT is the current objfile when the lookup was done, or NULL
    if it's not needed to distinguish lookups (STATIC_BLOCK).  */
 
@@ -1418,49 +1463,47 @@ symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
   slot->value.not_found.domain = domain;
 }
 
-/* Flush the symbol cache of PSPACE.  */
+/* Flush the symbol cache of PSPACE, and resize it if PSPACE gained or
+   lost objfiles.  */
 
 static void
 symbol_cache_flush (struct program_space *pspace)
 {
   struct symbol_cache *cache = symbol_cache_key.get (pspace);
-  int pass;
 
   if (cache == NULL)
     return;
-  if (cache->global_symbols == NULL)
+
+  /* Resizing the cache empties it.  */
+  unsigned int wanted_size = symbol_cache_wanted_size (pspace);
+  if (cache->size != wanted_size)
     {
-      gdb_assert (symbol_cache_size == 0);
-      gdb_assert (cache->static_symbols == NULL);
+      resize_symbol_cache (cache, wanted_size);
       return;
     }
 
   /* If the cache is untouched since the last flush, early exit.
      This is important for performance during the startup of a program linked
      with 100s (or 1000s) of shared libraries.  */
-  if (cache->global_symbols->misses == 0
-      && cache->static_symbols->misses == 0)
+  if (cache->global_symbols == NULL
+      || (cache->global_symbols->misses == 0
+	  && cache->static_symbols->misses == 0))
     return;
 
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
-
-  for (pass = 0; pass < 2; ++pass)
+  for (int pass = 0; pass < 2; ++pass)
     {
       struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
-      unsigned int i;
+	= (pass == 0
+	   ? cache->global_symbols.get ()
+	   : cache->static_symbols.get ());
 
-      for (i = 0; i < bsc->size; ++i)
-	symbol_cache_clear_slot (&bsc->symbols[i]);
-    }
+      for (struct symbol_cache_slot &slot : bsc->symbols)
+	symbol_cache_clear_slot (&slot);
 
-  cache->global_symbols->hits = 0;
-  cache->global_symbols->misses = 0;
-  cache->global_symbols->collisions = 0;
-  cache->static_symbols->hits = 0;
-  cache->static_symbols->misses = 0;
-  cache->static_symbols->collisions = 0;
+      bsc->hits = 0;
+      bsc->misses = 0;
+      bsc->collisions = 0;
+    }
 }
 
 /* Dump CACHE.  */
@@ -1470,7 +1513,7 @@ symbol_cache_dump (const struct symbol_cache *cache)
 {
   int pass;
 
-  if (cache->global_symbols == NULL)
+  if (cache->size == 0)
     {
       printf_filtered ("  <disabled>\n");
       return;
@@ -1479,15 +1522,16 @@ symbol_cache_dump (const struct symbol_cache *cache)
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
-      unsigned int i;
+	= (pass == 0
+	   ? cache->global_symbols.get ()
+	   : cache->static_symbols.get ());
 
       if (pass == 0)
 	printf_filtered ("Global symbols:\n");
       else
 	printf_filtered ("Static symbols:\n");
 
-      for (i = 0; i < bsc->size; ++i)
+      for (unsigned int i = 0; i < bsc->symbols.size (); ++i)
 	{
 	  const struct symbol_cache_slot *slot = &bsc->symbols[i];
 
@@ -1561,7 +1605,7 @@ symbol_cache_stats (struct symbol_cache *cache)
 {
   int pass;
 
-  if (cache->global_symbols == NULL)
+  if (cache->size == 0)
     {
       printf_filtered ("  <disabled>\n");
       return;
@@ -1570,7 +1614,11 @@ symbol_cache_stats (struct symbol_cache *cache)
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
-	= pass == 0 ? cache->global_symbols : cache->static_symbols;
+	= (pass == 0
+	   ? cache->global_symbols.get ()
+	   : cache->static_symbols.get ());
+      unsigned int hits = bsc->hits;
+      unsigned int misses = bsc->misses;
 
       QUIT;
 
@@ -1579,10 +1627,13 @@ symbol_cache_stats (struct symbol_cache *cache)
       else
 	printf_filtered ("Static block cache stats:\n");
 
-      printf_filtered ("  size:       %u\n", bsc->size);
-      printf_filtered ("  hits:       %u\n", bsc->hits);
-      printf_filtered ("  misses:     %u\n", bsc->misses);
+      printf_filtered ("  size:       %u\n", cache->size);
+      printf_filtered ("  hits:       %u\n", hits);
+      printf_filtered ("  misses:     %u\n", misses);
       printf_filtered ("  collisions: %u\n", bsc->collisions);
+      if (hits + misses != 0)
+	printf_filtered ("  hit rate:   %.1f%%\n",
+			 100.0 * hits / (hits + misses));
     }
 }
 
@@ -2612,9 +2663,9 @@ lookup_global_or_static_symbol (const char *name,
 {
   struct symbol_cache *cache = get_symbol_cache (current_program_space);
   struct block_symbol result;
-  struct global_or_static_sym_lookup_data lookup_data;
   struct block_symbol_cache *bsc;
   struct symbol_cache_slot *slot;
+  struct global_or_static_sym_lookup_data lookup_data;
 
   gdb_assert (block_index == GLOBAL_BLOCK || block_index == STATIC_BLOCK);
   gdb_assert (objfile == nullptr || block_index == GLOBAL_BLOCK);
@@ -4481,6 +4532,107 @@ treg_matches_sym_type_name (const compiled_regex &treg,
   return treg.exec (printed_sym_type_name.c_str (), 0, NULL, 0) == 0;
 }
 
+/* Whether regular expression searches of symbols use trigram indexes of
+   the minimal symbol names.  */
+
+static bool symbol_search_trigram_index = false;
+
+/* A trigram index of the natural names of the minimal symbols of an
+   objfile, for "maint set symbol-search-trigram-index".  */
+
+struct msymbol_trigram_index
+{
+  /* The minimal symbols the index was built for.  If the minimal
+     symbols of the objfile were read again, the index is stale.  */
+  const minimal_symbol *msymbols = nullptr;
+  int count = 0;
+
+  /* The index, by position in the minimal symbol table.  */
+  trigram_index index;
+};
+
+/* Objfile key for the minimal symbol trigram indexes.  */
+
+static const struct objfile_key<msymbol_trigram_index>
+  msymbol_trigram_index_key;
+
+/* See symtab.h.  */
+
+size_t
+msymbol_trigram_index_memory_used (struct objfile *objfile)
+{
+  msymbol_trigram_index *mti = msymbol_trigram_index_key.get (objfile);
+
+  return mti != nullptr ? mti->index.memory_used () : 0;
+}
+
+/* Return true if NAME matches PREG, or if there is no PREG.  LITERAL is
+   a string all the names matching PREG contain, or the empty string;
+   looking for it first is much cheaper than running PREG.  */
+
+static bool
+symbol_name_matches_regexp (const char *name,
+			    const gdb::optional<compiled_regex> &preg,
+			    const std::string &literal)
+{
+  if (!preg.has_value ())
+    return true;
+
+  if (!literal.empty ()
+      && !name_contains_literal (name, literal,
+				 case_sensitivity == case_sensitive_off))
+    return false;
+
+  return preg->exec (name, 0, NULL, 0) == 0;
+}
+
+/* Call CALLBACK for the minimal symbols of OBJFILE whose natural name
+   may contain LITERAL, in order, until it returns false.  Return false
+   if CALLBACK did.  Without a trigram index, or if LITERAL is too short
+   for it, this is every minimal symbol.  */
+
+static bool
+iterate_over_msymbols_containing
+  (struct objfile *objfile, const std::string &literal,
+   gdb::function_view<bool (minimal_symbol *)> callback)
+{
+  if (!symbol_search_trigram_index || literal.size () < 3)
+    {
+      for (minimal_symbol *msymbol : objfile->msymbols ())
+	if (!callback (msymbol))
+	  return false;
+      return true;
+    }
+
+  minimal_symbol *msymbols = objfile->per_bfd->msymbols.get ();
+  int count = objfile->per_bfd->minimal_symbol_count;
+  msymbol_trigram_index *mti = msymbol_trigram_index_key.get (objfile);
+
+  if (mti != nullptr && (mti->msymbols != msymbols || mti->count != count))
+    {
+      msymbol_trigram_index_key.clear (objfile);
+      mti = nullptr;
+    }
+
+  if (mti == nullptr)
+    {
+      mti = msymbol_trigram_index_key.emplace (objfile);
+      mti->msymbols = msymbols;
+      mti->count = count;
+      for (int i = 0; i < count; ++i)
+	{
+	  QUIT;
+	  mti->index.add (i, msymbols[i].natural_name ());
+	}
+      mti->index.finish ();
+    }
+
+  for (unsigned int i : mti->index.candidates (literal))
+    if (!callback (&msymbols[i]))
+      return false;
+  return true;
+}
+
 /* See symtab.h.  */
 
 bool
@@ -4508,7 +4660,8 @@ global_symbol_searcher::is_suitable_msymbol
 
 bool
 global_symbol_searcher::expand_symtabs
-	(objfile *objfile, const gdb::optional<compiled_regex> &preg) const
+	(objfile *objfile, const gdb::optional<compiled_regex> &preg,
+	 const std::string &literal) const
 {
   enum search_domain kind = m_kind;
   bool found_msymbol = false;
@@ -4523,8 +4676,7 @@ global_symbol_searcher::expand_symtabs
        &lookup_name_info::match_any (),
        [&] (const char *symname)
        {
-	 return (!preg.has_value ()
-		 || preg->exec (symname, 0, NULL, 0) == 0);
+	 return symbol_name_matches_regexp (symname, preg, literal);
        },
        NULL,
        kind);
@@ -4546,36 +4698,37 @@ global_symbol_searcher::expand_symtabs
   if (filenames.empty ()
       && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
     {
-      for (minimal_symbol *msymbol : objfile->msymbols ())
-	{
-	  QUIT;
+      iterate_over_msymbols_containing
+	(objfile, literal, [&] (minimal_symbol *msymbol)
+	 {
+	   QUIT;
 
-	  if (msymbol->created_by_gdb)
-	    continue;
+	   if (msymbol->created_by_gdb)
+	     return true;
 
-	  if (is_suitable_msymbol (kind, msymbol))
-	    {
-	      if (!preg.has_value ()
-		  || preg->exec (msymbol->natural_name (), 0,
-				 NULL, 0) == 0)
-		{
-		  /* An important side-effect of these lookup functions is
-		     to expand the symbol table if msymbol is found, later
-		     in the process we will add matching symbols or
-		     msymbols to the results list, and that requires that
-		     the symbols tables are expanded.  */
-		  if (kind == FUNCTIONS_DOMAIN
-		      ? (find_pc_compunit_symtab
-			 (MSYMBOL_VALUE_ADDRESS (objfile, msymbol))
-			 == NULL)
-		      : (lookup_symbol_in_objfile_from_linkage_name
-			 (objfile, msymbol->linkage_name (),
-			  VAR_DOMAIN)
-			 .symbol == NULL))
-		    found_msymbol = true;
-		}
-	    }
-	}
+	   if (is_suitable_msymbol (kind, msymbol))
+	     {
+	       if (symbol_name_matches_regexp (msymbol->natural_name (),
+					       preg, literal))
+		 {
+		   /* An important side-effect of these lookup functions is
+		      to expand the symbol table if msymbol is found, later
+		      in the process we will add matching symbols or
+		      msymbols to the results list, and that requires that
+		      the symbols tables are expanded.  */
+		   if (kind == FUNCTIONS_DOMAIN
+		       ? (find_pc_compunit_symtab
+			  (MSYMBOL_VALUE_ADDRESS (objfile, msymbol))
+			  == NULL)
+		       : (lookup_symbol_in_objfile_from_linkage_name
+			  (objfile, msymbol->linkage_name (),
+			   VAR_DOMAIN)
+			  .symbol == NULL))
+		     found_msymbol = true;
+		 }
+	     }
+	   return true;
+	 });
     }
 
   return found_msymbol;
@@ -4587,6 +4740,7 @@ bool
 global_symbol_searcher::add_matching_symbols
 	(objfile *objfile,
 	 const gdb::optional<compiled_regex> &preg,
+	 const std::string &literal,
 	 const gdb::optional<compiled_regex> &treg,
 	 std::set<symbol_search> *result_set) const
 {
@@ -4618,9 +4772,8 @@ global_symbol_searcher::add_matching_symbols
 					 filenames, true))
 		       && file_matches (symtab_to_fullname (real_symtab),
 					filenames, false)))
-		  && ((!preg.has_value ()
-		       || preg->exec (sym->natural_name (), 0,
-				      NULL, 0) == 0)
+		  && (symbol_name_matches_regexp (sym->natural_name (),
+						  preg, literal)
 		      && ((kind == VARIABLES_DOMAIN
 			   && SYMBOL_CLASS (sym) != LOC_TYPEDEF
 			   && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
@@ -4668,46 +4821,47 @@ global_symbol_searcher::add_matching_symbols
 bool
 global_symbol_searcher::add_matching_msymbols
 	(objfile *objfile, const gdb::optional<compiled_regex> &preg,
+	 const std::string &literal,
 	 std::vector<symbol_search> *results) const
 {
   enum search_domain kind = m_kind;
 
-  for (minimal_symbol *msymbol : objfile->msymbols ())
-    {
-      QUIT;
+  return iterate_over_msymbols_containing
+    (objfile, literal, [&] (minimal_symbol *msymbol)
+     {
+       QUIT;
 
-      if (msymbol->created_by_gdb)
-	continue;
+       if (msymbol->created_by_gdb)
+	 return true;
 
-      if (is_suitable_msymbol (kind, msymbol))
-	{
-	  if (!preg.has_value ()
-	      || preg->exec (msymbol->natural_name (), 0,
-			     NULL, 0) == 0)
-	    {
-	      /* For functions we can do a quick check of whether the
-		 symbol might be found via find_pc_symtab.  */
-	      if (kind != FUNCTIONS_DOMAIN
-		  || (find_pc_compunit_symtab
-		      (MSYMBOL_VALUE_ADDRESS (objfile, msymbol))
-		      == NULL))
-		{
-		  if (lookup_symbol_in_objfile_from_linkage_name
-		      (objfile, msymbol->linkage_name (),
-		       VAR_DOMAIN).symbol == NULL)
-		    {
-		      /* Matching msymbol, add it to the results list.  */
-		      if (results->size () < m_max_search_results)
-			results->emplace_back (GLOBAL_BLOCK, msymbol, objfile);
-		      else
-			return false;
-		    }
-		}
-	    }
-	}
-    }
-
-  return true;
+       if (is_suitable_msymbol (kind, msymbol))
+	 {
+	   if (symbol_name_matches_regexp (msymbol->natural_name (),
+					   preg, literal))
+	     {
+	       /* For functions we can do a quick check of whether the
+		  symbol might be found via find_pc_symtab.  */
+	       if (kind != FUNCTIONS_DOMAIN
+		   || (find_pc_compunit_symtab
+		       (MSYMBOL_VALUE_ADDRESS (objfile, msymbol))
+		       == NULL))
+		 {
+		   if (lookup_symbol_in_objfile_from_linkage_name
+		       (objfile, msymbol->linkage_name (),
+			VAR_DOMAIN).symbol == NULL)
+		     {
+		       /* Matching msymbol, add it to the results list.  */
+		       if (results->size () < m_max_search_results)
+			 results->emplace_back (GLOBAL_BLOCK, msymbol,
+						objfile);
+		       else
+			 return false;
+		     }
+		 }
+	     }
+	 }
+       return true;
+     });
 }
 
 /* See symtab.h.  */
@@ -4717,6 +4871,7 @@ global_symbol_searcher::search () const
 {
   gdb::optional<compiled_regex> preg;
   gdb::optional<compiled_regex> treg;
+  std::string literal;
 
   gdb_assert (m_kind != ALL_DOMAIN);
 
@@ -4762,6 +4917,7 @@ global_symbol_searcher::search () const
 				? REG_ICASE : 0);
       preg.emplace (symbol_name_regexp, cflags,
 		    _("Invalid regexp"));
+      literal = regex_required_literal (symbol_name_regexp);
     }
 
   if (m_symbol_type_regexp != NULL)
@@ -4778,13 +4934,13 @@ global_symbol_searcher::search () const
     {
       /* Expand symtabs within objfile that possibly contain matching
 	 symbols.  */
-      found_msymbol |= expand_symtabs (objfile, preg);
+      found_msymbol |= expand_symtabs (objfile, preg, literal);
 
       /* Find matching symbols within OBJFILE and add them in to the
 	 RESULT_SET set.  Use a set here so that we can easily detect
 	 duplicates as we go, and can therefore track how many unique
 	 matches we have found so far.  */
-      if (!add_matching_symbols (objfile, preg, treg, &result_set))
+      if (!add_matching_symbols (objfile, preg, literal, treg, &result_set))
 	break;
     }
 
@@ -4802,7 +4958,7 @@ global_symbol_searcher::search () const
     {
       gdb_assert (m_kind == VARIABLES_DOMAIN || m_kind == FUNCTIONS_DOMAIN);
       for (objfile *objfile : current_program_space->objfiles ())
-	if (!add_matching_msymbols (objfile, preg, &result))
+	if (!add_matching_msymbols (objfile, preg, literal, &result))
 	  break;
     }
 
@@ -5217,6 +5373,7 @@ rbreak_command (const char *regexp, int from_tty)
   std::vector<symbol_search> symbols = spec.search ();
 
   scoped_rbreak_breakpoints finalize;
+  scoped_batch_location_list_update batch_update;
   for (const symbol_search &p : symbols)
     {
       if (p.msymbol.minsym == NULL)
@@ -6713,6 +6870,103 @@ info_module_var_func_command_completer (struct cmd_list_element *ignore,
 
 
 
+#if GDB_SELF_TEST
+
+namespace selftests {
+namespace symbol_cache_tests {
+
+static void
+run_test ()
+{
+  scoped_restore restore_size
+    = make_scoped_restore (&symbol_cache_size,
+			   (unsigned int) DEFAULT_SYMBOL_CACHE_SIZE);
+
+  /* The size only changes when the number of objfiles reaches a power
+     of two.  */
+  unsigned int n_sizes = 0, prev_size = 0;
+  for (size_t n_objfiles = 0; n_objfiles <= 4096; ++n_objfiles)
+    {
+      unsigned int size = symbol_cache_size_for_objfiles (n_objfiles);
+
+      SELF_CHECK (size >= prev_size);
+      if (size != prev_size)
+	++n_sizes;
+      prev_size = size;
+    }
+  SELF_CHECK (n_sizes == 13);
+  SELF_CHECK (symbol_cache_size_for_objfiles (1 << 20)
+	      == MAX_SYMBOL_CACHE_SIZE);
+
+  symbol_cache_size = 0;
+  SELF_CHECK (symbol_cache_size_for_objfiles (10) == 0);
+  symbol_cache_size = DEFAULT_SYMBOL_CACHE_SIZE;
+
+  struct symbol_cache cache;
+  resize_symbol_cache (&cache, symbol_cache_size_for_objfiles (3));
+  SELF_CHECK (cache.size == symbol_cache_size_for_objfiles (4));
+  SELF_CHECK (cache.global_symbols->symbols.size () == cache.size);
+  SELF_CHECK (cache.static_symbols->symbols.size () == cache.size);
+
+  /* A lookup misses until the result is recorded in the slot it
+     returned.  */
+  struct block_symbol_cache *bsc;
+  struct symbol_cache_slot *slot;
+  block_symbol bsym
+    = symbol_cache_lookup (&cache, NULL, GLOBAL_BLOCK, "foo", VAR_DOMAIN,
+			   &bsc, &slot);
+  SELF_CHECK (bsym.symbol == NULL);
+  SELF_CHECK (bsc == cache.global_symbols.get ());
+  symbol_cache_mark_not_found (bsc, slot, NULL, "foo", VAR_DOMAIN);
+  bsym = symbol_cache_lookup (&cache, NULL, GLOBAL_BLOCK, "foo", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (SYMBOL_LOOKUP_FAILED_P (bsym));
+
+  struct symbol sym;
+  sym.m_name = "bar";
+  sym.set_language (language_c, NULL);
+  sym.domain = VAR_DOMAIN;
+  bsym = symbol_cache_lookup (&cache, NULL, STATIC_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsc == cache.static_symbols.get ());
+  symbol_cache_mark_found (bsc, slot, NULL, &sym, NULL);
+  bsym = symbol_cache_lookup (&cache, NULL, STATIC_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsym.symbol == &sym);
+  bsym = symbol_cache_lookup (&cache, NULL, GLOBAL_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsym.symbol == NULL);
+
+  SELF_CHECK (cache.global_symbols->hits == 1);
+  SELF_CHECK (cache.global_symbols->misses == 2);
+  SELF_CHECK (cache.static_symbols->hits == 1);
+  SELF_CHECK (cache.static_symbols->misses == 1);
+
+  /* Resizing to the same size keeps the contents; any other size
+     discards them.  */
+  resize_symbol_cache (&cache, symbol_cache_size_for_objfiles (4));
+  bsym = symbol_cache_lookup (&cache, NULL, STATIC_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsym.symbol == &sym);
+  resize_symbol_cache (&cache, symbol_cache_size_for_objfiles (5));
+  SELF_CHECK (cache.static_symbols->symbols.size () == cache.size);
+  bsym = symbol_cache_lookup (&cache, NULL, STATIC_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsym.symbol == NULL);
+
+  /* A disabled cache has no slot to record a result in.  */
+  resize_symbol_cache (&cache, 0);
+  bsym = symbol_cache_lookup (&cache, NULL, STATIC_BLOCK, "bar", VAR_DOMAIN,
+			      &bsc, &slot);
+  SELF_CHECK (bsym.symbol == NULL && bsc == NULL && slot == NULL);
+  symbol_cache_mark_found (bsc, slot, NULL, &sym, NULL);
+}
+
+} /* namespace symbol_cache_tests */
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
 void _initialize_symtab ();
 void
 _initialize_symtab ()
@@ -6863,11 +7117,28 @@ When enabled (non-zero), symbol lookups are logged."),
 			     _("Set the size of the symbol cache."),
 			     _("Show the size of the symbol cache."), _("\
 The size of the symbol cache.\n\
+The cache of each program space grows from this size by 64 entries\n\
+for each of its object files, up to 1048576 entries.\n\
 If zero then the symbol cache is disabled."),
 			     set_symbol_cache_size_handler, NULL,
 			     &maintenance_set_cmdlist,
 			     &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("symbol-search-trigram-index", class_maintenance,
+			   &symbol_search_trigram_index, _("\
+Set whether symbol searches use trigram indexes of minimal symbol names."),
+			   _("\
+Show whether symbol searches use trigram indexes of minimal symbol names."),
+			   _("\
+When on, searching symbols with a regular expression, as done by\n\
+\"info functions\", \"info variables\" and \"rbreak\", only considers the\n\
+minimal symbols whose names contain a string every match must contain.\n\
+The index of each object file is built on the first such search, and\n\
+takes memory in proportion to the total length of the names."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_cmd ("symbol-cache", class_maintenance, maintenance_print_symbol_cache,
 	   _("Dump the symbol cache for each program space."),
 	   &maintenanceprintlist);
@@ -6885,4 +7156,9 @@ If zero then the symbol cache is disabled."),
   gdb::observers::executable_changed.attach (symtab_observer_executable_changed);
   gdb::observers::new_objfile.attach (symtab_new_objfile_observer);
   gdb::observers::free_objfile.attach (symtab_free_objfile_observer);
+
+#if GDB_SELF_TEST
+  selftests::register_test ("symbol_cache",
+			    selftests::symbol_cache_tests::run_test);
+#endif
 }
@@ -2149,18 +2149,22 @@ class global_symbol_searcher
 
   /* Expand symtabs in OBJFILE that match PREG, are of type M_KIND.  Return
      true if any msymbols were seen that we should later consider adding to
-     the results list.  */
+     the results list.  LITERAL is a string all the names matching PREG
+     contain, or the empty string.  */
   bool expand_symtabs (objfile *objfile,
-		       const gdb::optional<compiled_regex> &preg) const;
+		       const gdb::optional<compiled_regex> &preg,
+		       const std::string &literal) const;
 
   /* Add symbols from symtabs in OBJFILE that match PREG, and TREG, and are
      of type M_KIND, to the results set RESULTS_SET.  Return false if we
      stop adding results early due to having already found too many results
      (based on M_MAX_SEARCH_RESULTS limit), otherwise return true.
      Returning true does not indicate that any results were added, just
-     that we didn't _not_ add a result due to reaching MAX_SEARCH_RESULTS.  */
+     that we didn't _not_ add a result due to reaching MAX_SEARCH_RESULTS.
+     LITERAL is as for expand_symtabs.  */
   bool add_matching_symbols (objfile *objfile,
 			     const gdb::optional<compiled_regex> &preg,
+			     const std::string &literal,
 			     const gdb::optional<compiled_regex> &treg,
 			     std::set<symbol_search> *result_set) const;
 
@@ -2169,9 +2173,11 @@ class global_symbol_searcher
      having already found too many results (based on max search results
      limit M_MAX_SEARCH_RESULTS), otherwise return true.  Returning true
      does not indicate that any results were added, just that we didn't
-     _not_ add a result due to reaching MAX_SEARCH_RESULTS.  */
+     _not_ add a result due to reaching MAX_SEARCH_RESULTS.  LITERAL is as
+     for expand_symtabs.  */
   bool add_matching_msymbols (objfile *objfile,
 			      const gdb::optional<compiled_regex> &preg,
+			      const std::string &literal,
 			      std::vector<symbol_search> *results) const;
 
   /* Return true if MSYMBOL is of type KIND.  */
@@ -2179,6 +2185,11 @@ class global_symbol_searcher
 				   const minimal_symbol *msymbol);
 };
 
+/* Return the number of bytes used by the trigram index of the minimal
+   symbol names of OBJFILE, or zero if it has none.  */
+
+extern size_t msymbol_trigram_index_memory_used (struct objfile *objfile);
+
 /* When searching for Fortran symbols within modules (functions/variables)
    we return a vector of this type.  The first item in the pair is the
    module symbol, and the second item is the symbol for the function or
@@ -2250,6 +2261,13 @@ bool iterate_over_some_symtabs (const char *name,
 void iterate_over_symtabs (const char *name,
 			   gdb::function_view<bool (symtab *)> callback);
 
+/* Like iterate_over_symtabs, but only look at the symtabs of
+   OBJFILE.  */
+
+void iterate_over_objfile_symtabs
+  (struct objfile *objfile, const char *name,
+   gdb::function_view<bool (symtab *)> callback);
+
 
 std::vector<CORE_ADDR> find_pcs_for_symtab_line
     (struct symtab *symtab, int line, struct linetable_entry **best_entry);
@@ -1264,6 +1264,35 @@ target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* See target.h.  */
+
+void
+target_read_raw_memory_multiple (struct target_ops *ops,
+				 gdb::array_view<memory_read_request> requests)
+{
+  int unit_size = gdbarch_addressable_memory_unit_size (target_gdbarch ());
+
+  for (memory_read_request &req : requests)
+    req.xfered_len = 0;
+
+  if (!ops->read_memory_multiple (requests))
+    for (memory_read_request &req : requests)
+      req.xfered_len = 0;
+
+  /* Read what is left of each block on its own.  The target may not
+     have been able to read a block in full, or at all.  */
+  for (memory_read_request &req : requests)
+    if (req.xfered_len < req.len)
+      {
+	LONGEST res = target_read (ops, TARGET_OBJECT_RAW_MEMORY, NULL,
+				   req.buf + req.xfered_len * unit_size,
+				   req.addr + req.xfered_len,
+				   req.len - req.xfered_len);
+	if (res > 0)
+	  req.xfered_len += res;
+      }
+}
+
 /* Like target_read_memory, but specify explicitly that this is a read from
    the target's stack.  This may trigger different cache behavior.  */
 
@@ -1277,6 +1306,22 @@ target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* See target.h.  */
+
+void
+target_prefetch_stack (gdb::array_view<const mem_range> ranges)
+{
+  /* Only prefetch what memory_xfer_partial_1 would read through the
+     stack cache.  */
+  if (inferior_ptid == null_ptid
+      || get_traceframe_number () != -1
+      || !stack_cache_enabled_p ())
+    return;
+
+  dcache_prefetch (current_top_target (), target_dcache_get_or_init (),
+		   ranges);
+}
+
 /* Like target_read_memory, but specify explicitly that this is a read from
    the target's code.  This may trigger different cache behavior.  */
 
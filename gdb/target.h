@@ -296,6 +296,25 @@ struct memory_read_result
 extern std::vector<memory_read_result> read_memory_robust
     (struct target_ops *ops, const ULONGEST offset, const LONGEST len);
 
+/* A block of memory to read with target_read_raw_memory_multiple.  */
+
+struct memory_read_request
+{
+  memory_read_request (CORE_ADDR addr_, gdb_byte *buf_, ULONGEST len_)
+    : addr (addr_), buf (buf_), len (len_)
+  {
+  }
+
+  /* The address of the block.  */
+  CORE_ADDR addr;
+  /* Where to store its contents.  */
+  gdb_byte *buf;
+  /* The length of the block, in addressable units.  */
+  ULONGEST len;
+  /* The number of addressable units read from ADDR.  */
+  ULONGEST xfered_len = 0;
+};
+
 /* Request that OPS transfer up to LEN addressable units from BUF to the
    target's OBJECT.  When writing to a memory object, the addressable unit
    size is architecture dependent and can be found using
@@ -784,6 +803,17 @@ struct target_ops
     virtual ULONGEST get_memory_xfer_limit ()
       TARGET_DEFAULT_RETURN (ULONGEST_MAX);
 
+    /* Read the raw memory of each of REQUESTS, in as few exchanges
+       with the target as possible, setting the XFERED_LEN of each
+       request to the number of addressable units read from its start.
+       Return false if the target cannot read several blocks at once,
+       in which case the caller reads them one by one.  Only a prefix
+       of each block may be read; see target_read_raw_memory_multiple,
+       which also reads the rest when it can.  */
+
+    virtual bool read_memory_multiple (gdb::array_view<memory_read_request> requests)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
@@ -1536,8 +1566,24 @@ extern gdb::unique_xmalloc_ptr<char> target_read_string
 extern int target_read_raw_memory (CORE_ADDR memaddr, gdb_byte *myaddr,
 				   ssize_t len);
 
+/* Read the raw memory of each of REQUESTS from target OPS, several at
+   once if it can.  Set the XFERED_LEN of each request to the number of
+   addressable units read from its start; all of them were read if
+   that is its LEN.  */
+
+extern void target_read_raw_memory_multiple
+  (struct target_ops *ops, gdb::array_view<memory_read_request> requests);
+
 extern int target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
+/* Read the parts of RANGES that the stack cache does not hold yet into
+   it, reading them from the target at once if it can.  This is only a
+   hint: it does nothing if the stack cache is disabled, and memory
+   that can't be read is left out.  Unwinders use this to read what
+   they need from a frame in one go.  */
+
+extern void target_prefetch_stack (gdb::array_view<const mem_range> ranges);
+
 extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
 /* For target_write_memory see target/target.h.  */
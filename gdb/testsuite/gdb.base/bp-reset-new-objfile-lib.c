@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The functions below share their names with functions of the main
+   program, so that loading this library adds locations to breakpoints
+   already resolved in the main program.  */
+
+static inline __attribute__ ((always_inline)) int
+inl_func (int x)
+{
+  return x + 2;
+}
+
+static int
+helper (int x)
+{
+  return inl_func (x) - 1;
+}
+
+static int
+ifn_impl (int x)
+{
+  return x * 3;
+}
+
+static void *
+ifn_resolver (void)
+{
+  return (void *) ifn_impl;
+}
+
+int ifn (int) __attribute__ ((ifunc ("ifn_resolver")));
+
+int
+lib_entry (int x)
+{
+  return helper (x) + ifn (x);
+}
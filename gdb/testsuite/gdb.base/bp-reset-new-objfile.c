@@ -0,0 +1,51 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <stddef.h>
+
+static inline __attribute__ ((always_inline)) int
+inl_func (int x)
+{
+  return x + 1;
+}
+
+static int
+helper (int x)
+{
+  return inl_func (x) * 2;
+}
+
+static int
+ifn (int x)
+{
+  return x - 1;
+}
+
+int
+main (void)
+{
+  void *handle;
+  int (*entry) (int);
+
+  handle = dlopen (SHLIB_NAME, RTLD_LAZY);
+  if (handle == NULL)
+    return 1;
+
+  entry = (int (*) (int)) dlsym (handle, "lib_entry");
+  return helper (1) + ifn (2) + entry (3);	/* After dlopen.  */
+}
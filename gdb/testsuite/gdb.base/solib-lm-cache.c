@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+
+#include <dlfcn.h>
+#include <stdio.h>
+
+void *handles[NUM_LIBS];
+
+int
+main (void)
+{
+  char name[1024];
+  int i;
+
+  for (i = 0; i < NUM_LIBS; i++)
+    {
+      snprintf (name, sizeof (name), "%s%d.so", SHLIB_PREFIX, i);
+      handles[i] = dlopen (name, RTLD_NOW);
+      if (handles[i] == NULL)
+	return 1;
+    }
+
+  /* Unload every other library.  */
+  for (i = 0; i < NUM_LIBS; i += 2)	/* All loaded.  */
+    dlclose (handles[i]);
+
+  return 0;	/* Some unloaded.  */
+}
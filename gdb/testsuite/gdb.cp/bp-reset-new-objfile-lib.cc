@@ -0,0 +1,49 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+
+/* The overloads defined here complete those of the main program, so
+   that loading this library adds locations to breakpoints already
+   resolved in the main program.  */
+
+#include "bp-reset-new-objfile.h"
+
+int
+func (double x)
+{
+  return (int) x;
+}
+
+int
+A::m (double x)
+{
+  return (int) x + 2;
+}
+
+int
+ns::nf (double x)
+{
+  return (int) x;
+}
+
+extern "C" int
+lib_entry (int x)
+{
+  A a;
+
+  return func (1.5) + a.m (2.5) + ns::nf (3.5) + x;
+}
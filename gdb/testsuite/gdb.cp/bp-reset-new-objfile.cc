@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include "bp-reset-new-objfile.h"
+
+int
+func (int x)
+{
+  return x;
+}
+
+int
+A::m (int x)
+{
+  return x + 1;
+}
+
+int
+ns::nf (int x)
+{
+  return x;
+}
+
+int
+main ()
+{
+  void *handle;
+  int (*entry) (int);
+  A a;
+
+  handle = dlopen (SHLIB_NAME, RTLD_LAZY);
+  if (handle == NULL)
+    return 1;
+
+  entry = (int (*) (int)) dlsym (handle, "lib_entry");	/* After dlopen.  */
+  return func (1) + a.m (1) + ns::nf (1) + entry (3);
+}
@@ -0,0 +1,35 @@
+# Copyright (C) 2020 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class DwarfRead (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, file_name, count):
+        super (DwarfRead, self).__init__ ("dwarf-read")
+        self.file_name = file_name
+        self.count = count
+
+    def _read(self):
+        """Read the partial symbols of the file, then discard them."""
+        gdb.execute("file %s" % self.file_name)
+        gdb.execute("file")
+
+    def warm_up(self):
+        # Bring the file into the page cache.
+        self._read()
+
+    def execute_test(self):
+        for i in range(self.count):
+            self.measure.measure(self._read, i)
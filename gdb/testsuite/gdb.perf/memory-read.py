@@ -0,0 +1,63 @@
+# Copyright (C) 2020 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import time
+
+from perftest import perftest
+from perftest import measure
+from perftest import testresult
+
+class MeasurementBandwidth (measure.Measurement):
+    """Measurement on memory read bandwidth, in bytes per second."""
+
+    def __init__(self, result, size):
+        super (MeasurementBandwidth, self).__init__ ("bandwidth", result)
+        self.size = size
+        self.start_time = 0
+
+    def start(self, id):
+        self.start_time = time.time()
+
+    def stop(self, id):
+        wall_time = time.time() - self.start_time
+        if wall_time > 0:
+            self.result.record (id, self.size / wall_time)
+        else:
+            self.result.record (id, 0)
+
+class MemoryRead (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, size):
+        super (MemoryRead, self).__init__ ("memory-read")
+        self.size = size
+        result_factory = testresult.SingleStatisticResultFactory()
+        self.measure.measurements.append(
+            MeasurementBandwidth(result_factory.create_result(), size))
+        self.addr = int(gdb.parse_and_eval("&buf[0]"))
+
+    def warm_up(self):
+        self._read(4096)
+
+    def _read(self, block_size):
+        """Read the whole buffer, BLOCK_SIZE bytes at a time."""
+        inferior = gdb.selected_inferior()
+        for offset in range(0, self.size, block_size):
+            inferior.read_memory(self.addr + offset, block_size)
+
+    def execute_test(self):
+        block_size = 8
+        while block_size <= self.size:
+            func = lambda: self._read(block_size)
+            self.measure.measure(func, block_size)
+            block_size *= 8
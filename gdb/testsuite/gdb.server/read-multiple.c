@@ -0,0 +1,37 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2020 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* A local array, read through the stack cache, that spans many cache
+   lines.  */
+
+static int
+func (void)
+{
+  volatile unsigned char buf[1024];
+  int i;
+
+  for (i = 0; i < sizeof (buf); i++)
+    buf[i] = i * 7 + i / 256;
+
+  return buf[0]; /* break here */
+}
+
+int
+main (void)
+{
+  return func ();
+}
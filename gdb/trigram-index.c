@@ -0,0 +1,356 @@
+/* Trigram index of names for GDB, the GNU debugger.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "trigram-index.h"
+#include "safe-ctype.h"
+#include "gdbsupport/selftest.h"
+
+#include <algorithm>
+
+/* Return true if C may be part of the string returned by
+   regex_required_literal: it matches itself in a basic regular
+   expression, and it is an ASCII character.  */
+
+static bool
+literal_char_p (char c)
+{
+  return (ISALNUM (c)
+	  || (c != '\0' && strchr ("_:~<>,=- !%&/#@;'\"`", c) != NULL));
+}
+
+/* See trigram-index.h.  */
+
+std::string
+regex_required_literal (const char *regexp)
+{
+  std::string best, run;
+
+  /* The depth of \( \) groups.  A group may be optional as a whole, so
+     nothing in it is known to be required.  */
+  int depth = 0;
+
+  auto end_run = [&] ()
+    {
+      if (run.size () > best.size ())
+	best = run;
+      run.clear ();
+    };
+
+  /* A quantifier makes the atom before it, here the last character of
+     the current run, optional.  */
+  auto quantifier = [&] ()
+    {
+      if (!run.empty ())
+	run.pop_back ();
+      end_run ();
+    };
+
+  for (const char *p = regexp; *p != '\0'; ++p)
+    {
+      if (*p == '\\')
+	{
+	  ++p;
+	  switch (*p)
+	    {
+	    case '\0':
+	      end_run ();
+	      return best;
+
+	    case '|':
+	      /* With an alternation, nothing may be required.  */
+	      return {};
+
+	    case '(':
+	      end_run ();
+	      ++depth;
+	      break;
+
+	    case ')':
+	      end_run ();
+	      if (depth > 0)
+		--depth;
+	      break;
+
+	    case '{':
+	      quantifier ();
+	      /* Skip the bounds.  */
+	      while (p[1] != '\0' && !(p[1] == '\\' && p[2] == '}'))
+		++p;
+	      if (p[1] != '\0')
+		p += 2;
+	      break;
+
+	    case '?':
+	    case '+':
+	      quantifier ();
+	      break;
+
+	    default:
+	      /* An escaped character, a back-reference or a GNU
+		 operator.  */
+	      end_run ();
+	      break;
+	    }
+	  continue;
+	}
+
+      switch (*p)
+	{
+	case '[':
+	  end_run ();
+	  ++p;
+	  if (*p == '^')
+	    ++p;
+	  if (*p == ']')
+	    ++p;
+	  while (*p != '\0' && *p != ']')
+	    {
+	      /* Skip character classes, equivalence classes and
+		 collating symbols, which may contain a ']'.  */
+	      if (p[0] == '[' && (p[1] == ':' || p[1] == '=' || p[1] == '.'))
+		{
+		  const char *close = strchr (p + 2, p[1]);
+
+		  while (close != NULL && close[1] != ']')
+		    close = strchr (close + 1, p[1]);
+		  if (close == NULL)
+		    return best;
+		  p = close + 1;
+		}
+	      ++p;
+	    }
+	  if (*p == '\0')
+	    return best;
+	  break;
+
+	case '*':
+	  quantifier ();
+	  break;
+
+	case '|':
+	  /* This is an ordinary character in a basic regular expression,
+	     but be safe.  */
+	  return {};
+
+	case '?':
+	case '+':
+	case '{':
+	  /* These are ordinary characters in a basic regular expression,
+	     but be safe.  */
+	  quantifier ();
+	  break;
+
+	default:
+	  if (depth == 0 && literal_char_p (*p))
+	    run += *p;
+	  else
+	    end_run ();
+	  break;
+	}
+    }
+
+  end_run ();
+  return best;
+}
+
+/* See trigram-index.h.  */
+
+bool
+name_contains_literal (const char *name, const std::string &literal,
+		       bool icase)
+{
+  if (!icase)
+    return strstr (name, literal.c_str ()) != NULL;
+
+  size_t len = literal.size ();
+  for (; *name != '\0'; ++name)
+    {
+      size_t i;
+
+      for (i = 0; i < len; ++i)
+	if (name[i] == '\0' || TOLOWER (name[i]) != TOLOWER (literal[i]))
+	  break;
+      if (i == len)
+	return true;
+    }
+
+  return len == 0;
+}
+
+/* Return the key of the trigram at P, ignoring case.  */
+
+static unsigned int
+trigram_key (const char *p)
+{
+  return ((TOLOWER ((unsigned char) p[0]) << 16)
+	  | (TOLOWER ((unsigned char) p[1]) << 8)
+	  | TOLOWER ((unsigned char) p[2]));
+}
+
+/* See trigram-index.h.  */
+
+void
+trigram_index::add (unsigned int id, const char *name)
+{
+  size_t len = strlen (name);
+
+  for (size_t i = 0; i + 3 <= len; ++i)
+    {
+      std::vector<unsigned int> &ids = m_postings[trigram_key (name + i)];
+
+      if (ids.empty () || ids.back () != id)
+	{
+	  gdb_assert (ids.empty () || ids.back () < id);
+	  ids.push_back (id);
+	}
+    }
+}
+
+/* See trigram-index.h.  */
+
+void
+trigram_index::finish ()
+{
+  for (auto &entry : m_postings)
+    entry.second.shrink_to_fit ();
+}
+
+/* See trigram-index.h.  */
+
+std::vector<unsigned int>
+trigram_index::candidates (const std::string &literal) const
+{
+  gdb_assert (literal.size () >= 3);
+
+  std::vector<const std::vector<unsigned int> *> lists;
+  for (size_t i = 0; i + 3 <= literal.size (); ++i)
+    {
+      auto it = m_postings.find (trigram_key (literal.c_str () + i));
+
+      if (it == m_postings.end ())
+	return {};
+      lists.push_back (&it->second);
+    }
+
+  /* Intersect the shortest lists first, to keep the intermediate
+     results small.  */
+  std::sort (lists.begin (), lists.end (),
+	     [] (const std::vector<unsigned int> *a,
+		 const std::vector<unsigned int> *b)
+	     {
+	       return a->size () < b->size ();
+	     });
+
+  std::vector<unsigned int> result = *lists[0];
+  for (size_t i = 1; i < lists.size () && !result.empty (); ++i)
+    {
+      std::vector<unsigned int> next;
+
+      std::set_intersection (result.begin (), result.end (),
+			     lists[i]->begin (), lists[i]->end (),
+			     std::back_inserter (next));
+      result = std::move (next);
+    }
+
+  return result;
+}
+
+/* See trigram-index.h.  */
+
+size_t
+trigram_index::memory_used () const
+{
+  size_t size = m_postings.bucket_count () * sizeof (void *);
+
+  for (const auto &entry : m_postings)
+    size += (sizeof (entry) + sizeof (void *)
+	     + entry.second.capacity () * sizeof (unsigned int));
+  return size;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+static void
+test_regex_required_literal ()
+{
+#define CHECK(REGEXP, EXPECTED) \
+  SELF_CHECK (regex_required_literal (REGEXP) == EXPECTED)
+
+  CHECK ("foo_bar", "foo_bar");
+  CHECK ("^foo.*bar$", "foo");
+  CHECK ("^fo.*bar$", "bar");
+  CHECK ("ab*cdef", "cdef");
+  CHECK ("abcde*f", "abcd");
+  CHECK ("[abc]def", "def");
+  CHECK ("[]abcdefg]x", "x");
+  CHECK ("[[:alpha:]]xy", "xy");
+  CHECK ("a\\{2,3\\}bcd", "bcd");
+  CHECK ("\\(longname\\)*x", "x");
+  CHECK ("\\(a\\)\\1longer", "longer");
+  CHECK ("foo\\|barbaz", "");
+  CHECK ("operator||", "");
+  CHECK ("ns::func\\.x", "ns::func");
+  CHECK ("", "");
+
+#undef CHECK
+}
+
+static void
+test_trigram_index ()
+{
+  trigram_index index;
+
+  index.add (0, "foo_bar");
+  index.add (1, "FOO_BAZ");
+  index.add (2, "qux");
+  index.add (3, "xfoo_barx");
+  index.finish ();
+
+  SELF_CHECK ((index.candidates ("foo_ba")
+	       == std::vector<unsigned int> { 0, 1, 3 }));
+  SELF_CHECK ((index.candidates ("o_bar")
+	       == std::vector<unsigned int> { 0, 3 }));
+  SELF_CHECK ((index.candidates ("QUX")
+	       == std::vector<unsigned int> { 2 }));
+  SELF_CHECK (index.candidates ("zzz").empty ());
+
+  SELF_CHECK (name_contains_literal ("xfoo_barx", "foo_bar", false));
+  SELF_CHECK (!name_contains_literal ("FOO_BAR", "foo_bar", false));
+  SELF_CHECK (name_contains_literal ("FOO_BAR", "foo_bar", true));
+  SELF_CHECK (!name_contains_literal ("foo_ba", "foo_bar", true));
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void _initialize_trigram_index ();
+void
+_initialize_trigram_index ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("regex_required_literal",
+			    selftests::test_regex_required_literal);
+  selftests::register_test ("trigram_index",
+			    selftests::test_trigram_index);
+#endif
+}
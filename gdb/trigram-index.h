@@ -0,0 +1,77 @@
+/* Trigram index of names for GDB, the GNU debugger.
+
+   Copyright (C) 2020 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Return the longest string that every string matched by the POSIX
+   basic regular expression REGEXP must contain, or the empty string if
+   there is none that can be found easily.  This errs on the side of
+   returning a shorter string, or none at all: the result is only used
+   to discard names the regular expression cannot match before running
+   it.  The result only contains ASCII characters whose case folding
+   does not depend on the locale.  */
+
+extern std::string regex_required_literal (const char *regexp);
+
+/* Return true if NAME contains LITERAL.  If ICASE is true, ASCII
+   letters are compared case-insensitively.  */
+
+extern bool name_contains_literal (const char *name,
+				   const std::string &literal, bool icase);
+
+/* An index of the three-character substrings (trigrams) of a set of
+   names, used to find the names that may contain a given string
+   without looking at every name.  Trigrams are indexed without regard
+   to case.  */
+
+class trigram_index
+{
+public:
+  trigram_index () = default;
+
+  DISABLE_COPY_AND_ASSIGN (trigram_index);
+
+  /* Add NAME to the index, identified by ID.  IDs must be added in
+     increasing order.  */
+  void add (unsigned int id, const char *name);
+
+  /* Release the memory reserved for adding more names.  Call this once
+     all the names were added.  */
+  void finish ();
+
+  /* Return the sorted IDs of the names that may contain LITERAL.  The
+     caller must still check each of them.  LITERAL must be at least
+     three characters long.  */
+  std::vector<unsigned int> candidates (const std::string &literal) const;
+
+  /* Return the approximate number of bytes used by the index.  */
+  size_t memory_used () const;
+
+private:
+  /* Map from each trigram to the sorted IDs of the names containing
+     it.  */
+  std::unordered_map<unsigned int, std::vector<unsigned int>> m_postings;
+};
+
+#endif /* TRIGRAM_INDEX_H */
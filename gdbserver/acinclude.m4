@@ -39,6 +39,9 @@ m4_include([../config/ax_pthread.m4])
 dnl For ZW_GNU_GETTEXT_SISTER_DIR.
 m4_include(../config/gettext-sister.m4)
 
+dnl For AM_ZLIB.
+m4_include(../config/zlib.m4)
+
 dnl Check for existence of a type $1 in libthread_db.h
 dnl Based on BFD_HAVE_SYS_PROCFS_TYPE in bfd/bfd.m4.
 
@@ -30,6 +30,7 @@
 #include "nat/linux-ptrace.h"
 #include "nat/linux-procfs.h"
 #include "nat/linux-personality.h"
+#include "nat/linux-memory.h"
 #include <signal.h>
 #include <sys/ioctl.h>
 #include <fcntl.h>
@@ -386,6 +387,9 @@ linux_process_target::delete_lwp (lwp_info *lwp)
   if (debug_threads)
     debug_printf ("deleting %ld\n", lwpid_of (thr));
 
+  /* Don't keep reading memory through the files of gone threads.  */
+  linux_proc_mem_lwp_exited (ptid_of (thr));
+
   remove_thread (thr);
 
   low_delete_thread (lwp->arch_private);
@@ -1609,6 +1613,9 @@ linux_process_target::mourn (process_info *process)
       delete_lwp (get_thread_lwp (thread));
     });
 
+  /* Don't keep the /proc/LWP/mem file of a thread of PROCESS open.  */
+  linux_proc_mem_close (process->pid);
+
   /* Freeing all private data.  */
   priv = process->priv;
   low_delete_process (priv->arch_private);
@@ -5526,49 +5533,24 @@ linux_process_target::read_memory (CORE_ADDR memaddr,
   PTRACE_XFER_TYPE *buffer;
   CORE_ADDR addr;
   int count;
-  char filename[64];
   int i;
   int ret;
-  int fd;
-
-  /* Try using /proc.  Don't bother for one word.  */
-  if (len >= 3 * sizeof (long))
-    {
-      int bytes;
 
-      /* We could keep this file open and cache it - possibly one per
-	 thread.  That requires some juggling, but is even faster.  */
-      sprintf (filename, "/proc/%d/mem", pid);
-      fd = open (filename, O_RDONLY | O_LARGEFILE);
-      if (fd == -1)
-	goto no_proc;
-
-      /* If pread64 is available, use it.  It's faster if the kernel
-	 supports it (only one syscall), and it's 64-bit safe even on
-	 32-bit platforms (for instance, SPARC debugging a SPARC64
-	 application).  */
-#ifdef HAVE_PREAD64
-      bytes = pread64 (fd, myaddr, len, memaddr);
-#else
-      bytes = -1;
-      if (lseek (fd, memaddr, SEEK_SET) != -1)
-	bytes = read (fd, myaddr, len);
-#endif
+  if (len == 0)
+    return 0;
 
-      close (fd);
-      if (bytes == len)
-	return 0;
+  /* Try process_vm_readv and /proc, which take a single system call
+     for the whole block.  */
+  int bytes = linux_proc_read_memory (ptid_of (current_thread), memaddr,
+				      myaddr, len);
+  if (bytes == len)
+    return 0;
 
-      /* Some data was read, we'll try to get the rest with ptrace.  */
-      if (bytes > 0)
-	{
-	  memaddr += bytes;
-	  myaddr += bytes;
-	  len -= bytes;
-	}
-    }
+  /* Some data was read, we'll try to get the rest with ptrace.  */
+  memaddr += bytes;
+  myaddr += bytes;
+  len -= bytes;
 
- no_proc:
   /* Round starting address down to longword boundary.  */
   addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
   /* Round ending address up; get number of longwords that makes.  */
@@ -5613,16 +5595,6 @@ linux_process_target::write_memory (CORE_ADDR memaddr,
 				    const unsigned char *myaddr, int len)
 {
   int i;
-  /* Round starting address down to longword boundary.  */
-  CORE_ADDR addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
-  /* Round ending address up; get number of longwords that makes.  */
-  int count
-    = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1)
-    / sizeof (PTRACE_XFER_TYPE);
-
-  /* Allocate buffer of that many longwords.  */
-  PTRACE_XFER_TYPE *buffer = XALLOCAVEC (PTRACE_XFER_TYPE, count);
-
   int pid = lwpid_of (current_thread);
 
   if (len == 0)
@@ -5649,6 +5621,28 @@ linux_process_target::write_memory (CORE_ADDR memaddr,
 		    str, (long) memaddr, pid);
     }
 
+  /* Try process_vm_writev and /proc, which take a single system call
+     for the whole block.  */
+  size_t written = linux_proc_write_memory (ptid_of (current_thread),
+					    memaddr, myaddr, len);
+  if (written == (size_t) len)
+    return 0;
+
+  /* Some data was written, we'll try to write the rest with ptrace.  */
+  memaddr += written;
+  myaddr += written;
+  len -= written;
+
+  /* Round starting address down to longword boundary.  */
+  CORE_ADDR addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
+  /* Round ending address up; get number of longwords that makes.  */
+  int count
+    = (((memaddr + len) - addr) + sizeof (PTRACE_XFER_TYPE) - 1)
+    / sizeof (PTRACE_XFER_TYPE);
+
+  /* Allocate buffer of that many longwords.  */
+  PTRACE_XFER_TYPE *buffer = XALLOCAVEC (PTRACE_XFER_TYPE, count);
+
   /* Fill start and end extra bytes of buffer with existing memory data.  */
 
   errno = 0;
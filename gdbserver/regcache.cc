@@ -229,6 +229,70 @@ registers_to_string (struct regcache *regcache, char *buf)
   *buf = '\0';
 }
 
+/* See regcache.h.  */
+
+void
+regcache_record_reported (struct regcache *regcache)
+{
+  const struct target_desc *tdesc = regcache->tdesc;
+
+  regcache->reported_registers.assign (regcache->registers,
+				       regcache->registers
+				       + tdesc->registers_size);
+  regcache->reported_status.assign (regcache->register_status,
+				    regcache->register_status
+				    + tdesc->reg_defs.size ());
+}
+
+/* See regcache.h.  */
+
+bool
+registers_delta_to_string (struct regcache *regcache, char *buf,
+			   int buf_size)
+{
+  const struct target_desc *tdesc = regcache->tdesc;
+  bool have_reported = !regcache->reported_registers.empty ();
+  char *p = buf;
+
+  for (int i = 0; i < tdesc->reg_defs.size (); ++i)
+    {
+      int size = register_size (tdesc, i);
+      int offset = find_register_by_number (tdesc, i).offset / 8;
+      unsigned char status = regcache->register_status[i];
+
+      if (size == 0)
+	continue;
+
+      if (have_reported
+	  && regcache->reported_status[i] == status
+	  && (status != REG_VALID
+	      || memcmp (regcache->reported_registers.data () + offset,
+			 regcache->registers + offset, size) == 0))
+	continue;
+
+      /* The register number, a ':', the value, a ';' and the final
+	 NUL.  */
+      if (buf_size - (p - buf) < 8 + 1 + 2 * size + 1 + 1)
+	return false;
+
+      p += sprintf (p, "%x:", i);
+      if (status == REG_VALID)
+	bin2hex (regcache->registers + offset, p, size);
+      else
+	memset (p, 'x', 2 * size);
+      p += 2 * size;
+      *p++ = ';';
+    }
+
+  if (p == buf)
+    strcpy (buf, "OK");
+  else
+    *p = '\0';
+
+  regcache_record_reported (regcache);
+  return true;
+}
+
 void
 registers_from_string (struct regcache *regcache, char *buf)
 {
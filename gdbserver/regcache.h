@@ -20,6 +20,7 @@
 #define GDBSERVER_REGCACHE_H
 
 #include "gdbsupport/common-regcache.h"
+#include "gdbsupport/byte-vector.h"
 
 struct thread_info;
 struct target_desc;
@@ -44,6 +45,13 @@ struct regcache : public reg_buffer_common
 #ifndef IN_PROCESS_AGENT
   /* One of REG_UNAVAILABLE or REG_VALID.  */
   unsigned char *register_status = nullptr;
+
+  /* The contents and status of the registers as last sent to GDB in
+     reply to a 'g' or vRegDelta packet.  A vRegDelta reply only holds
+     the registers that changed since.  Empty if the registers were
+     never sent.  */
+  gdb::byte_vector reported_registers;
+  gdb::byte_vector reported_status;
 #endif
 
   /* See gdbsupport/common-regcache.h.  */
@@ -98,6 +106,21 @@ void regcache_release (void);
 
 void registers_to_string (struct regcache *regcache, char *buf);
 
+/* Record the registers of REGCACHE as sent to GDB, for
+   registers_delta_to_string.  */
+
+void regcache_record_reported (struct regcache *regcache);
+
+/* Write the registers of REGCACHE whose contents or status changed
+   since they were last recorded as sent to GDB, or all of them if
+   they never were, to BUF as "N:VALUE;" entries, and record them as
+   sent.  VALUE is in hex, or all 'x's for an unavailable register.
+   Write "OK" if no register changed.  Return false, recording
+   nothing, if the entries don't fit in the BUF_SIZE bytes of BUF.  */
+
+bool registers_delta_to_string (struct regcache *regcache, char *buf,
+				int buf_size);
+
 /* Convert a string to register values and fill our register cache.  */
 
 void registers_from_string (struct regcache *regcache, char *buf);
@@ -1221,6 +1221,25 @@ prepare_resume_reply (char *buf, ptid_t ptid,
 	    buf = outreg (regcache, find_regno (regcache->tdesc, *regp), buf);
 	    regp ++;
 	  }
+
+	/* Then the registers GDB asked for, as long as they are
+	   available, keeping the reply well within a packet.  */
+	int budget = PBUFSIZ / 2;
+	for (int regno : cs.extra_expedite_regs)
+	  {
+	    if (regno >= regcache->tdesc->reg_defs.size ()
+		|| regcache->register_status[regno] != REG_VALID)
+	      continue;
+
+	    /* The register number, a ':', the value and a ';'.  */
+	    int size = register_size (regcache->tdesc, regno);
+	    int len = 4 + 1 + 2 * size + 1;
+	    if (size == 0 || len > budget)
+	      continue;
+
+	    buf = outreg (regcache, regno, buf);
+	    budget -= len;
+	  }
 	*buf = '\0';
 
 	/* Formerly, if the debugger had not used any thread features
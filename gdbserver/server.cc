@@ -48,6 +48,8 @@
 #include "gdbsupport/selftest.h"
 #include "gdbsupport/scope-exit.h"
 #include "gdbsupport/gdb_select.h"
+#include "gdbsupport/byte-vector.h"
+#include <zlib.h>
 #include "gdbsupport/scoped_restore.h"
 
 #define require_running_or_return(BUF)		\
@@ -64,6 +66,17 @@
       break;					\
     }
 
+/* The number of vPipelined requests GDB may send before reading any
+   reply.  */
+#define PIPELINED_REQUESTS_MAX 16
+
+/* The maximum number of hex digits in the tag of a vPipelined
+   request.  */
+#define PIPELINED_TAG_MAX_DIGITS 8
+
+/* The most memory a vReadCompressed request may read at once.  */
+#define READ_COMPRESSED_MAX 0x100000
+
 /* String containing the current directory (what getwd would return).  */
 
 char *current_directory;
@@ -374,10 +387,12 @@ decode_xfer (char *buf, char **object, char **rw, char **annex, char **offset)
 
 /* Write the response to a successful qXfer read.  Returns the
    length of the (binary) data stored in BUF, corresponding
-   to as much of DATA/LEN as we could fit.  IS_MORE controls
-   the first character of the response.  */
+   to as much of DATA/LEN as we could fit, leaving RESERVE bytes of
+   the packet buffer unused.  IS_MORE controls the first character of
+   the response.  */
 static int
-write_qxfer_response (char *buf, const gdb_byte *data, int len, int is_more)
+write_qxfer_response (char *buf, const gdb_byte *data, int len, int is_more,
+		      int reserve)
 {
   int out_len;
 
@@ -387,7 +402,7 @@ write_qxfer_response (char *buf, const gdb_byte *data, int len, int is_more)
     buf[0] = 'l';
 
   return remote_escape_output (data, len, 1, (unsigned char *) buf + 1,
-			       &out_len, PBUFSIZ - 2) + 1;
+			       &out_len, PBUFSIZ - 2 - reserve) + 1;
 }
 
 /* Handle btrace enabling in BTS format.  */
@@ -577,6 +592,32 @@ handle_general_set (char *own_buf)
       return;
     }
 
+  if (startswith (own_buf, "QExpediteRegisters:"))
+    {
+      const char *p = own_buf + strlen ("QExpediteRegisters:");
+      std::vector<int> regs;
+
+      while (*p != '\0')
+	{
+	  const char *start = p;
+	  ULONGEST regno;
+
+	  p = unpack_varlen_hex (p, &regno);
+	  if (p == start || regno > INT_MAX || (*p != ';' && *p != '\0'))
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+	  regs.push_back (regno);
+	  if (*p == ';')
+	    p++;
+	}
+
+      cs.extra_expedite_regs = std::move (regs);
+      write_ok (own_buf);
+      return;
+    }
+
   if (startswith (own_buf, "QProgramSignals:"))
     {
       int numsigs = (int) GDB_SIGNAL_LAST, i;
@@ -2017,8 +2058,12 @@ static const struct qxfer qxfer_packets[] =
     { "traceframe-info", handle_qxfer_traceframe_info },
   };
 
+/* Handle a qXfer packet, leaving RESERVE bytes of the packet buffer
+   unused by the reply.  Return 0 if the packet is not handled.  */
+
 static int
-handle_qxfer (char *own_buf, int packet_len, int *new_packet_len_p)
+handle_qxfer (char *own_buf, int packet_len, int *new_packet_len_p,
+	      int reserve)
 {
   int i;
   char *object;
@@ -2060,8 +2105,8 @@ handle_qxfer (char *own_buf, int packet_len, int *new_packet_len_p)
 
 	      /* Read one extra byte, as an indicator of whether there is
 		 more.  */
-	      if (len > PBUFSIZ - 2)
-		len = PBUFSIZ - 2;
+	      if (len > PBUFSIZ - 2 - reserve)
+		len = PBUFSIZ - 2 - reserve;
 	      data = (unsigned char *) malloc (len + 1);
 	      if (data == NULL)
 		{
@@ -2081,9 +2126,11 @@ handle_qxfer (char *own_buf, int packet_len, int *new_packet_len_p)
 	      else if (n < 0)
 		write_enn (own_buf);
 	      else if (n > len)
-		*new_packet_len_p = write_qxfer_response (own_buf, data, len, 1);
+		*new_packet_len_p = write_qxfer_response (own_buf, data, len, 1,
+							  reserve);
 	      else
-		*new_packet_len_p = write_qxfer_response (own_buf, data, n, 0);
+		*new_packet_len_p = write_qxfer_response (own_buf, data, n, 0,
+							  reserve);
 
 	      free (data);
 	      return 1;
@@ -2493,6 +2540,21 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      strcat (own_buf, ";binary-upload+");
+
+      sprintf (own_buf + strlen (own_buf), ";PipelinedRequests=%x",
+	       PIPELINED_REQUESTS_MAX);
+
+      sprintf (own_buf + strlen (own_buf), ";ReadCompressed=%x",
+	       READ_COMPRESSED_MAX);
+
+      strcat (own_buf, ";ReadMultiple+");
+
+      strcat (own_buf, ";QExpediteRegisters+;RegisterDelta+");
+
+      /* A new GDB has not asked for any register yet.  */
+      cs.extra_expedite_regs.clear ();
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -2679,7 +2741,7 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
-  if (handle_qxfer (own_buf, packet_len, new_packet_len_p))
+  if (handle_qxfer (own_buf, packet_len, new_packet_len_p, 0))
     return;
 
   if (target_supports_tracepoints () && handle_tracepoint_query (own_buf))
@@ -3111,6 +3173,242 @@ handle_v_kill (char *own_buf)
     }
 }
 
+/* Handle an 'm' or 'x' packet, leaving RESERVE bytes of the packet
+   buffer unused by the reply.  The length of a binary reply is stored
+   in *NEW_PACKET_LEN.  */
+
+static void
+handle_read_memory (char *own_buf, int reserve, int *new_packet_len)
+{
+  CORE_ADDR mem_addr;
+  unsigned int len;
+  int res, out_len;
+  bool binary = own_buf[0] == 'x';
+
+  if (!target_running ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  decode_m_packet (&own_buf[1], &mem_addr, &len);
+
+  /* Each byte takes two hex characters in an 'm' reply, and at least
+     one byte in an 'x' reply.  Reading less than requested is fine;
+     GDB will ask for the rest.  */
+  if (binary && len > PBUFSIZ - 1 - reserve)
+    len = PBUFSIZ - 1 - reserve;
+  else if (!binary && len > (PBUFSIZ - reserve) / 2)
+    len = (PBUFSIZ - reserve) / 2;
+
+  res = gdb_read_memory (mem_addr, mem_buf, len);
+  if (res < 0)
+    write_enn (own_buf);
+  else if (binary)
+    {
+      own_buf[0] = 'b';
+      *new_packet_len = remote_escape_output (mem_buf, res, 1,
+					      (gdb_byte *) own_buf + 1,
+					      &out_len,
+					      PBUFSIZ - 1 - reserve) + 1;
+    }
+  else
+    bin2hex (mem_buf, own_buf, res);
+}
+
+/* Handle a "vReadCompressed:ADDR,LENGTH" packet, leaving RESERVE bytes
+   of the packet buffer unused by the reply.  Reply with 'z', the
+   number of bytes read in hex, a ';', and the bytes compressed with
+   zlib; or if they do not compress, with 'b' and as many of the bytes
+   as fit, like an 'x' packet.  The length of the reply is stored in
+   *NEW_PACKET_LEN.  */
+
+static void
+handle_read_compressed (char *own_buf, int reserve, int *new_packet_len)
+{
+  ULONGEST mem_addr, len;
+  const char *p;
+  int res, out_len, avail = PBUFSIZ - reserve;
+
+  if (!target_running ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  /* Unlike for 'm' packets, the length may have more than four
+     digits.  */
+  p = unpack_varlen_hex (own_buf + strlen ("vReadCompressed:"), &mem_addr);
+  if (*p != ',')
+    {
+      write_enn (own_buf);
+      return;
+    }
+  unpack_varlen_hex (p + 1, &len);
+  if (len > READ_COMPRESSED_MAX)
+    len = READ_COMPRESSED_MAX;
+
+  gdb::byte_vector data (len);
+  res = gdb_read_memory (mem_addr, data.data (), len);
+  if (res < 0)
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  /* Compress as much of the data as fits in the packet once compressed
+     and escaped.  If not all of it does, try again with about as much
+     as did, until the data no longer compresses.  */
+  gdb::byte_vector zdata (compressBound (res));
+  ULONGEST n = res;
+  while (n > 0)
+    {
+      uLongf zlen = zdata.size ();
+      int hdr_len, out_bytes;
+
+      if (compress2 (zdata.data (), &zlen, data.data (), n,
+		     Z_BEST_SPEED) != Z_OK
+	  || zlen >= n)
+	break;
+
+      hdr_len = sprintf (own_buf, "z%x;", (unsigned int) n);
+      out_bytes = remote_escape_output (zdata.data (), zlen, 1,
+					(gdb_byte *) own_buf + hdr_len,
+					&out_len, avail - hdr_len);
+      if (out_len == zlen)
+	{
+	  *new_packet_len = hdr_len + out_bytes;
+	  return;
+	}
+
+      n = n * out_len / zlen * 7 / 8;
+    }
+
+  own_buf[0] = 'b';
+  *new_packet_len = remote_escape_output (data.data (), res, 1,
+					  (gdb_byte *) own_buf + 1,
+					  &out_len, avail - 1) + 1;
+}
+
+/* Handle a "vReadMultiple:ADDR,LENGTH;ADDR,LENGTH..." packet.  Reply
+   with the contents of each block in hex, each followed by a ';'.
+   Blocks that can't be read, or that don't fit in the reply, are cut
+   short or left empty; GDB reads them again on their own.  */
+
+static void
+handle_read_multiple (char *own_buf)
+{
+  std::vector<std::pair<CORE_ADDR, ULONGEST>> blocks;
+  const char *p = own_buf + strlen ("vReadMultiple:");
+
+  while (*p != '\0')
+    {
+      ULONGEST addr, len;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p != ',')
+	break;
+      p = unpack_varlen_hex (p + 1, &len);
+      blocks.emplace_back (addr, len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	break;
+    }
+
+  if (*p != '\0' || blocks.empty () || !target_running ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  /* Leave room for the ';' of each block still to come.  */
+  char *out = own_buf;
+  int avail = PBUFSIZ - 1 - blocks.size ();
+  for (const auto &block : blocks)
+    {
+      int len = std::min (block.second, (ULONGEST) avail / 2);
+      int res = 0;
+
+      if (len > 0)
+	res = gdb_read_memory (block.first, mem_buf, len);
+      if (res > 0)
+	{
+	  bin2hex (mem_buf, out, res);
+	  out += 2 * res;
+	  avail -= 2 * res;
+	}
+      *out++ = ';';
+    }
+  *out = '\0';
+}
+
+/* Handle a "vRegDelta" packet.  Reply with the registers of the
+   general thread that changed since they were last sent to GDB.  */
+
+static void
+handle_reg_delta (char *own_buf)
+{
+  client_state &cs = get_client_state ();
+
+  if (!target_running () || cs.current_traceframe >= 0
+      || !set_desired_thread ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  struct regcache *regcache = get_thread_regcache (current_thread, 1);
+
+  if (!registers_delta_to_string (regcache, own_buf, PBUFSIZ))
+    write_enn (own_buf);
+}
+
+/* Handle a "vPipelined;TAG;REQUEST" packet.  Process REQUEST, and
+   reply with TAG, a ';', and the reply to REQUEST.  GDB may send
+   several of these before reading any reply, and uses the tag to
+   match each reply with its request.  */
+
+static void
+handle_v_pipelined (char *own_buf, int packet_len, int *new_packet_len)
+{
+  char *tag = own_buf + strlen ("vPipelined;");
+  char *request = strchr (tag, ';');
+  char *reply;
+  int tag_len, request_len, reply_len = -1;
+
+  if (request == NULL || request == tag
+      || request - tag > PIPELINED_TAG_MAX_DIGITS)
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  /* Keep the tag and its ';' at the start of the buffer, and move the
+     wrapped request after them, where its reply goes.  */
+  request++;
+  tag_len = request - tag;
+  request_len = packet_len - (request - own_buf);
+  memmove (own_buf, tag, tag_len);
+  reply = own_buf + tag_len;
+  memmove (reply, request, request_len);
+  reply[request_len] = '\0';
+
+  /* Only memory reads and qXfer transfers may be pipelined.  Reply to
+     anything else as if it was not understood.  */
+  if (reply[0] == 'm' || reply[0] == 'x')
+    handle_read_memory (reply, tag_len, &reply_len);
+  else if (startswith (reply, "vReadCompressed:"))
+    handle_read_compressed (reply, tag_len, &reply_len);
+  else if (!startswith (reply, "qXfer:")
+	   || !handle_qxfer (reply, request_len, &reply_len, tag_len))
+    reply[0] = '\0';
+
+  if (reply_len == -1)
+    reply_len = strlen (reply);
+  *new_packet_len = tag_len + reply_len;
+}
+
 /* Handle all of the extended 'v' packets.  */
 void
 handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
@@ -3197,6 +3495,30 @@ handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
       return;
     }
 
+  if (startswith (own_buf, "vReadCompressed:"))
+    {
+      handle_read_compressed (own_buf, 0, new_packet_len);
+      return;
+    }
+
+  if (startswith (own_buf, "vReadMultiple:"))
+    {
+      handle_read_multiple (own_buf);
+      return;
+    }
+
+  if (strcmp (own_buf, "vRegDelta") == 0)
+    {
+      handle_reg_delta (own_buf);
+      return;
+    }
+
+  if (startswith (own_buf, "vPipelined;"))
+    {
+      handle_v_pipelined (own_buf, packet_len, new_packet_len);
+      return;
+    }
+
   if (handle_notif_ack (own_buf, packet_len))
     return;
 
@@ -4192,6 +4514,7 @@ process_serial_event (void)
 	    {
 	      regcache = get_thread_regcache (current_thread, 1);
 	      registers_to_string (regcache, cs.own_buf);
+	      regcache_record_reported (regcache);
 	    }
 	}
       break;
@@ -4214,15 +4537,8 @@ process_serial_event (void)
 	}
       break;
     case 'm':
-      {
-	require_running_or_break (cs.own_buf);
-	decode_m_packet (&cs.own_buf[1], &mem_addr, &len);
-	int res = gdb_read_memory (mem_addr, mem_buf, len);
-	if (res < 0)
-	  write_enn (cs.own_buf);
-	else
-	  bin2hex (mem_buf, cs.own_buf, res);
-      }
+    case 'x':
+      handle_read_memory (cs.own_buf, 0, &new_packet_len);
       break;
     case 'M':
       require_running_or_break (cs.own_buf);
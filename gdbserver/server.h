@@ -190,6 +190,10 @@ struct client_state
 
   int current_traceframe = -1;
 
+  /* The numbers of the registers GDB asked to have in stop replies
+     with a QExpediteRegisters packet, besides the expedite_regs of the
+     target description.  */
+  std::vector<int> extra_expedite_regs;
 };
 
 client_state &get_client_state ();
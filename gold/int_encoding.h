@@ -29,6 +29,7 @@
 #include "elfcpp.h"
 #include "target.h"
 #include "parameters.h"
+#include "leb128.h"
 
 namespace gold
 {
@@ -51,7 +52,7 @@ read_unsigned_LEB_128(const unsigned char* buffer, size_t* plen)
 {
   unsigned char byte = *buffer++;
 
-  if ((byte & 0x80) != 0)
+  if (!leb128_single_byte_p(byte))
     return read_unsigned_LEB_128_x(buffer, plen, byte);
 
   *plen = 1;
@@ -72,13 +73,11 @@ read_signed_LEB_128(const unsigned char* buffer, size_t* plen)
 {
   unsigned char byte = *buffer++;
 
-  if ((byte & 0x80) != 0)
+  if (!leb128_single_byte_p(byte))
     return read_signed_LEB_128_x(buffer, plen, byte);
 
   *plen = 1;
-  if (byte & 0x40)
-    return -(static_cast<int64_t>(1) << 7) | static_cast<int64_t>(byte);
-  return static_cast<int64_t>(byte);
+  return static_cast<int64_t>(sleb128_single_byte_value(byte));
 }
 
 // Write a ULEB 128 encoded VALUE to BUFFER.
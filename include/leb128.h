@@ -42,6 +42,30 @@ Boston, MA 02110-1301, USA.  */
 #include <inttypes.h>
 #endif
 
+/* Most LEB128 values in object files (DWARF abbreviation codes,
+   attribute names and forms, small constants) fit in a single byte.
+   The decoders in this file, and the ones in BFD, binutils, gold and
+   GDB that have their own calling conventions, test for that case first
+   with these two functions.  */
+
+/* Return nonzero if BYTE, the first byte of a LEB128 value, is the
+   whole value.  */
+
+static inline int
+leb128_single_byte_p (unsigned char byte)
+{
+  return (byte & 0x80) == 0;
+}
+
+/* Return the value of the single-byte signed LEB128 constant BYTE.  The
+   value of a single-byte unsigned LEB128 constant is BYTE itself.  */
+
+static inline int
+sleb128_single_byte_value (unsigned char byte)
+{
+  return (byte & 0x40) != 0 ? (int) byte - 0x80 : (int) byte;
+}
+
 /* Decode the unsigned LEB128 constant at BUF into the variable pointed to
    by R, and return the number of bytes read.
    If we read off the end of the buffer, zero is returned,
@@ -59,6 +83,12 @@ read_uleb128_to_uint64 (const unsigned char *buf, const unsigned char *buf_end,
   uint64_t result = 0;
   unsigned char byte;
 
+  if (p < buf_end && leb128_single_byte_p (*p))
+    {
+      *r = *p;
+      return 1;
+    }
+
   while (1)
     {
       if (p >= buf_end)
@@ -92,6 +122,12 @@ read_sleb128_to_int64 (const unsigned char *buf, const unsigned char *buf_end,
   int64_t result = 0;
   unsigned char byte;
 
+  if (p < buf_end && leb128_single_byte_p (*p))
+    {
+      *r = sleb128_single_byte_value (*p);
+      return 1;
+    }
+
   while (1)
     {
       if (p >= buf_end)